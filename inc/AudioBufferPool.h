@@ -0,0 +1,129 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef AUDIO_BUFFER_POOL_H
+#define AUDIO_BUFFER_POOL_H
+
+#include "ManagedBuffer.h"
+
+// The maximum number of buffers retained by each AudioBufferPool.
+// Requests beyond this are satisfied from the heap, and released normally.
+#ifndef CONFIG_AUDIO_BUFFER_POOL_SIZE
+#define CONFIG_AUDIO_BUFFER_POOL_SIZE 8
+#endif
+
+namespace codal
+{
+    /**
+     * A recycling pool of fixed size audio buffers.
+     *
+     * Buffers handed out by the pool are ordinary ManagedBuffers. The pool retains its own reference to each,
+     * and a buffer becomes available for reuse as soon as every other reference (e.g. a DMA peripheral at the
+     * end of a DataStream pipeline) has been released. Once the pool has warmed up, a steady state audio
+     * pipeline therefore performs no heap allocation at all.
+     *
+     * Pools are shared by all components that use the same buffer size, see AudioBufferPool::get().
+     */
+    class AudioBufferPool
+    {
+        ManagedBuffer       buffers[CONFIG_AUDIO_BUFFER_POOL_SIZE];     // The buffers owned by this pool.
+        int                 bufferSize;                                 // The size of each buffer, in bytes.
+        int                 allocated;                                  // The number of buffers created so far.
+        int                 highWaterMark;                              // The largest number of buffers in use at once.
+        uint32_t            misses;                                     // The number of requests that fell back to the heap.
+        AudioBufferPool     *next;                                      // The next pool in the list of shared pools.
+
+        static AudioBufferPool *pools;                                  // All shared pools created so far.
+
+        /**
+         * Determine if the given pool buffer is referenced only by the pool.
+         */
+        static bool isFree(ManagedBuffer &b);
+
+        public:
+
+        /**
+         * Constructor.
+         * Creates an empty pool. Buffers are created on demand, up to CONFIG_AUDIO_BUFFER_POOL_SIZE.
+         *
+         * @param bufferSize The size of each buffer in the pool, in bytes.
+         */
+        AudioBufferPool(int bufferSize);
+
+        /**
+         * Retrieve the shared pool for the given buffer size, creating it if necessary.
+         *
+         * @param bufferSize The size of the buffers required, in bytes.
+         * @return The shared pool, or NULL if bufferSize is invalid or memory is exhausted.
+         */
+        static AudioBufferPool* get(int bufferSize);
+
+        /**
+         * Provide a buffer from the pool. The contents of the buffer are undefined, and should be fully overwritten.
+         * If every pooled buffer is in use, a new buffer is allocated from the heap.
+         *
+         * @return A buffer of getBufferSize() bytes.
+         */
+        ManagedBuffer allocate();
+
+        /**
+         * Determine the size of the buffers in this pool.
+         *
+         * @return The size of each buffer, in bytes.
+         */
+        int getBufferSize();
+
+        /**
+         * Determine how many buffers have been created by this pool.
+         *
+         * @return The number of buffers retained by the pool, including those currently in use.
+         */
+        int getAllocated();
+
+        /**
+         * Determine how many pooled buffers are currently in use.
+         *
+         * @return The number of pooled buffers referenced outside of the pool.
+         */
+        int getInUse();
+
+        /**
+         * Determine the largest number of pooled buffers that have been in use at the same time.
+         *
+         * @return The high water mark of the pool.
+         */
+        int getHighWaterMark();
+
+        /**
+         * Determine how many requests could not be satisfied by the pool, and were allocated from the heap.
+         * A non-zero value suggests CONFIG_AUDIO_BUFFER_POOL_SIZE should be increased.
+         *
+         * @return The number of pool misses.
+         */
+        uint32_t getMisses();
+    };
+}
+
+#endif
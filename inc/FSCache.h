@@ -25,6 +25,7 @@ DEALINGS IN THE SOFTWARE.
 #include "CodalCompat.h"
 
 #define FSCACHE_FLAG_PINNED				0x01
+#define FSCACHE_FLAG_DIRTY				0x02
 
 #define CODAL_FS_CACHE_VALIDATE			1
 #define CODAL_FS_DEFAULT_CACHE_SZE		4
@@ -34,11 +35,21 @@ namespace codal
 	struct CacheEntry
 	{
 		uint32_t address;
-		uint16_t lastUsed;
+		uint32_t lastUsed;
 		uint16_t flags;
+		uint16_t dirtyStart;		// Offset of the first byte of the block awaiting write back. Valid if FSCACHE_FLAG_DIRTY is set.
+		uint16_t dirtyEnd;			// Offset of the byte following the last byte awaiting write back.
 		uint8_t  *page;
 	};
 
+	struct FSCacheStatistics
+	{
+		uint32_t hits;				// Number of block accesses satisfied from the cache.
+		uint32_t misses;			// Number of block accesses that required a read from the backing store.
+		uint32_t evictions;			// Number of blocks replaced to make space for another.
+		uint32_t writeBacks;		// Number of dirty blocks written to the backing store.
+	};
+
 	class FSCache
 	{
 		private:
@@ -46,7 +57,29 @@ namespace codal
 			CacheEntry* cache;
 			int blockSize;
 			int cacheSize;
-			uint16_t operationCount;
+			uint32_t operationCount;
+			bool writeBack;
+			int readAhead;
+			uint8_t *readAheadBuffer;
+			uint32_t nextBlock;
+			CacheEntry *lastEntry;
+			FSCacheStatistics stats;
+
+			/**
+			 * Locate the given block in the cache, without affecting its LRU state.
+			 */
+			CacheEntry *findEntry(uint32_t address);
+
+			/**
+			 * Choose an entry to hold the given block, writing back and evicting the LRU block if necessary.
+			 * The contents of the page are not loaded.
+			 */
+			CacheEntry *allocateEntry(uint32_t address);
+
+			/**
+			 * Write back the dirty region of the given entry, if any.
+			 */
+			int flushEntry(CacheEntry *c);
 
 		public:
 		  /**
@@ -58,14 +91,54 @@ namespace codal
 
 			/**
 			 * Clear all cache entries, and free any allocated RAM.
+			 * Any dirty blocks are written back first.
 			 */
 			void clear();
 
 			/**
-			 * Erase a single page of FLASH memory at the given address
+			 * Erase a single page of FLASH memory at the given address, in the cache only.
+			 * All cached blocks within the physical page are erased, and any pending write back of them discarded.
 			 */
 			int erase(uint32_t address);
 
+			/**
+			 * Selects write-back or write-through (the default) operation.
+			 * In write-back mode, write() only updates the cache. Modified blocks are written to the backing store when
+			 * evicted, or when flush() is called. Leaving write-back mode performs a flush().
+			 *
+			 * @param enable true to enable write-back mode, false for write-through.
+			 */
+			void setWriteBack(bool enable);
+
+			/**
+			 * Write all modified blocks to the backing store.
+			 *
+			 * @return DEVICE_OK on success, or the error reported by the backing store.
+			 */
+			int flush();
+
+			/**
+			 * Configures sequential read-ahead. When a block is missed immediately after the one preceding it,
+			 * the following blocks are loaded in the same read of the backing store, ready for streaming readers.
+			 *
+			 * @param blocks the number of additional blocks to load, or zero to disable read-ahead (the default).
+			 *               Limited to one less than the size of the cache.
+			 *
+			 * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if no buffer could be allocated to read the blocks into,
+			 *         in which case read-ahead is disabled.
+			 */
+			int setReadAhead(int blocks);
+
+			/**
+			 * Retrieves the hit, miss, eviction and write back counts since the cache was created or the counts reset.
+			 */
+			FSCacheStatistics getStatistics();
+
+			/**
+			 * Resets the hit, miss, eviction and write back counts to zero.
+			 */
+			void resetStatistics();
+
 			/**
 			 * Read the given area of memory into the buffer provided,
 			 * paging the data in from FLASH as needed.
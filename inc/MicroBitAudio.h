@@ -38,6 +38,8 @@ DEALINGS IN THE SOFTWARE.
 
 // Status Flags
 #define MICROBIT_AUDIO_STATUS_DEEPSLEEP       0x0001
+#define MICROBIT_AUDIO_STATUS_STOP_WHEN_IDLE  0x0002
+#define MICROBIT_AUDIO_STATUS_PWM_STOPPED     0x0004
 #define CONFIG_DEFAULT_MICROPHONE_GAIN        0.1f
 
 // Configurable options
@@ -53,6 +55,11 @@ DEALINGS IN THE SOFTWARE.
 #define CONFIG_AUDIO_DEFAULT_MICROPHONE_SAMPLERATE        11000
 #endif
 
+// When enabled, the PWM output is stopped while every mixer channel is idle, and restarted on demand.
+#ifndef CONFIG_AUDIO_STOP_PWM_WHEN_IDLE
+#define CONFIG_AUDIO_STOP_PWM_WHEN_IDLE                   0
+#endif
+
 namespace codal
 {
     /**
@@ -171,6 +178,14 @@ namespace codal
          */
         bool isPlaying();
 
+        /**
+         * Allow the PWM output to be stopped while the mixer is idle, to save CPU time and power.
+         * Output is restarted automatically when a mixer channel is re-armed, or a sound is played.
+         *
+         * @param enable true to stop the PWM output while idle, false to keep it running continuously.
+         */
+        void setStopWhenIdle(bool enable);
+
         /**
          * Define which pin on the edge connector is used for audio.
          * @param pin The pin to use for auxiliary audio.
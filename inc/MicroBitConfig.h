@@ -141,6 +141,40 @@
     #define MBFS_CACHE_SIZE        0
 #endif
 
+//
+// Enables the log-structured allocation mode of the file system by default.
+// In this mode free blocks are tracked in a RAM bitmap and garbage collection is deferred,
+// so that appending to a file never erases a FLASH page while erased blocks remain.
+// Costs one bit per block plus two bytes per page of RAM. Set to zero to disable this feature.
+//
+#ifndef MBFS_LOG_STRUCTURED
+    #define MBFS_LOG_STRUCTURED    0
+#endif
+
+//
+// When in log-structured mode, the percentage of erased blocks below which close()
+// runs deferred garbage collection.
+//
+#ifndef MBFS_GC_THRESHOLD
+    #define MBFS_GC_THRESHOLD      10
+#endif
+
+//
+// Number of hash buckets in the RAM index of directory entries, used to locate files
+// without scanning directory blocks in FLASH. Costs four bytes per bucket plus a
+// small allocation per file. Set to zero to disable this feature.
+//
+#ifndef MBFS_INDEX_BUCKETS
+    #define MBFS_INDEX_BUCKETS     16
+#endif
+
+//
+// Number of recently resolved directory paths to cache. Set to zero to disable this feature.
+//
+#ifndef MBFS_PATH_CACHE_SIZE
+    #define MBFS_PATH_CACHE_SIZE   4
+#endif
+
 // Address of the end of the current program in FLASH memory.
 // This is recorded by the C/C++ linker, but the symbol name varies depending on which compiler is used.
 #if defined(__arm)
@@ -279,6 +313,12 @@
 #define MICROBIT_BLE_UTILITY_SERVICE 0
 #endif
 
+// Maximum number of bytes of log data carried by each notification of the MicroBitUtilityService stream characteristic.
+// Each notification is also limited by the ATT MTU negotiated with the client.
+#ifndef MICROBIT_BLE_UTILITY_STREAM_CHUNK
+#define MICROBIT_BLE_UTILITY_STREAM_CHUNK 244
+#endif
+
 // Enable/Disable Nordic Firmware style BLE based UART implimentation.
 // The default codal implimentation reverses the TX/RX ids  
 // Set to '1' to enable
@@ -293,6 +333,98 @@
     #define MICROBIT_RADIO_MAX_PACKET_SIZE          32
 #endif
 
+// Configure the number of receive buffers preallocated by the radio.
+// These form a ring that the RADIO hardware receives into directly, so no memory is allocated as packets arrive.
+// Up to (MICROBIT_RADIO_RX_BUFFERS - 1) packets may be held awaiting processing at any time.
+// Valid range: 2..32
+#ifndef MICROBIT_RADIO_RX_BUFFERS
+    #define MICROBIT_RADIO_RX_BUFFERS               12
+#endif
+
+// Determines how often MICROBIT_RADIO_EVT_DATAGRAM is raised.
+// 0: One event is raised for each datagram received.
+// 1: One event is raised for each burst of datagrams processed by the radio. Listeners are then expected
+//    to drain the queue, e.g. using MicroBitRadioDatagram::recv(PacketBuffer *, int).
+#ifndef MICROBIT_RADIO_DATAGRAM_BATCH_EVENTS
+    #define MICROBIT_RADIO_DATAGRAM_BATCH_EVENTS    0
+#endif
+
+// Configure the radio large datagram service (MicroBitRadioLargeDatagram), which splits datagrams across several frames.
+// MICROBIT_RADIO_FRAGMENT_MAX_SIZE:    The largest datagram that can be sent or received, in bytes.
+// MICROBIT_RADIO_FRAGMENT_SLOTS:       The number of datagrams that can be held at once, whether being reassembled or awaiting recv().
+// MICROBIT_RADIO_FRAGMENT_TIMEOUT:     The time after which an incomplete datagram is discarded if no more of its fragments arrive, in milliseconds.
+#ifndef MICROBIT_RADIO_FRAGMENT_MAX_SIZE
+    #define MICROBIT_RADIO_FRAGMENT_MAX_SIZE        1024
+#endif
+
+#ifndef MICROBIT_RADIO_FRAGMENT_SLOTS
+    #define MICROBIT_RADIO_FRAGMENT_SLOTS           4
+#endif
+
+#ifndef MICROBIT_RADIO_FRAGMENT_TIMEOUT
+    #define MICROBIT_RADIO_FRAGMENT_TIMEOUT         500
+#endif
+
+// Configure the radio reliable datagram service (MicroBitRadioReliable).
+// MICROBIT_RADIO_RELIABLE_PEERS:       The number of peers for which sequence numbers and statistics are held.
+// MICROBIT_RADIO_RELIABLE_RETRIES:     The number of times an unacknowledged datagram is retransmitted before giving up.
+// MICROBIT_RADIO_RELIABLE_INITIAL_RTO: The retransmission timeout used before a round trip time has been measured, in milliseconds.
+// MICROBIT_RADIO_RELIABLE_MIN_RTO:     The lower bound of the adaptive retransmission timeout, in milliseconds.
+// MICROBIT_RADIO_RELIABLE_MAX_RTO:     The upper bound of the adaptive retransmission timeout, in milliseconds.
+#ifndef MICROBIT_RADIO_RELIABLE_PEERS
+    #define MICROBIT_RADIO_RELIABLE_PEERS           4
+#endif
+
+#ifndef MICROBIT_RADIO_RELIABLE_RETRIES
+    #define MICROBIT_RADIO_RELIABLE_RETRIES         4
+#endif
+
+#ifndef MICROBIT_RADIO_RELIABLE_INITIAL_RTO
+    #define MICROBIT_RADIO_RELIABLE_INITIAL_RTO     20
+#endif
+
+#ifndef MICROBIT_RADIO_RELIABLE_MIN_RTO
+    #define MICROBIT_RADIO_RELIABLE_MIN_RTO         3
+#endif
+
+#ifndef MICROBIT_RADIO_RELIABLE_MAX_RTO
+    #define MICROBIT_RADIO_RELIABLE_MAX_RTO         250
+#endif
+
+// Configure the optional radio MAC layer (see MicroBitRadio::setMACMode).
+// MICROBIT_RADIO_LBT_THRESHOLD:        The default signal strength above which the channel is considered busy, in dBm.
+// MICROBIT_RADIO_LBT_BACKOFF_UNIT:     The unit of random backoff when the channel is busy, in milliseconds.
+// MICROBIT_RADIO_LBT_MAX_BACKOFF_EXPONENT: The largest contention window used when backing off, as a power of two units.
+// MICROBIT_RADIO_LBT_MAX_ATTEMPTS:     The number of times the channel is sampled before a transmission is abandoned.
+// MICROBIT_RADIO_TDMA_GUARD_TIME:      The time at the end of each TDMA slot in which no new transmission is started, in microseconds.
+#ifndef MICROBIT_RADIO_LBT_THRESHOLD
+    #define MICROBIT_RADIO_LBT_THRESHOLD            -75
+#endif
+
+#ifndef MICROBIT_RADIO_LBT_BACKOFF_UNIT
+    #define MICROBIT_RADIO_LBT_BACKOFF_UNIT         1
+#endif
+
+#ifndef MICROBIT_RADIO_LBT_MAX_BACKOFF_EXPONENT
+    #define MICROBIT_RADIO_LBT_MAX_BACKOFF_EXPONENT 4
+#endif
+
+#ifndef MICROBIT_RADIO_LBT_MAX_ATTEMPTS
+    #define MICROBIT_RADIO_LBT_MAX_ATTEMPTS         6
+#endif
+
+#ifndef MICROBIT_RADIO_TDMA_GUARD_TIME
+    #define MICROBIT_RADIO_TDMA_GUARD_TIME          1000
+#endif
+
+// Enable timing instrumentation of the radio receive path, reported through MicroBitRadio::stats.
+// This records the time spent in the radio interrupt handler and the latency between a packet being
+// received and it being dispatched to its protocol handler, at the cost of a few timer reads per packet.
+// Set to '1' to enable.
+#ifndef MICROBIT_RADIO_INSTRUMENTATION
+    #define MICROBIT_RADIO_INSTRUMENTATION          0
+#endif
+
 // Versioning options.
 // We use semantic versioning (http://semver.org/) to identify different versions of the micro:bit runtime.
 // If this isn't available, it can be defined manually as a configuration option.
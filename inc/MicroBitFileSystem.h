@@ -43,6 +43,7 @@ DEALINGS IN THE SOFTWARE.
 
 // Status flags
 #define MBFS_STATUS_INITIALISED           0x01
+#define MBFS_STATUS_LOG_STRUCTURED        0x02
 
 // FileTable codes
 #define MBFS_UNUSED                       0xFFFF
@@ -85,6 +86,27 @@ struct Directory
     DirectoryEntry entry[0];
 };
 
+//
+// Every file and directory is also recorded in an index held in RAM, keyed on
+// its filename and parent directory, using the following structure.
+//
+struct DirectoryIndexEntry
+{
+    uint32_t hash;                              // Hash of the filename and parent directory.
+    DirectoryEntry *dirent;                     // The directory entry of the file.
+    DirectoryEntry *directory;                  // The directory entry of the file's parent directory.
+    DirectoryIndexEntry *next;                  // The next entry in the same hash bucket.
+};
+
+//
+// Recently resolved directory paths are cached, using the following structure.
+//
+struct DirectoryPathCacheEntry
+{
+    char *path;                                 // The path of the directory, or NULL if unused.
+    DirectoryEntry *directory;                  // The directory entry of the directory.
+};
+
 //
 // A FileDescriptor holds contextual information needed for each OPEN file.
 //
@@ -108,6 +130,10 @@ struct FileDescriptor
     // the directory entry of our parent directory. 
     DirectoryEntry *directory;
 
+    // Cursor into the file's block chain: a block at or before the current position, and the file offset at which that block starts.
+    uint16_t block;
+    uint32_t blockStart;
+
     // We maintain a chain of open file descriptors. Reference to the next FileDescriptor in the chain.
     FileDescriptor *next;
 
@@ -157,6 +183,24 @@ class MicroBitFileSystem
     // Chain of open files.
     FileDescriptor *openFiles;
 
+    // Log-structured mode: bitmap of erased, unallocated blocks (one bit per block).
+    uint32_t *freeBlockMap;
+
+    // Log-structured mode: bitmap of pages holding unallocated blocks that must be erased before reuse.
+    uint32_t *dirtyPageMap;
+
+    // Log-structured mode: number of erase operations seen by each physical page since power on.
+    uint16_t *eraseCount;
+
+    // Log-structured mode: number of blocks currently marked in freeBlockMap.
+    uint16_t freeBlockCount;
+
+    // Hash buckets of the directory index, or NULL if the index is unavailable.
+    DirectoryIndexEntry **directoryIndex;
+
+    // Recently resolved directory paths, most recently used first.
+    DirectoryPathCacheEntry pathCache[MBFS_PATH_CACHE_SIZE];
+
     /**
       * Initialize the flash storage system
       *
@@ -185,6 +229,13 @@ class MicroBitFileSystem
       */
     uint16_t getFreeBlock();
 
+    /**
+      * Allocate a free logical block from the RAM free block bitmap, in round robin order.
+      * Deferred garbage collection is only run if no erased blocks remain.
+      * @return a valid, erased and unused block number on success, or zero if no space is available.
+      */
+    uint16_t getFreeLogBlock();
+
     /**
     * Allocates a free physical block.
     * A round robin algorithm is used to even out the wear on the physical device.
@@ -247,6 +298,122 @@ class MicroBitFileSystem
     */
     int recycleFileTable();
 
+    /**
+    * Build the directory index, by walking every directory from the root.
+    * If there is insufficient RAM, the index is discarded and directories are searched in FLASH instead.
+    *
+    * @return MICROBIT_OK on success, or MICROBIT_NO_RESOURCES if the index could not be built.
+    */
+    int buildDirectoryIndex();
+
+    /**
+    * Add all entries of the given directory, and any subdirectories, to the directory index.
+    *
+    * @param directory The directory to index.
+    * @return MICROBIT_OK on success, or MICROBIT_NO_RESOURCES if there is insufficient RAM.
+    */
+    int indexDirectory(DirectoryEntry *directory);
+
+    /**
+    * Add a DirectoryEntry to the directory index.
+    * If there is insufficient RAM, the index is discarded.
+    *
+    * @param directory The directory holding the entry.
+    * @param dirent The entry to add.
+    * @return MICROBIT_OK on success, or MICROBIT_NO_RESOURCES if there is insufficient RAM.
+    */
+    int indexInsert(DirectoryEntry *directory, DirectoryEntry *dirent);
+
+    /**
+    * Find the index entry for the given filename.
+    *
+    * @param directory The directory to search.
+    * @param name The filename, with any path removed.
+    * @return The DirectoryIndexEntry for the file, or NULL if no entry is found.
+    */
+    DirectoryIndexEntry* indexFind(const DirectoryEntry *directory, char const *name);
+
+    /**
+    * Replace a DirectoryEntry in the directory index with another of the same name, or remove it.
+    *
+    * @param directory The directory holding the entry.
+    * @param dirent The entry to replace.
+    * @param replacement The new entry, or NULL to remove the entry from the index.
+    */
+    void indexReplace(DirectoryEntry *directory, DirectoryEntry *dirent, DirectoryEntry *replacement);
+
+    /**
+    * Release all memory held by the directory index.
+    */
+    void freeDirectoryIndex();
+
+    /**
+    * Release all entries in the directory path cache.
+    */
+    void clearPathCache();
+
+    /**
+    * Compact the given directory and any subdirectories, recycling the blocks of
+    * any directory entries that have been deleted.
+    *
+    * @param directory The directory to compact.
+    */
+    void gcDirectory(DirectoryEntry *directory);
+
+    /**
+    * Determine if the given block is erased and available for allocation.
+    * Only valid in log-structured mode.
+    *
+    * @param block A valid block number.
+    * @return true if the block is marked in the free block bitmap, false otherwise.
+    */
+    bool isBlockFree(uint16_t block);
+
+    /**
+    * Mark the given block as available (or unavailable) in the free block bitmap.
+    *
+    * @param block A valid block number.
+    * @param free true if the block is erased and may be allocated, false otherwise.
+    */
+    void setBlockFree(uint16_t block, bool free);
+
+    /**
+    * Determine the index of the physical page within the file system holding the given address.
+    *
+    * @param address A memory location.
+    * @return The page index, or -1 if the address lies outside the file system.
+    */
+    int getPageIndex(void *address);
+
+    /**
+    * Record that the given physical page has been erased.
+    *
+    * @param page The address of the page.
+    */
+    void recordErase(uint32_t *page);
+
+    /**
+    * Recalculate the free block bitmap and dirty state of the given physical page,
+    * from the file table and the contents of FLASH memory.
+    *
+    * @param page The address of the page. Pages outside the file system are ignored.
+    */
+    void updatePageState(uint32_t *page);
+
+    /**
+    * Return a page obtained from getFreePage() and used as scratch space by flash_write(),
+    * accounting for any erase operations performed.
+    *
+    * @param scratch The scratch page.
+    * @param address The address that was written.
+    */
+    void releaseScratchPage(uint32_t *scratch, void *address);
+
+    /**
+    * Rebuild the free block bitmap and dirty page bitmap for the whole file system.
+    */
+    void buildAllocationMap();
+
     /**
     * Retrieve a memory pointer for the start of the physical memory page containing the given block.
     *
@@ -315,6 +482,20 @@ class MicroBitFileSystem
     */
     int format();
 
+    /**
+      * Locate the block holding the given position in a file, walking the block chain
+      * from the file's cursor where possible, and moving the cursor to the block found.
+      *
+      * A position on a block boundary may be reported as the end of the preceding block
+      * (offset MBFS_BLOCK_SIZE), as the following block may not yet exist.
+      *
+      * @param file FileDescriptor of the file.
+      * @param position The position in the file, in bytes.
+      * @param offset Set to the offset of the position within the returned block.
+      * @return The block number.
+      */
+    uint16_t getFileBlock(FileDescriptor *file, uint32_t position, uint32_t *offset);
+
     /**
       * Flush a given file's cache back to FLASH memory.
       *
@@ -492,6 +673,34 @@ class MicroBitFileSystem
       */
     int read(int fd, uint8_t* buffer, int size);
 
+    /**
+      * Map data from the file directly from FLASH memory, without copying.
+      *
+      * Provides a pointer to the data at the current seek position, and the number of bytes
+      * that may be read contiguously from it. This runs to the end of the current block, extended
+      * across any following blocks of the file that are physically adjacent, up to the end of the file.
+      * The seek position is advanced by the number of bytes returned, so repeated calls
+      * consume a file sequentially in the same way as read().
+      *
+      * @param fd File handle, obtained with open()
+      * @param buffer Set to the address of the data in FLASH memory.
+      * @return number of bytes mapped on success (zero at the end of the file), MICROBIT_NOT_SUPPORTED if
+      *         the file system is not initialised, or MICROBIT_INVALID_PARAMETER if the given file handle is invalid.
+      *
+      * @note The data is read only, and remains valid until the file is written or removed, or the
+      *       file system performs garbage collection.
+      *
+      * @code
+      * MicroBitFileSystem f;
+      * int fd = f.open("asset.bin", MB_READ);
+      * const uint8_t *data;
+      * int len;
+      * while ((len = f.mmap(fd, &data)) > 0)
+      *    consume(data, len);
+      * @endcode
+      */
+    int mmap(int fd, const uint8_t **buffer);
+
     /**
       * Remove a file from the system, and free allocated assets
       * (including assigned blocks which are returned for use by other files).
@@ -517,6 +726,37 @@ class MicroBitFileSystem
     * @return MICROBIT_OK on success, MICROBIT_INVALID_PARAMETER if the path is invalid, or MICROBT_NO_RESOURCES if the FileSystem is full.
     */
     int createDirectory(char const *name);
+
+    /**
+    * Enables or disables log-structured allocation.
+    *
+    * In log-structured mode, free blocks are tracked in a RAM bitmap and allocated round robin,
+    * scratch pages are chosen by lowest erase count, and reclaiming deleted blocks is deferred
+    * until gc() is called, free space drops below MBFS_GC_THRESHOLD on close(), or no erased blocks remain.
+    * Appends therefore never erase FLASH memory while erased blocks are available.
+    *
+    * @param enable true to enable log-structured mode, false to revert to in-place recycling.
+    * @return MICROBIT_OK on success, MICROBIT_NOT_SUPPORTED if the file system has not been initialised,
+    *         or MICROBIT_NO_RESOURCES if there is insufficient RAM.
+    */
+    int setLogStructured(bool enable);
+
+    /**
+    * Performs garbage collection. Compacts directories, erases pages left dirty by overwrites
+    * and returns all deleted blocks to the free pool. This may erase several FLASH pages.
+    *
+    * @return MICROBIT_OK on success, or MICROBIT_NOT_SUPPORTED if the file system has not been initialised.
+    */
+    int gc();
+
+    /**
+    * Determines the number of times a physical page of the file system has been erased since power on.
+    *
+    * @param page The index of the page, from the start of the file system.
+    * @return The number of erase operations, MICROBIT_NOT_SUPPORTED if not in log-structured mode,
+    *         or MICROBIT_INVALID_PARAMETER if the page is out of range.
+    */
+    int getEraseCount(int page);
 };
 
 } // namespace codal
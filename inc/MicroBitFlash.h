@@ -24,9 +24,51 @@ DEALINGS IN THE SOFTWARE.
 
 #include "nrf.h"
 
+// Event ID used to signal the completion of queued flash operations.
+#ifndef MICROBIT_ID_FLASH
+#define MICROBIT_ID_FLASH                   3031
+#endif
+
+#define MICROBIT_FLASH_EVT_READY            1
+
+// The maximum number of flash operations that may be queued before callers are made to wait.
+#ifndef MICROBIT_FLASH_QUEUE_SIZE
+#define MICROBIT_FLASH_QUEUE_SIZE           8
+#endif
+
+// The number of words programmed by the NVMC before other fibers are given an opportunity to run.
+#ifndef MICROBIT_FLASH_NVMC_BURST
+#define MICROBIT_FLASH_NVMC_BURST           64
+#endif
+
+// The number of words assembled by flash_write() before they are programmed as a single operation.
+#ifndef MICROBIT_FLASH_WRITE_BURST
+#define MICROBIT_FLASH_WRITE_BURST          32
+#endif
+
+// Where the NVMC supports partial page erase, the duration of each partial erase step,
+// and the total erase time required to fully erase a page (milliseconds).
+#ifndef MICROBIT_FLASH_PARTIAL_ERASE_TIME
+#define MICROBIT_FLASH_PARTIAL_ERASE_TIME   10
+#endif
+
+#ifndef MICROBIT_FLASH_PAGE_ERASE_TIME
+#define MICROBIT_FLASH_PAGE_ERASE_TIME      90
+#endif
+
 namespace codal
 {
 
+/**
+  * A queued erase or program operation.
+  */
+struct MicroBitFlashOperation
+{
+    uint32_t    *address;                   // The flash address to erase or program.
+    uint32_t    *buffer;                    // The data to program, or NULL for a page erase.
+    int         length;                     // The number of words left to program, or erase time remaining (ms).
+};
+
 class MicroBitFlash
 {
     private:
@@ -87,6 +129,43 @@ class MicroBitFlash
       */
     void flash_burn(uint32_t* page_address, uint32_t* buffer, int len);
 
+    /**
+      * Queue the erase of an entire page, and return without waiting for it to complete.
+      * Operations are performed in the order they are queued. If the queue is full,
+      * the calling fiber waits until space is available.
+      *
+      * @param page_address address of first word of page.
+      * @return MICROBIT_OK on success.
+      */
+    int erase_page_async(uint32_t* page_address);
+
+    /**
+      * Queue a write to flash memory, and return without waiting for it to complete.
+      * The write is merged with the previously queued write where the two are contiguous.
+      *
+      * @param page_address address of memory to write to. Must be word aligned.
+      * @param buffer address to write from, must be word-aligned. Must remain valid until the
+      *               operation completes (see wait()).
+      * @param len number of uint32_t words to write.
+      * @return MICROBIT_OK on success.
+      */
+    int flash_burn_async(uint32_t* page_address, uint32_t* buffer, int len);
+
+    /**
+      * Wait for all queued flash operations to complete. The calling fiber is descheduled
+      * while the SoftDevice or NVMC is busy, so other fibers continue to run.
+      *
+      * @return MICROBIT_OK on success.
+      */
+    int wait();
+
+    /**
+      * Determine if any queued flash operations are yet to complete.
+      *
+      * @return true if operations are pending, false otherwise.
+      */
+    bool busy();
+
 };
 
 } // namespace codal
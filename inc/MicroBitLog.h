@@ -89,6 +89,34 @@ DEALINGS IN THE SOFTWARE.
  * 
  */
 
+/*
+ * Binary log data format (see MicroBitLog::setStorageFormat()):
+ *
+ * Log Data holds a sequence of records, each rendering to CSV text exactly as the text format would store it.
+ * MY_DATA.HTM holds the log within an HTML comment, so every byte of a record is 7 bit ASCII other than CR, NUL,
+ * '!', '-' and '>', except within the text of strings. The page therefore shows the records intact, and they can
+ * never end the comment. No byte of a record reads as unused (0xFF) memory.
+ *
+ * Integers are stored as varints, least significant digit first. Each continuation byte holds a base 59 digit,
+ * being the value of the byte less the number of characters from 0x00 up to and including it that are excluded
+ * above. The final byte holds a base 63 digit, as 0x40 plus the value of the digit (0x40-0x7E).
+ *
+ * VIEWER record: "-->" | <script> rendering the records as CSV text for MY_DATA.HTM | "<!--\n".
+ *                Always the first record of a binary log. See MicroBitLog::viewer.
+ * TEXT record:   'T' | varint length | text, with any newline as its last byte.
+ * ROW record:    'R' | varint column count | per column, a varint holding its type, followed by its value.
+ * REPEAT record: 'S' | per column, its value. The columns and their types are those of the previous ROW record,
+ *                which must have no more than MICROBIT_LOG_REPEAT_COLUMNS columns.
+ *
+ * Value types:
+ *   0x0        Empty.
+ *   0x1-0x9    Decimal number with (type - 1) decimal places. Value is the zigzag varint of the number without its point.
+ *   0xA        String. Value is a varint length followed by the text.
+ *   0xB-0xC    Timestamp with 0 (0xB) or 2 (0xC) decimal places, as for a decimal number. Value is the zigzag varint
+ *              of the difference from the previous timestamp.
+ *   0xD-0xE    As 0xB-0xC, but the value is the timestamp itself, rather than a difference.
+ */
+
 #ifndef MICROBIT_LOG_H
 #define MICROBIT_LOG_H
 
@@ -110,24 +138,91 @@ DEALINGS IN THE SOFTWARE.
 #define CONFIG_MICROBIT_LOG_CACHE_BLOCK_SIZE    256
 #endif
 
+// Number of additional cache blocks loaded when the log is read sequentially. See FSCache::setReadAhead().
+#ifndef CONFIG_MICROBIT_LOG_CACHE_READ_AHEAD
+#define CONFIG_MICROBIT_LOG_CACHE_READ_AHEAD    1
+#endif
+
 #ifndef CONFIG_MICROBIT_LOG_FULL_ERASE_BY_DEFAULT
 #define CONFIG_MICROBIT_LOG_FULL_ERASE_BY_DEFAULT    false
 #endif
 
+#ifndef CONFIG_MICROBIT_LOG_BINARY_BY_DEFAULT
+#define CONFIG_MICROBIT_LOG_BINARY_BY_DEFAULT   false
+#endif
+
 #ifndef CONFIG_MICROBIT_LOG_INVALID_CHAR_VALUE
 #define CONFIG_MICROBIT_LOG_INVALID_CHAR_VALUE  '_'
 #endif
 
+// Initial size of the RAM buffer used to accumulate and serialise each row.
+// The buffer grows (and is then reused) if a row does not fit.
+#ifndef CONFIG_MICROBIT_LOG_ROW_BUFFER_SIZE
+#define CONFIG_MICROBIT_LOG_ROW_BUFFER_SIZE     128
+#endif
+
+// Default group commit configuration. See MicroBitLog::setGroupCommit().
+// A size of zero writes each row to storage as it is logged.
+#ifndef CONFIG_MICROBIT_LOG_GROUP_COMMIT_SIZE
+#define CONFIG_MICROBIT_LOG_GROUP_COMMIT_SIZE   0
+#endif
+
+#ifndef CONFIG_MICROBIT_LOG_GROUP_COMMIT_DELAY
+#define CONFIG_MICROBIT_LOG_GROUP_COMMIT_DELAY  1000
+#endif
+
+// Row index configuration. A checkpoint is kept for every CONFIG_MICROBIT_LOG_ROW_INDEX_INTERVAL rows, in a
+// table of CONFIG_MICROBIT_LOG_ROW_INDEX_SIZE entries. When the table fills, the interval is doubled.
+#ifndef CONFIG_MICROBIT_LOG_ROW_INDEX_INTERVAL
+#define CONFIG_MICROBIT_LOG_ROW_INDEX_INTERVAL  16
+#endif
+
+#ifndef CONFIG_MICROBIT_LOG_ROW_INDEX_SIZE
+#define CONFIG_MICROBIT_LOG_ROW_INDEX_SIZE      64
+#endif
+
+// Maximum number of decimal places used when logging floating point values.
+#ifndef CONFIG_MICROBIT_LOG_FLOAT_PRECISION
+#define CONFIG_MICROBIT_LOG_FLOAT_PRECISION     4
+#endif
+
 #define MICROBIT_LOG_VERSION                "UBIT_LOG_FS_V_002\n"           // MUST be 18 characters.
+#define MICROBIT_LOG_VERSION_BINARY         "UBIT_LOG_FS_B_002\n"           // MUST be 18 characters, differing from MICROBIT_LOG_VERSION within the first 14.
 #define MICROBIT_LOG_JOURNAL_ENTRY_SIZE     8
 
 #define MICROBIT_LOG_STATUS_INITIALIZED     0x0001
 #define MICROBIT_LOG_STATUS_ROW_STARTED     0x0002
 #define MICROBIT_LOG_STATUS_FULL            0x0004
 #define MICROBIT_LOG_STATUS_SERIAL_MIRROR   0x0008
+#define MICROBIT_LOG_STATUS_LISTENING       0x0010
+#define MICROBIT_LOG_STATUS_ROW_INDEX       0x0020
+#define MICROBIT_LOG_STATUS_BINARY          0x0040
+#define MICROBIT_LOG_STATUS_COMMITTING      0x0080
+
+#define MICROBIT_LOG_RECORD_VIEWER          '-'
+#define MICROBIT_LOG_RECORD_TEXT            'T'
+#define MICROBIT_LOG_RECORD_ROW             'R'
+#define MICROBIT_LOG_RECORD_REPEAT          'S'
+#define MICROBIT_LOG_REPEAT_COLUMNS         16                              // Column types of a ROW record are kept for REPEAT records in a uint64_t.
+#define MICROBIT_LOG_NO_REPEAT              0xFFFFFFFFFFFFFFFFULL           // Column types when there is no ROW record for a REPEAT record to follow.
+
+#define MICROBIT_LOG_VARINT_FINAL           0x40                            // The final digit of a varint with a value of zero.
+#define MICROBIT_LOG_VARINT_FINAL_BASE      63                              // The base of varint final digits.
+#define MICROBIT_LOG_VARINT_BASE            59                              // The base of varint continuation digits.
+
+#define MICROBIT_LOG_VALUE_EMPTY            0x00
+#define MICROBIT_LOG_VALUE_NUMBER           0x01
+#define MICROBIT_LOG_VALUE_STRING           0x0A
+#define MICROBIT_LOG_VALUE_TIME             0x0B
+#define MICROBIT_LOG_VALUE_TIME_ABSOLUTE    0x0D
+
+#define MICROBIT_LOG_MAX_DECIMAL_PLACES     8
+#define MICROBIT_LOG_MAX_NUMBER             (1LL << 51)                     // Larger numbers are stored as strings, as MY_DATA.HTM cannot render them exactly.
+#define MICROBIT_LOG_DECODE_BUFFER_SIZE     48                              // Maximum text rendered from one byte of a binary record.
 
 
 #define MICROBIT_LOG_EVT_LOG_FULL           1
+#define MICROBIT_LOG_EVT_COMMIT             2
 
 namespace codal
 {
@@ -143,7 +238,11 @@ namespace codal
     {
         public:
         ManagedString key;
-        ManagedString value;
+        uint16_t hash;              // Hash of the key, used to accelerate lookups.
+        uint16_t valueOffset;       // Offset of the value for the current row in the row buffer.
+        uint16_t valueLength;       // Length of the value for the current row, or zero if no value has been set.
+
+        ColumnEntry() : hash(0), valueOffset(0), valueLength(0) {}
     };
 
     
@@ -184,6 +283,73 @@ namespace codal
     };
 
 
+    enum class LogFormat
+    {
+        Text = 0,         // Rows are stored as CSV text
+        Binary = 1        // Rows are stored as compact binary records, and rendered as CSV when read
+    };
+
+    /**
+     * Renders binary log records as CSV text, one byte at a time.
+     * The decoder holds no pointers, so its state can be saved and restored by copying it.
+     */
+    class MicroBitLogDecoder
+    {
+        public:
+        uint8_t     state;          // The field of the record being decoded.
+        uint8_t     type;           // The type of the column being decoded.
+        bool        repeat;         // Set if the current row is a REPEAT record.
+        uint32_t    column;         // The index of the column being decoded.
+        uint32_t    columns;        // The number of columns in the current row.
+        uint32_t    remaining;      // The number of bytes of text remaining in the current field.
+        uint64_t    value;          // The varint being decoded.
+        uint64_t    place;          // The place value of the next varint digit.
+        int64_t     time;           // The most recent timestamp.
+        uint64_t    rowTypes;       // The column types of the most recent ROW record, one per nibble (first column in the low nibble).
+
+        /**
+         * Constructor.
+         *
+         * @param time the value of the most recent timestamp before the first record to be decoded.
+         * @param rowTypes the column types of the most recent ROW record before the first record to be decoded.
+         */
+        MicroBitLogDecoder(int64_t time = 0, uint64_t rowTypes = MICROBIT_LOG_NO_REPEAT);
+
+        /**
+         * Decodes the next byte of binary log data.
+         *
+         * @param b the byte to decode.
+         * @param text buffer of at least MICROBIT_LOG_DECODE_BUFFER_SIZE bytes to receive the CSV text rendered.
+         * @return the number of characters of text rendered. A row ends with, and only with, a newline as the last character.
+         */
+        int decode(uint8_t b, char *text);
+
+        private:
+        int beginValue(char *text);
+        int endValue(char *text);
+    };
+
+    /**
+     * A position in a binary log, with the state needed to render CSV text from it.
+     */
+    struct MicroBitLogCursor
+    {
+        uint32_t            address;    // Logical address of the next byte to decode, or zero if not in use.
+        uint32_t            position;   // Offset in the CSV text of the first character rendered from that byte.
+        MicroBitLogDecoder  decoder;    // Decoder state before that byte.
+    };
+
+    /**
+     * An entry in the row index.
+     */
+    struct MicroBitLogRowIndexEntry
+    {
+        uint32_t            address;    // Logical address of the start of the row.
+        uint32_t            position;   // Offset of the start of the row in the CSV text.
+        int64_t             time;       // The most recent timestamp before the row. Used by binary logs only.
+        uint64_t            rowTypes;   // The column types of the most recent ROW record before the row. Used by binary logs only.
+    };
+
     enum class DataFormat
     {
         HTMLHeader = 0,   // The HTML header without the data
@@ -191,6 +357,26 @@ namespace codal
         CSV = 2           // CSV data
     };
 
+    /**
+     * Interface for consumers of data streamed from a MicroBitLog. See MicroBitLog::exportData().
+     */
+    class MicroBitLogSink
+    {
+        public:
+
+        /**
+         * Called with the next region of the exported data. To avoid copying, the data refers directly
+         * to the log's cache pages or static header, so is only valid for the duration of the call.
+         * This is called with the log locked, so must not call back into the MicroBitLog.
+         *
+         * @param data the data to consume.
+         * @param len the length of the data, in bytes.
+         *
+         * @return the number of bytes consumed. Consuming fewer than len bytes applies back-pressure, pausing the export.
+         */
+        virtual int writeData(const uint8_t *data, uint32_t len) = 0;
+    };
+
     /**
      * Class definition for MicroBitLog. A simple text only, append only, single file log file system.
      * Also contains a key/value pair abstraction to enable dynamic creation of CSV based logfiles.
@@ -219,11 +405,35 @@ namespace codal
         bool                            timeStampChanged;   // Flag to indicate if a timestamp format has changed.
 
         struct ColumnEntry*             rowData;            // Collection of key/value pairs. Used to accumulate each data row.
+        uint32_t                        nextColumn;         // The column following the one most recently logged. Checked first on lookup.
+        char*                           rowBuffer;          // Reusable buffer holding the values of the current row, and its serialised form.
+        uint32_t                        rowBufferSize;      // The size of rowBuffer, in bytes.
+        uint32_t                        rowBufferLength;    // The number of bytes of rowBuffer in use.
+        char*                           commitBuffer;       // Rows held in RAM awaiting a group commit.
+        uint32_t                        commitLength;       // The number of bytes of commitBuffer in use.
+        uint32_t                        commitSize;         // The size of commitBuffer, in bytes. Zero if group commit is disabled.
+        uint32_t                        commitDelay;        // The maximum time a row is held in commitBuffer, in milliseconds.
+        CODAL_TIMESTAMP                 commitTime;         // The time at which the oldest row in commitBuffer was logged, in milliseconds.
+        MicroBitLogRowIndexEntry*       rowIndex;           // The start of every rowIndexInterval'th row.
+        uint32_t                        rowIndexLength;     // The number of entries of rowIndex in use.
+        uint32_t                        rowIndexInterval;   // The number of rows between entries in rowIndex.
+        uint32_t                        rowCount;           // The number of rows in the log. Valid if MICROBIT_LOG_STATUS_ROW_INDEX is set.
+        uint32_t                        csvLength;          // The length of a binary log, once rendered as CSV. Valid if MICROBIT_LOG_STATUS_ROW_INDEX is set.
+        MicroBitLogDecoder              indexDecoder;       // Decoder state at the end of a binary log. Valid if MICROBIT_LOG_STATUS_ROW_INDEX is set.
+        MicroBitLogCursor               readCursor;         // Where the last read of a binary log finished, so sequential reads resume without rescanning.
+        uint8_t*                        recordBuffer;       // Reusable buffer holding each row once encoded as binary records.
+        uint32_t                        recordBufferSize;   // The size of recordBuffer, in bytes.
+        int64_t                         lastTime;           // The most recent timestamp written to a binary log.
+        bool                            lastTimeValid;      // Set if lastTime matches the log, so the next timestamp can be stored as a difference.
+        uint64_t                        lastTypes;          // The column types of the most recent ROW record written to a binary log, or MICROBIT_LOG_NO_REPEAT.
+        LogFormat                       storageFormat;      // The format to use the next time the log is cleared.
         struct MicroBitLogMetaData      metaData;           // Snapshot of the metadata held in flash storage.
         TimeStampFormat                 timeStampFormat;    // The format of timestamp to log on each row.
         ManagedString                   timeStampHeading;   // The title of the timestamp column, including units.
 
         const static uint8_t            header[2048];       // static header to prepend to FS in physical storage.
+        const static uint8_t            viewer[];           // VIEWER record, stored at the start of the data of binary logs.
+        const static uint32_t           viewerLength;       // The length of the VIEWER record.
 
         public:
 
@@ -294,6 +504,45 @@ namespace codal
         void setSerialMirroring(bool enable);
 
 
+        /**
+         * Selects the format rows are stored in. The binary format stores typed values, with numbers as varints
+         * and timestamps as the difference from the previous row. Rows repeating the columns of the last are stored
+         * without their types. Typical sensor data fits two to two and a half times as many rows into the log.
+         * All APIs that read the log render binary data as CSV text identical to that of the text format.
+         *
+         * The copy of MY_DATA.HTM on the MICROBIT drive is served directly from storage by the interface chip.
+         * Binary logs store a short script ahead of their data, which renders it as CSV text when the page is opened.
+         *
+         * An existing log keeps its format until cleared, unless it is empty, in which case it is reformatted immediately.
+         *
+         * @param format LogFormat::Text (the default), or LogFormat::Binary.
+         */
+        void setStorageFormat(LogFormat format);
+
+        /**
+         * Configures group commit mode. Rather than writing each row to storage as it is logged, rows are held
+         * in RAM and written together once maxBytes of data, or maxDelay milliseconds, have accumulated. This
+         * replaces several I2C transactions per row with a single write and journal update per group of rows.
+         *
+         * Pending data is committed automatically before MicroBitPowerManager powers off or deep sleeps the micro:bit,
+         * and before any data is read back from the log. If power is lost unexpectedly (e.g. the battery is removed
+         * or the reset button is pressed), at most the rows logged in the last maxDelay milliseconds, and never more
+         * than maxBytes bytes, are lost.
+         *
+         * @param maxBytes The maximum number of bytes to hold in RAM, or zero to write each row immediately (the default).
+         * @param maxDelay The maximum time, in milliseconds, a row is held in RAM before being written, or zero for no limit.
+         *
+         * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if pending data could not be written as the log is full.
+         */
+        int setGroupCommit(uint32_t maxBytes, uint32_t maxDelay = CONFIG_MICROBIT_LOG_GROUP_COMMIT_DELAY);
+
+        /**
+         * Writes any rows held in RAM by group commit mode to storage.
+         *
+         * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if the log is full.
+         */
+        int flush();
+
         /**
          * Creates a new row in the log, ready to be populated by logData()
          * 
@@ -319,6 +568,107 @@ namespace codal
          */
         int logData(ManagedString key, ManagedString value);
 
+        /**
+         * Populates the current row with the given key/value pair.
+         * The value is logged as a single character, as it would be if converted to a ManagedString.
+         *
+         * @param key the name of the key column) to set.
+         * @param value the value to insert
+         *
+         * @return DEVICE_OK on success.
+         */
+        int logData(const char *key, char value);
+
+        /**
+         * Populates the current row with the given key/value pair.
+         * Equivalent to logData(key, (long long)value).
+         *
+         * @param key the name of the key column) to set.
+         * @param value the value to insert
+         *
+         * @return DEVICE_OK on success.
+         */
+        int logData(const char *key, int value);
+
+        /**
+         * Populates the current row with the given key/value pair.
+         * Equivalent to logData(key, (unsigned long long)value).
+         *
+         * @param key the name of the key column) to set.
+         * @param value the value to insert
+         *
+         * @return DEVICE_OK on success.
+         */
+        int logData(const char *key, unsigned int value);
+
+        /**
+         * Populates the current row with the given key/value pair.
+         * Equivalent to logData(key, (long long)value).
+         *
+         * @param key the name of the key column) to set.
+         * @param value the value to insert
+         *
+         * @return DEVICE_OK on success.
+         */
+        int logData(const char *key, long value);
+
+        /**
+         * Populates the current row with the given key/value pair.
+         * Equivalent to logData(key, (unsigned long long)value).
+         *
+         * @param key the name of the key column) to set.
+         * @param value the value to insert
+         *
+         * @return DEVICE_OK on success.
+         */
+        int logData(const char *key, unsigned long value);
+
+        /**
+         * Populates the current row with the given key/value pair.
+         * The value is formatted directly into the row, without using the heap.
+         *
+         * @param key the name of the key column) to set.
+         * @param value the value to insert
+         *
+         * @return DEVICE_OK on success.
+         */
+        int logData(const char *key, long long value);
+
+        /**
+         * Populates the current row with the given key/value pair.
+         * The value is formatted directly into the row, without using the heap.
+         *
+         * @param key the name of the key column) to set.
+         * @param value the value to insert
+         *
+         * @return DEVICE_OK on success.
+         */
+        int logData(const char *key, unsigned long long value);
+
+        /**
+         * Populates the current row with the given key/value pair.
+         * The value is formatted directly into the row, without using the heap, to at most
+         * CONFIG_MICROBIT_LOG_FLOAT_PRECISION decimal places.
+         *
+         * @param key the name of the key column) to set.
+         * @param value the value to insert
+         *
+         * @return DEVICE_OK on success.
+         */
+        int logData(const char *key, float value);
+
+        /**
+         * Populates the current row with the given key/value pair.
+         * The value is formatted directly into the row, without using the heap, to at most
+         * CONFIG_MICROBIT_LOG_FLOAT_PRECISION decimal places, using double precision arithmetic.
+         *
+         * @param key the name of the key column) to set.
+         * @param value the value to insert
+         *
+         * @return DEVICE_OK on success.
+         */
+        int logData(const char *key, double value);
+
         /**
          * Complete a row in the log, and pushes to persistent storage.
          * @return DEVICE_OK on success.
@@ -361,6 +711,35 @@ namespace codal
          */
         int readData(void *data, uint32_t index, uint32_t len, DataFormat format, uint32_t length);
 
+        /**
+         * Streams the recorded data to the given sink, directly from the log's cache pages.
+         * Unlike readData(), no intermediate copies are made, and the sink controls the rate at which
+         * data is delivered. Data logged while an export is paused is included when it resumes.
+         *
+         * @param sink the consumer of the data.
+         * @param index the index into the data to start from. Updated to the index of the first byte not yet consumed.
+         * @param format the data format
+         *          DataFormat::HTMLHeader = 0,   - The HTML header without data
+         *          DataFormat::HTML = 1,               - The entire HTML file with data
+         *          DataFormat::CSV = 2                   - CSV data
+         *
+         * @return DEVICE_OK once all the data has been consumed, or DEVICE_BUSY if the sink applied back-pressure.
+         *         In that case, call again with the updated index to resume. DEVICE_INVALID_PARAMETER if the format is unknown.
+         */
+        int exportData(MicroBitLogSink &sink, uint32_t &index, DataFormat format);
+
+        /**
+         * Streams the recorded data over the serial port. This blocks the calling fiber until complete.
+         *
+         * @param format the data format
+         *          DataFormat::HTMLHeader = 0,   - The HTML header without data
+         *          DataFormat::HTML = 1,               - The entire HTML file with data
+         *          DataFormat::CSV = 2                   - CSV data
+         *
+         * @return DEVICE_OK on success, or the serial port's error if it stops accepting data.
+         */
+        int exportToSerial(DataFormat format = DataFormat::CSV);
+
         /**
         * Get the number of rows (including the header) in the datalogger.
         * @param fromRowIndex 0-based index of starting row: bumped up to 0 if negative.
@@ -395,7 +774,108 @@ namespace codal
         int _beginRow();
         int _endRow();
         int _logData(ManagedString key, ManagedString value);
+        int _logData(const char *key, int keyLength, const char *value, int valueLength);
         int _logString(const char *s);
+        int _logBuffer(const char *s, uint32_t len, int timeColumn = -1);
+        int _writeData(const char *s, uint32_t len);
+        int _flush();
+
+        /**
+         * Ensures the row index is available, scanning the data region to rebuild it if necessary.
+         * Once built, the index is kept up to date as data is written.
+         *
+         * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if memory for the index could not be allocated.
+         */
+        int buildRowIndex();
+
+        /**
+         * Updates the row index to account for the given data, which has been written to the log.
+         *
+         * @param address the logical address the data was written to.
+         * @param data the data written.
+         * @param len the length of the data, in bytes.
+         */
+        void indexRows(uint32_t address, const char *data, uint32_t len);
+
+        /**
+         * Determines the offset of the start of the given row in the CSV text, using the row index.
+         *
+         * @param row the 0-based index of the row. Must be no greater than rowCount.
+         * @return the offset of the first character of the row.
+         */
+        uint32_t findRow(uint32_t row);
+
+        /**
+         * Determines the length of the log data, once rendered as CSV text.
+         *
+         * @return the length of the CSV text, or zero if a binary log could not be indexed.
+         */
+        uint32_t getCSVLength();
+
+        /**
+         * Reads the log data as CSV text, rendering binary records if necessary.
+         *
+         * @param data the buffer to fill.
+         * @param position the offset into the CSV text to read from.
+         * @param len the number of characters to read. The range must lie within getCSVLength().
+         * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if a binary log could not be indexed.
+         */
+        int _readCSV(uint8_t *data, uint32_t position, uint32_t len);
+
+        /**
+         * Moves readCursor to the closest point in a binary log at or before the given offset in the CSV text.
+         *
+         * @param position the offset in the CSV text.
+         * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if the log could not be indexed.
+         */
+        int seekCursor(uint32_t position);
+
+        /**
+         * Renders part of a binary log as CSV text, advancing the given cursor.
+         * The cursor never moves past the end of the range requested, so can be used for the following range.
+         *
+         * @param cursor the position to render from, which must be at or before index.
+         * @param data the buffer to fill.
+         * @param index the offset into the CSV text of the first character to render.
+         * @param len the number of characters to render.
+         * @return the number of characters rendered, which is less than len only at the end of the log.
+         */
+        uint32_t renderData(MicroBitLogCursor &cursor, uint8_t *data, uint32_t index, uint32_t len);
+
+        /**
+         * Encodes text logged as CSV as binary records.
+         *
+         * @param s the text to encode. Any number of lines may be given.
+         * @param len the length of the text, in bytes.
+         * @param timeColumn the column of the timestamp, or -1 if there is none.
+         * @param out buffer to receive the records. Must be at least 3 * len + 16 bytes long.
+         * @return the length of the records, in bytes.
+         */
+        uint32_t encodeRecords(const char *s, uint32_t len, int timeColumn, uint8_t *out);
+
+        /**
+         * Determines the type a value is stored as in a binary log.
+         *
+         * @param s the text of the value.
+         * @param len the length of the text.
+         * @param time true if the value is in the timestamp column.
+         * @param n the value of a number or timestamp, without its decimal point.
+         * @return the type of the value, as one of the MICROBIT_LOG_VALUE_* types.
+         */
+        uint8_t valueType(const char *s, int len, bool time, int64_t &n);
+
+        /**
+         * Event handler callback. Commits any pending data when the group commit timer expires,
+         * or the micro:bit is about to be powered down.
+         */
+        void commitEvent(Event);
+
+        /**
+         * Fiber entry point used to commit pending data before power down, without blocking the power manager.
+         *
+         * @param log the MicroBitLog to commit.
+         */
+        static void commitFiber(void *log);
         int _logString(ManagedString s);
 
         int _readData(uint8_t *data, uint32_t index, uint32_t len, DataFormat format, uint32_t length);
@@ -414,15 +894,52 @@ namespace codal
          */
         int _readSource( uint8_t *&data, uint32_t &index, uint32_t &len, uint32_t &srcIndex, const void *srcPtr, uint32_t srcAddress, uint32_t srcLen);
 
+        /**
+         * Stream the source data from local memory or interface flash to the given sink
+         * @param sink the consumer of the data
+         * @param index reference to the index into the data
+         * @param srcIndex reference to the index where the source data should begin
+         * @param srcPtr pointer to source data in local memory. NULL to use srcAddress
+         * @param srcAddress address of source data in interface flash. Ignored if srcPtr is not NULL.
+         * @param srcLen the length of the source data
+         * @return DEVICE_OK if the sink consumed all the data requested; DEVICE_BUSY if the sink applied back-pressure
+         * @note The referenced indices are updated ready for the next call
+         */
+        int _exportSource(MicroBitLogSink &sink, uint32_t &index, uint32_t &srcIndex, const void *srcPtr, uint32_t srcAddress, uint32_t srcLen);
+
+        /**
+         * Generate the metadata presented in the HTML file, which excludes the journal pages.
+         * @param meta the metadata to populate.
+         */
+        void _getExportMetaData(MicroBitLogMetaData &meta);
+
         /**
          * Add the given heading to the list of headings in use. If the heading already exists,
          * this method has no effect.
          * 
          * @param key the heading to add
-         * @param value the initial value to add, or ManagedString::EmptyString
          * @param head true to add the given field at the front of the list, false to add at the end.
+         * @return the index of the column holding the given heading.
+         */
+        int addHeading(ManagedString key, bool head = false);
+
+        /**
+         * Determines the column holding the given key.
+         *
+         * @param key the heading to find
+         * @param len the length of the key, in bytes
+         * @param hash the hash of the key, as calculated by hashKey()
+         * @return the index of the column in rowData, or -1 if the key is not in use.
+         */
+        int findColumn(const char *key, int len, uint16_t hash);
+
+        /**
+         * Ensures the row buffer has space for the given number of additional bytes, growing it if necessary.
+         *
+         * @param len the number of bytes required
+         * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if the buffer cannot be grown.
          */
-        void addHeading(ManagedString key, ManagedString value, bool head = false);
+        int reserveRowBuffer(uint32_t len);
 
         /**
          * Clean the given buffer of invalid LogFS symbols ("-->" and optionally ",\t\n")
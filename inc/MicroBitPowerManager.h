@@ -150,6 +150,15 @@ typedef struct {
 #define MICROBIT_USB_INTERFACE_ALWAYS_NOP          0x04
 #define MICROBIT_USB_INTERFACE_BUSY_FLAG_SUPPORTED 0x20
 
+//
+// Events raised before the micro:bit is powered off or enters deep sleep. These are delivered synchronously
+// to MESSAGE_BUS_LISTENER_IMMEDIATE listeners, to allow subsystems holding data in RAM to commit it to storage.
+// Listeners should not block. Instead, they may call powerDownDisable() and complete their work in another fiber,
+// calling powerDownEnable() when done. The values are chosen to be well above those used by deep sleep wake up timer events.
+//
+#define MICROBIT_POWER_MANAGER_EVT_POWER_OFF        0xFF01
+#define MICROBIT_POWER_MANAGER_EVT_DEEP_SLEEP       0xFF02
+
 //
 // Minimum deep sleep time (milliseconds)
 //
@@ -164,6 +173,13 @@ typedef struct {
 #define CONFIG_MINIMUM_POWER_ON_TIME  500
 #endif
 
+//
+// Maximum time off() waits for subsystems that have disabled power down to finish their work (milliseconds)
+//
+#ifndef CONFIG_MAXIMUM_POWER_OFF_DELAY
+#define CONFIG_MAXIMUM_POWER_OFF_DELAY  1000
+#endif
+
 namespace codal
 {
 
@@ -38,6 +38,8 @@ namespace codal
 #include "MicroBitConfig.h"
 #include "MicroBitRadioDatagram.h"
 #include "MicroBitRadioEvent.h"
+#include "MicroBitRadioLargeDatagram.h"
+#include "MicroBitRadioReliable.h"
 
 /**
  * Provides a simple broadcast radio abstraction, built upon the raw nrf51822 RADIO module.
@@ -66,6 +68,9 @@ namespace codal
 #define MICROBIT_RADIO_STATUS_INITIALISED       0x0001
 #define MICROBIT_RADIO_STATUS_DEEPSLEEP_IRQ     0x0002
 #define MICROBIT_RADIO_STATUS_DEEPSLEEP_INIT    0x0004
+#define MICROBIT_RADIO_STATUS_DISPATCHING       0x0008
+#define MICROBIT_RADIO_STATUS_TDMA_SYNC         0x0010
+#define MICROBIT_RADIO_STATUS_BEACON            0x0020
 
 // Default configuration values
 #define MICROBIT_RADIO_BASE_ADDRESS             0x75626974
@@ -75,6 +80,17 @@ namespace codal
 #define MICROBIT_RADIO_HEADER_SIZE              4
 #define MICROBIT_RADIO_MAXIMUM_RX_BUFFERS       4
 #define MICROBIT_RADIO_POWER_LEVELS             8
+#define MICROBIT_RADIO_MAX_GROUPS               8
+#define MICROBIT_RADIO_GROUP_ANY                -1
+#define MICROBIT_RADIO_DEFAULT_MODE             MICROBIT_RADIO_MODE_NRF_1MBIT
+#define MICROBIT_RADIO_DEFAULT_CRC_LENGTH       2
+#define MICROBIT_RADIO_DEFAULT_WHITENING_IV     0x18
+
+// Supported on-air modes. All of these carry a FrameBuffer as a plain 8 bit length field followed by its payload.
+#define MICROBIT_RADIO_MODE_NRF_1MBIT           0       // Nordic proprietary 1Mbps (default).
+#define MICROBIT_RADIO_MODE_NRF_2MBIT           1       // Nordic proprietary 2Mbps.
+#define MICROBIT_RADIO_MODE_BLE_1MBIT           2       // BLE 1Mbps PHY.
+#define MICROBIT_RADIO_MODE_BLE_2MBIT           3       // BLE 2Mbps PHY.
 
 // Max packet size is configurable, so ensure maximum value is not exceeded
 // TODO: Update this value once issue codal-microbit-v2#383 is resolved
@@ -83,12 +99,26 @@ namespace codal
     #error "MICROBIT_RADIO_MAX_PACKET_SIZE cannot be larger than 250 bytes"
 #endif
 
+#if MICROBIT_RADIO_RX_BUFFERS < 2 || MICROBIT_RADIO_RX_BUFFERS > 32
+    #error "MICROBIT_RADIO_RX_BUFFERS must be in the range 2..32"
+#endif
+
 // Known Protocol Numbers
 #define MICROBIT_RADIO_PROTOCOL_DATAGRAM        1       // A simple, single frame datagram. a little like UDP but with smaller packets. :-)
 #define MICROBIT_RADIO_PROTOCOL_EVENTBUS        2       // Transparent propogation of events from one micro:bit to another.
+#define MICROBIT_RADIO_PROTOCOL_FRAGMENT        3       // A fragment of a datagram too large to fit in a single frame.
+#define MICROBIT_RADIO_PROTOCOL_RELIABLE        4       // An acknowledged datagram addressed to a single micro:bit, or its acknowledgement.
+#define MICROBIT_RADIO_PROTOCOL_BEACON          5       // A TDMA synchronisation beacon.
+
+// MAC (channel access) modes
+#define MICROBIT_RADIO_MAC_NONE                 0       // Transmit immediately (default).
+#define MICROBIT_RADIO_MAC_LBT                  1       // Listen before talk: transmit only once the channel is quiet, backing off randomly whilst it is busy.
+#define MICROBIT_RADIO_MAC_TDMA                 2       // Transmit only within our slot of a beacon synchronised frame, listening before talk within it.
 
 // Events
 #define MICROBIT_RADIO_EVT_DATAGRAM             1       // Event to signal that a new datagram has been received.
+#define MICROBIT_RADIO_EVT_LARGE_DATAGRAM       2       // Event to signal that a new large (fragmented) datagram has been received and reassembled.
+#define MICROBIT_RADIO_EVT_RELIABLE             3       // Event to signal that a new reliable datagram has been received.
 
 namespace codal
 {
@@ -96,12 +126,46 @@ namespace codal
     {
         uint8_t         length;                             // The length of the remaining bytes in the packet. includes protocol/version/group fields, excluding the length field itself.
         uint8_t         version;                            // Protocol version code.
-        uint8_t         group;                              // ID of the group to which this packet belongs.
+        uint8_t         group;                              // ID of the group to which this packet belongs. On reception, this is set to the group the packet was received on.
         uint8_t         protocol;                           // Inner protocol number c.f. those issued by IANA for IP protocols
 
         uint8_t         payload[MICROBIT_RADIO_MAX_PACKET_SIZE];    // User / higher layer protocol data
         FrameBuffer     *next;                              // Linkage, to allow this and other protocols to queue packets pending processing.
         int             rssi;                               // Received signal strength of this frame.
+
+        /**
+         * Releases a FrameBuffer. Buffers taken from the radio's receive ring are handed back to the
+         * radio for reuse, any others are returned to the heap.
+         */
+        static void operator delete(void *p);
+    };
+
+    struct MicroBitRadioBeacon
+    {
+        uint16_t        slotDuration;                       // The duration of each TDMA slot, in milliseconds.
+        uint8_t         slotCount;                          // The number of slots in each frame, including the beacon slot (slot 0).
+    } __attribute__((packed));
+
+    struct MicroBitRadioStatistics
+    {
+        uint32_t        rxPackets;                          // Number of valid packets received and queued for processing.
+        uint32_t        rxCrcErrors;                        // Number of packets discarded due to a failed CRC check.
+        uint32_t        rxOverruns;                         // Number of valid packets lost because no free receive buffer was available.
+        uint32_t        rxDropped;                          // Number of packets discarded by higher layer protocols because their queues were full.
+        uint32_t        rxHighWaterMark;                    // The largest number of packets queued awaiting processing at any one time.
+        uint32_t        txBackoffs;                         // Number of times a transmission was deferred because the channel was busy.
+        uint32_t        txBackoffTime;                      // Total time spent backing off whilst the channel was busy, in microseconds.
+        uint32_t        txChannelBusy;                      // Number of transmissions abandoned because the channel remained busy.
+        uint32_t        txSlotWaitTime;                     // Total time spent waiting for our TDMA slot, in microseconds.
+
+#if CONFIG_ENABLED(MICROBIT_RADIO_INSTRUMENTATION)
+        uint32_t        isrCount;                           // Number of packet (END) events handled by the radio interrupt handler.
+        uint32_t        isrTimeTotal;                       // Total time spent handling those events, in microseconds.
+        uint32_t        isrTimeMax;                         // Longest time spent handling a single event, in microseconds.
+        uint32_t        latencyCount;                       // Number of packets dispatched to a protocol handler.
+        uint32_t        latencyTotal;                       // Total time between reception and dispatch of those packets, in microseconds.
+        uint32_t        latencyMax;                         // Longest time between reception and dispatch of a single packet, in microseconds.
+#endif
     };
 
 
@@ -109,15 +173,77 @@ namespace codal
     {
         uint8_t                 band;       // The radio transmission and reception frequency band.
         uint8_t                 power;      // The radio output power level of the transmitter.
-        uint8_t                 group;      // The radio group to which this micro:bit belongs.
-        uint8_t                 queueDepth; // The number of packets in the receiver queue.
+        uint8_t                 groups[MICROBIT_RADIO_MAX_GROUPS]; // The group matched by each RADIO logical address. Entry 0 is the group we transmit on.
+        uint8_t                 groupMask;  // Bitmask of the logical addresses (and hence entries in groups) in use.
+        uint8_t                 mode;       // The on-air mode (PHY) in use, one of MICROBIT_RADIO_MODE_*.
+        uint8_t                 crcLength;  // The length of the CRC appended to each packet, in bytes.
+        uint8_t                 whiteningIV; // The initial value of the data whitening algorithm.
         int                     rssi;
-        FrameBuffer             *rxQueue;   // A linear list of incoming packets, queued awaiting processing.
-        FrameBuffer             *rxBuf;     // A pointer to the buffer being actively used by the RADIO hardware.
+        FrameBuffer             *rxRing;    // A fixed ring of receive buffers, allocated once when the radio is first enabled.
+        volatile uint8_t        rxHead;     // Index of the ring buffer actively being used by the RADIO hardware. Written only by the ISR.
+        volatile uint8_t        rxTail;     // Index of the oldest packet awaiting processing. Written only by recv().
+        volatile uint32_t       rxInUse;    // Bitmask of ring buffers that have been handed out by recv() and not yet released.
+        uint32_t                *rxTimestamp; // The time at which each ring buffer was queued, in microseconds.
+        uint8_t                 macMode;    // The channel access mode in use, one of MICROBIT_RADIO_MAC_*.
+        int8_t                  ccaThreshold; // The signal strength above which the channel is considered busy, in dBm.
+        uint8_t                 tdmaSlot;   // The TDMA slot in which we may transmit.
+        uint8_t                 tdmaSlotCount; // The number of slots in each TDMA frame.
+        uint16_t                tdmaSlotDuration; // The duration of each TDMA slot, in milliseconds.
+        uint32_t                tdmaEpoch;  // The time at which the last beacon was sent or received, in microseconds.
+        uint32_t                txTimestamp; // The time at which our last transmission completed, in microseconds.
+
+        /**
+         * Samples the channel until it is quiet, backing off for a random, exponentially increasing period whilst it is busy.
+         *
+         * @return MICROBIT_OK if the channel is quiet, or MICROBIT_BUSY if it remained busy.
+         */
+        int listenBeforeTalk();
+
+        /**
+         * Waits until the current time falls within our TDMA slot.
+         * Returns immediately if we are not synchronised to a beacon.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if our slot does not exist in the current frame.
+         */
+        int waitForSlot();
+
+        /**
+         * Transmits a TDMA synchronisation beacon, and uses it as the start of the next frame.
+         */
+        void sendBeacon();
+
+        /**
+         * Synchronises our TDMA frame to a received beacon.
+         *
+         * @param p The beacon frame.
+         *
+         * @param timestamp The time at which the beacon was received, in microseconds.
+         */
+        void beaconReceived(FrameBuffer *p, uint32_t timestamp);
+
+        /**
+         * Writes the groups we are listening to into the address matching registers of the RADIO hardware.
+         */
+        void configureGroups();
+
+        /**
+         * Writes the on-air mode and packet format currently configured into the RADIO hardware.
+         *
+         * @note The RADIO must be disabled when this is called.
+         */
+        void configurePacketFormat();
+
+        /**
+         * Applies a change to the on-air mode or packet format, restarting the receiver if it is running.
+         */
+        void reconfigure();
 
         public:
         MicroBitRadioDatagram   datagram;   // A simple datagram service.
         MicroBitRadioEvent      event;      // A simple event handling service.
+        MicroBitRadioLargeDatagram largeDatagram; // A datagram service for payloads larger than a single frame.
+        MicroBitRadioReliable   reliable;   // An acknowledged datagram service.
+        MicroBitRadioStatistics stats;      // Receive path counters, useful to measure drops under load.
         static MicroBitRadio    *instance;  // A singleton reference, used purely by the interrupt service routine.
 
         /**
@@ -149,6 +275,93 @@ namespace codal
          */
         int setFrequencyBand(int band);
 
+        /**
+         * Change the on-air mode (PHY) used by the radio.
+         *
+         * Running at 2Mbps halves the time each packet spends on air, reducing the chance of collisions
+         * in busy environments. Only micro:bits using the same mode can communicate with each other.
+         *
+         * @param mode One of MICROBIT_RADIO_MODE_NRF_1MBIT, MICROBIT_RADIO_MODE_NRF_2MBIT,
+         *             MICROBIT_RADIO_MODE_BLE_1MBIT or MICROBIT_RADIO_MODE_BLE_2MBIT.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the mode is not supported,
+         *         or MICROBIT_NOT_SUPPORTED if the BLE stack is running.
+         */
+        int setMode(int mode);
+
+        /**
+         * Change the length of the CRC appended to, and checked on, each packet.
+         *
+         * @param length The CRC length in bytes, in the range 1..3. Packets are only received if their CRC is valid,
+         *               so a CRC cannot be disabled.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the value is out of range,
+         *         or MICROBIT_NOT_SUPPORTED if the BLE stack is running.
+         */
+        int setCRCLength(int length);
+
+        /**
+         * Change the initial value of the data whitening algorithm.
+         *
+         * @param iv The initial value, in the range 1..127.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the value is out of range,
+         *         or MICROBIT_NOT_SUPPORTED if the BLE stack is running.
+         */
+        int setWhiteningIV(int iv);
+
+        /**
+         * Selects how the radio gains access to the channel before each transmission.
+         *
+         * Frames sent whilst received packets are being processed (such as acknowledgements) are always sent
+         * immediately, as they directly follow a frame that already holds the channel.
+         *
+         * @param mode One of MICROBIT_RADIO_MAC_NONE, MICROBIT_RADIO_MAC_LBT or MICROBIT_RADIO_MAC_TDMA.
+         *             In TDMA mode, transmissions are made using listen before talk until a beacon has been received.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the mode is not supported.
+         */
+        int setMACMode(int mode);
+
+        /**
+         * Sets the signal strength above which the channel is considered busy when listening before talking.
+         *
+         * @param threshold The threshold in dBm, in the range -128..-30.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the value is out of range.
+         */
+        int setCCAThreshold(int threshold);
+
+        /**
+         * Sets the TDMA slot in which this micro:bit may transmit. The number and duration of the
+         * slots are determined by the beacons received from the coordinating micro:bit.
+         *
+         * @param slot The slot to use, in the range 1..255. Slot 0 is reserved for the coordinating micro:bit.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the value is out of range, or lies beyond
+         * the end of the frame we are currently synchronised to.
+         */
+        int setTDMASlot(int slot);
+
+        /**
+         * Makes this micro:bit the TDMA coordinator, periodically transmitting beacons that other micro:bits
+         * synchronise their slots to. The coordinator transmits in slot 0, and is placed into MICROBIT_RADIO_MAC_TDMA mode.
+         *
+         * @param slotCount The number of slots in each frame, including the coordinator's slot, in the range 2..255.
+         *
+         * @param slotDuration The duration of each slot in milliseconds, in the range 2..1000.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if a value is out of range.
+         */
+        int startBeacon(int slotCount, int slotDuration);
+
+        /**
+         * Stops transmitting TDMA beacons.
+         *
+         * @return MICROBIT_OK on success.
+         */
+        int stopBeacon();
+
         /**
          * Retrieve a pointer to the currently allocated receive buffer. This is the area of memory
          * actively being used by the radio hardware to store incoming data.
@@ -160,11 +373,30 @@ namespace codal
         /**
          * Attempt to queue a buffer received by the radio hardware, if sufficient space is available.
          *
-         * @return MICROBIT_OK on success, or MICROBIT_NO_RESOURCES if a replacement receiver buffer
-         *         could not be allocated (either by policy or memory exhaustion).
+         * @return MICROBIT_OK on success, or MICROBIT_NO_RESOURCES if no free buffer is available in the
+         *         receive ring, in which case the packet is dropped and the current buffer reused.
+         *
+         * @note should only be called from RADIO_IRQHandler...
          */
         int queueRxBuf();
 
+        /**
+         * Returns a buffer previously handed out by recv() to the receive ring, so that the
+         * RADIO hardware may reuse it.
+         *
+         * @param buffer The buffer to release.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the buffer is not part of the receive ring.
+         *
+         * @note This is called automatically when a received FrameBuffer is deleted.
+         */
+        int releaseRxBuf(FrameBuffer *buffer);
+
+        /**
+         * Resets all of the counters held in MicroBitRadio::stats to zero.
+         */
+        void resetStatistics();
+
         /**
          * Sets the RSSI for the most recent packet.
          * The value is measured in -dbm. The higher the value, the stronger the signal.
@@ -202,12 +434,35 @@ namespace codal
         /**
          * Sets the radio to listen to packets sent with the given group id.
          *
-         * @param group The group to join. A micro:bit can only listen to one group ID at any time.
+         * @param group The group to join. This is the group that packets are transmitted on. Use addGroup()
+         *              to listen to further groups at the same time.
          *
          * @return MICROBIT_OK on success, or MICROBIT_NOT_SUPPORTED if the BLE stack is running.
          */
         int setGroup(uint8_t group);
 
+        /**
+         * Additionally listens to packets sent with the given group id. The RADIO hardware performs the address
+         * matching, so up to MICROBIT_RADIO_MAX_GROUPS groups (including that given to setGroup()) can be received
+         * at no extra cost. The group a packet was received on is recorded in the group field of its FrameBuffer.
+         *
+         * @param group The group to listen to.
+         *
+         * @return MICROBIT_OK on success, MICROBIT_NO_RESOURCES if already listening to MICROBIT_RADIO_MAX_GROUPS groups,
+         *         or MICROBIT_NOT_SUPPORTED if the BLE stack is running.
+         */
+        int addGroup(uint8_t group);
+
+        /**
+         * Stops listening to packets sent with a group id previously passed to addGroup().
+         *
+         * @param group The group to stop listening to.
+         *
+         * @return MICROBIT_OK on success, MICROBIT_INVALID_PARAMETER if the group was not added using addGroup(),
+         *         or MICROBIT_NOT_SUPPORTED if the BLE stack is running.
+         */
+        int removeGroup(uint8_t group);
+
         /**
          * A background, low priority callback that is triggered whenever the processor is idle.
          * Here, we empty our queue of received packets, and pass them onto higher level protocol handlers.
@@ -229,10 +484,25 @@ namespace codal
          * @return The buffer containing the the packet. If no data is available, NULL is returned.
          *
          * @note Once recv() has been called, it is the callers responsibility to
-         *       delete the buffer when appropriate.
+         *       delete the buffer when appropriate. The buffer belongs to the receive ring,
+         *       so holding on to it reduces the number of packets that can be queued.
          */
         FrameBuffer* recv();
 
+        /**
+         * Retrieves up to the given number of packets from the receive buffer in a single operation.
+         * Packets are returned in the order they were received, and are dequeued.
+         *
+         * @param out An array of at least 'max' entries, into which pointers to the received packets are stored.
+         *
+         * @param max The maximum number of packets to retrieve.
+         *
+         * @return The number of packets stored in 'out', or MICROBIT_INVALID_PARAMETER if the parameters are invalid.
+         *
+         * @note As with recv(), it is the callers responsibility to delete each buffer when appropriate.
+         */
+        int recvBatch(FrameBuffer **out, int max);
+
         /**
          * Transmits the given buffer onto the broadcast radio.
          * The call will wait until the transmission of the packet has completed before returning.
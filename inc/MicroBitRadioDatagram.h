@@ -45,8 +45,18 @@ namespace codal
      */
     class MicroBitRadioDatagram
     {
-        MicroBitRadio   &radio;     // The underlying radio module used to send and receive data.
-        FrameBuffer     *rxQueue;   // A linear list of incoming packets, queued awaiting processing.
+        MicroBitRadio   &radio;         // The underlying radio module used to send and receive data.
+        FrameBuffer     *rxQueue;       // A linear list of incoming packets, queued awaiting processing.
+        FrameBuffer     *rxQueueTail;   // The last packet in rxQueue, so that packets can be appended in constant time.
+        uint8_t         queueDepth;     // The number of packets in rxQueue.
+        bool            eventPending;   // Set when datagrams have been queued but MICROBIT_RADIO_EVT_DATAGRAM is yet to be raised.
+
+        /**
+         * Removes the first packet from the queue.
+         *
+         * @return the packet removed, or NULL if the queue is empty.
+         */
+        FrameBuffer* dequeue();
 
         public:
 
@@ -84,6 +94,31 @@ namespace codal
          */
         PacketBuffer recv();
 
+        /**
+         * Retreives packet payload data into the given buffer, along with the group it was received on.
+         *
+         * This allows datagrams from each of the groups added using MicroBitRadio::addGroup() to be told apart.
+         *
+         * @param group Set to the group the packet was received on, if a packet is available.
+         *
+         * @return the data received, or an empty PacketBuffer if no data is available.
+         */
+        PacketBuffer recvFrom(uint8_t *group);
+
+        /**
+         * Retrieves up to the given number of queued packets in a single operation.
+         *
+         * This allows all of the datagrams received in a burst to be processed from a single
+         * MICROBIT_RADIO_EVT_DATAGRAM event.
+         *
+         * @param out An array of at least 'max' PacketBuffers, into which the received data is stored.
+         *
+         * @param max The maximum number of packets to retrieve.
+         *
+         * @return The number of packets stored in 'out', or MICROBIT_INVALID_PARAMETER if the parameters are invalid.
+         */
+        int recv(PacketBuffer *out, int max);
+
         /**
          * Transmits the given buffer onto the broadcast radio.
          *
@@ -131,6 +166,14 @@ namespace codal
          * This function process this packet, and queues it for user reception.
          */
         void packetReceived();
+
+        /**
+         * Called by the radio once it has finished processing a burst of received packets.
+         *
+         * If MICROBIT_RADIO_DATAGRAM_BATCH_EVENTS is enabled, a single MICROBIT_RADIO_EVT_DATAGRAM
+         * event is raised here for all the datagrams queued during that burst.
+         */
+        void packetsProcessed();
     };
 }
 
@@ -47,6 +47,7 @@ namespace codal
     class MicroBitRadioEvent
     {
         bool            suppressForwarding;     // A private flag used to prevent event forwarding loops.
+        int             groupFilter;            // The group events are accepted from, or MICROBIT_RADIO_GROUP_ANY.
         MicroBitRadio   &radio;                 // A reference to the underlying radio module to use.
 
         public:
@@ -125,6 +126,18 @@ namespace codal
          */
         int ignore(uint16_t id, uint16_t value, EventModel &eventBus);
 
+        /**
+         * Restricts the events raised from the radio to those received on the given group.
+         *
+         * When listening to several groups via MicroBitRadio::addGroup(), this allows events to be
+         * taken from one group while the others are used for datagrams.
+         *
+         * @param group The group to accept events from, or MICROBIT_RADIO_GROUP_ANY (the default) to accept events from all groups.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the group is out of range.
+         */
+        int setGroupFilter(int group);
+
         /**
          * Protocol handler callback. This is called when the radio receives a packet marked as using the event protocol.
          *
@@ -0,0 +1,174 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef MICROBIT_RADIO_LARGE_DATAGRAM_H
+#define MICROBIT_RADIO_LARGE_DATAGRAM_H
+
+#include "CodalConfig.h"
+#include "MicroBitRadio.h"
+#include "ManagedBuffer.h"
+#include "PacketBuffer.h"
+
+#define MICROBIT_RADIO_FRAGMENT_HEADER_SIZE     11
+#define MICROBIT_RADIO_FRAGMENT_DATA_SIZE       (MICROBIT_RADIO_MAX_PACKET_SIZE - MICROBIT_RADIO_FRAGMENT_HEADER_SIZE)
+#define MICROBIT_RADIO_FRAGMENT_MAX_COUNT       255
+
+#if MICROBIT_RADIO_MAX_PACKET_SIZE <= MICROBIT_RADIO_FRAGMENT_HEADER_SIZE
+    #error "MICROBIT_RADIO_MAX_PACKET_SIZE is too small to carry fragmented datagrams"
+#endif
+
+#if MICROBIT_RADIO_FRAGMENT_MAX_SIZE > MICROBIT_RADIO_FRAGMENT_MAX_COUNT * MICROBIT_RADIO_FRAGMENT_DATA_SIZE || MICROBIT_RADIO_FRAGMENT_MAX_SIZE > 0xFFFF
+    #error "MICROBIT_RADIO_FRAGMENT_MAX_SIZE is too large for the configured MICROBIT_RADIO_MAX_PACKET_SIZE"
+#endif
+
+namespace codal
+{
+    /**
+     * Header carried at the start of the payload of every MICROBIT_RADIO_PROTOCOL_FRAGMENT frame.
+     */
+    struct MicroBitRadioFragmentHeader
+    {
+        uint32_t        source;                 // Serial number of the sending micro:bit, used to separate concurrent senders.
+        uint16_t        length;                 // Total length of the datagram being sent, in bytes.
+        uint16_t        offset;                 // Offset of this fragment's data within the datagram, in bytes.
+        uint8_t         messageId;              // Identifies the datagram this fragment belongs to, for this sender.
+        uint8_t         index;                  // Index of this fragment, in the range 0..count-1.
+        uint8_t         count;                  // Total number of fragments in the datagram.
+    } __attribute__((packed));
+
+    /**
+     * A datagram that is being reassembled from its fragments.
+     */
+    struct MicroBitRadioReassembly
+    {
+        ManagedBuffer   data;                   // The datagram being reassembled. Empty if this slot is not in use.
+        uint32_t        source;                 // Serial number of the sending micro:bit.
+        uint32_t        lastActivity;           // Time at which the last fragment was received, in milliseconds.
+        uint8_t         messageId;              // The messageId of the datagram being reassembled.
+        uint8_t         remaining;              // Number of fragments still to be received. Zero once the datagram is complete and awaiting recv().
+        uint8_t         received[32];           // Bitmask of the fragments received so far, used to discard duplicates.
+    };
+
+    /**
+     * Provides datagrams larger than a single radio frame, built upon the MicroBitRadio.
+     *
+     * Datagrams of up to MICROBIT_RADIO_FRAGMENT_MAX_SIZE bytes are split into sequenced frames using the
+     * MICROBIT_RADIO_PROTOCOL_FRAGMENT protocol, and reassembled by the receiver. Reassembly uses a bounded number of
+     * buffers, and incomplete datagrams are discarded after MICROBIT_RADIO_FRAGMENT_TIMEOUT milliseconds of inactivity.
+     * As with MicroBitRadioDatagram, delivery is not guaranteed: if any fragment is lost, the whole datagram is lost.
+     *
+     * @note This API does not contain any form of encryption, authentication or authorisation. Its purpose is solely for use as a
+     * teaching aid to demonstrate how simple communications operates, and to provide a sandpit through which learning can take place.
+     * For serious applications, BLE should be considered a substantially more secure alternative.
+     */
+    class MicroBitRadioLargeDatagram
+    {
+        MicroBitRadio           &radio;                                     // The underlying radio module used to send and receive data.
+        MicroBitRadioReassembly *reassembly;                                // Datagrams being reassembled, or complete and awaiting recv(). Allocated when the radio is first enabled.
+        uint8_t                 messageId;                                  // The messageId to use for the next datagram we send.
+
+        /**
+         * Finds the reassembly slot for the given datagram, allocating one if necessary.
+         * Incomplete datagrams that have timed out, or that have been superseded by a newer datagram
+         * from the same sender, are released as a side effect.
+         *
+         * @param header The header of a fragment of the datagram.
+         *
+         * @return The slot to use, or NULL if the datagram cannot be accepted.
+         */
+        MicroBitRadioReassembly* getReassembly(MicroBitRadioFragmentHeader *header);
+
+        public:
+
+        /**
+         * Constructor.
+         *
+         * Creates an instance of a MicroBitRadioLargeDatagram which offers the ability
+         * to broadcast binary messages larger than a single radio frame to other micro:bits in the vicinity.
+         *
+         * @param r The underlying radio module used to send and receive data.
+         */
+        MicroBitRadioLargeDatagram(MicroBitRadio &r);
+
+        /**
+         * Allocates the reassembly slots. This is called by MicroBitRadio::enable(), so that no memory
+         * is used unless the radio is.
+         *
+         * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if the memory could not be allocated.
+         */
+        int enable();
+
+        /**
+         * Retrieves the next complete datagram, if one is available.
+         *
+         * @return the data received, or an empty ManagedBuffer if no data is available.
+         */
+        ManagedBuffer recv();
+
+        /**
+         * Transmits the given buffer onto the broadcast radio, split into as many frames as necessary.
+         *
+         * This is a synchronous call that will wait until the transmission of all the frames
+         * has completed before returning.
+         *
+         * @param buffer The datagram contents to transmit.
+         *
+         * @param len The number of bytes to transmit.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the buffer is invalid,
+         *         or the number of bytes to transmit is greater than `MICROBIT_RADIO_FRAGMENT_MAX_SIZE`.
+         */
+        int send(uint8_t *buffer, int len);
+
+        /**
+         * Transmits the given buffer onto the broadcast radio, split into as many frames as necessary.
+         *
+         * @param data The datagram contents to transmit.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the buffer is invalid,
+         *         or the number of bytes to transmit is greater than `MICROBIT_RADIO_FRAGMENT_MAX_SIZE`.
+         */
+        int send(ManagedBuffer data);
+
+        /**
+         * Transmits the given buffer onto the broadcast radio, split into as many frames as necessary.
+         *
+         * @param data The datagram contents to transmit.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if the buffer is invalid,
+         *         or the number of bytes to transmit is greater than `MICROBIT_RADIO_FRAGMENT_MAX_SIZE`.
+         */
+        int send(PacketBuffer data);
+
+        /**
+         * Protocol handler callback. This is called when the radio receives a packet marked as a fragment.
+         *
+         * This function adds the fragment to its datagram, and queues the datagram for user reception once complete.
+         */
+        void packetReceived();
+    };
+}
+
+#endif
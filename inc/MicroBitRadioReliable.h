@@ -0,0 +1,246 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef MICROBIT_RADIO_RELIABLE_H
+#define MICROBIT_RADIO_RELIABLE_H
+
+#include "CodalConfig.h"
+#include "MicroBitRadio.h"
+#include "PacketBuffer.h"
+#include "ManagedString.h"
+
+#define MICROBIT_RADIO_RELIABLE_HEADER_SIZE     11
+#define MICROBIT_RADIO_RELIABLE_MAX_PAYLOAD     (MICROBIT_RADIO_MAX_PACKET_SIZE - MICROBIT_RADIO_RELIABLE_HEADER_SIZE)
+#define MICROBIT_RADIO_RELIABLE_WINDOW          32
+
+// Frame types
+#define MICROBIT_RADIO_RELIABLE_TYPE_DATA       1
+#define MICROBIT_RADIO_RELIABLE_TYPE_ACK        2
+
+// Peer flags
+#define MICROBIT_RADIO_PEER_VALID               0x01
+#define MICROBIT_RADIO_PEER_RX_VALID            0x02
+#define MICROBIT_RADIO_PEER_RTT_VALID           0x04
+
+#if MICROBIT_RADIO_MAX_PACKET_SIZE <= MICROBIT_RADIO_RELIABLE_HEADER_SIZE
+    #error "MICROBIT_RADIO_MAX_PACKET_SIZE is too small to carry reliable datagrams"
+#endif
+
+namespace codal
+{
+    /**
+     * Header carried at the start of the payload of every MICROBIT_RADIO_PROTOCOL_RELIABLE frame.
+     */
+    struct MicroBitRadioReliableHeader
+    {
+        uint8_t         type;                   // MICROBIT_RADIO_RELIABLE_TYPE_DATA or MICROBIT_RADIO_RELIABLE_TYPE_ACK.
+        uint32_t        source;                 // Serial number of the sending micro:bit.
+        uint32_t        destination;            // Serial number of the micro:bit this frame is addressed to.
+        uint16_t        sequence;               // Sequence number of the datagram sent, or acknowledged.
+    } __attribute__((packed));
+
+    /**
+     * Delivery statistics for a single peer.
+     */
+    struct MicroBitRadioPeerStatistics
+    {
+        uint32_t        txPackets;              // Number of datagrams sent to this peer.
+        uint32_t        txRetries;              // Number of retransmissions made to this peer.
+        uint32_t        txLost;                 // Number of datagrams sent to this peer that were never acknowledged.
+        uint32_t        rxPackets;              // Number of datagrams received from this peer.
+        uint32_t        rxDuplicates;           // Number of duplicate datagrams received from this peer and suppressed.
+        uint32_t        rtt;                    // Smoothed round trip time to this peer, in microseconds.
+        uint32_t        rto;                    // Current retransmission timeout for this peer, in microseconds.
+    };
+
+    /**
+     * State held for each micro:bit we are exchanging reliable datagrams with.
+     */
+    struct MicroBitRadioPeer
+    {
+        uint32_t        address;                // Serial number of the peer.
+        uint32_t        lastActivity;           // Time at which we last exchanged a frame with this peer, in milliseconds.
+        uint32_t        rttVariance;            // Round trip time variation to this peer, in microseconds.
+        uint32_t        rxWindow;               // Bitmask of recently received sequence numbers. Bit n represents rxSequence - n.
+        uint16_t        txSequence;             // Sequence number to use for the next datagram sent to this peer.
+        uint16_t        rxSequence;             // Highest sequence number received from this peer.
+        uint8_t         flags;                  // MICROBIT_RADIO_PEER_* flags.
+        MicroBitRadioPeerStatistics stats;      // Delivery statistics for this peer.
+    };
+
+    /**
+     * Provides reliable, acknowledged delivery of datagrams between pairs of micro:bits, built upon the MicroBitRadio.
+     *
+     * Each datagram is addressed to a single micro:bit, identified by its serial number, and carries a sequence number.
+     * The receiver acknowledges every datagram immediately, and the sender retransmits it if no acknowledgement arrives
+     * within a timeout adapted to the measured round trip time. Receivers keep a window of recently seen sequence numbers
+     * so that retransmissions are never delivered twice.
+     *
+     * @note This API does not contain any form of encryption, authentication or authorisation. Its purpose is solely for use as a
+     * teaching aid to demonstrate how simple communications operates, and to provide a sandpit through which learning can take place.
+     * For serious applications, BLE should be considered a substantially more secure alternative.
+     */
+    class MicroBitRadioReliable
+    {
+        MicroBitRadio       &radio;                                     // The underlying radio module used to send and receive data.
+        MicroBitRadioPeer   *peers;                                     // The peers we are currently exchanging datagrams with. Allocated when the radio is first enabled.
+        FrameBuffer         *rxQueue;                                   // A linear list of incoming datagrams, queued awaiting processing.
+        FrameBuffer         *rxQueueTail;                               // The last datagram in rxQueue.
+        uint8_t             queueDepth;                                 // The number of datagrams in rxQueue.
+        bool                txBusy;                                     // Set whilst a datagram is awaiting acknowledgement.
+        volatile bool       txAcked;                                    // Set when the datagram awaiting acknowledgement has been acknowledged.
+        uint32_t            txDestination;                              // The destination of the datagram awaiting acknowledgement.
+        uint16_t            txSequence;                                 // The sequence number of the datagram awaiting acknowledgement.
+
+        /**
+         * Finds the state held for the given peer.
+         *
+         * @param address The serial number of the peer.
+         *
+         * @param create If true and the peer is unknown, the least recently used entry is recycled for it.
+         *
+         * @return The peer, or NULL if it is unknown and either create is false or no entry can be recycled.
+         */
+        MicroBitRadioPeer* getPeer(uint32_t address, bool create);
+
+        /**
+         * Updates the round trip time estimate and retransmission timeout of a peer with a new measurement.
+         *
+         * @param peer The peer the measurement was taken for.
+         *
+         * @param rtt The measured round trip time, in microseconds.
+         */
+        void updateRTT(MicroBitRadioPeer *peer, uint32_t rtt);
+
+        /**
+         * Determines whether a datagram has been seen before, recording it in the peer's duplicate detection window.
+         *
+         * @param peer The peer the datagram was received from.
+         *
+         * @param sequence The sequence number of the datagram.
+         *
+         * @return true if the datagram is a duplicate, false otherwise.
+         */
+        bool isDuplicate(MicroBitRadioPeer *peer, uint16_t sequence);
+
+        /**
+         * Transmits a single reliable protocol frame.
+         */
+        int sendFrame(uint8_t type, uint32_t destination, uint16_t sequence, uint8_t *buffer, int len);
+
+        public:
+
+        /**
+         * Constructor.
+         *
+         * Creates an instance of a MicroBitRadioReliable which offers acknowledged delivery of
+         * datagrams to other micro:bits in the vicinity.
+         *
+         * @param r The underlying radio module used to send and receive data.
+         */
+        MicroBitRadioReliable(MicroBitRadio &r);
+
+        /**
+         * Allocates the state held for our peers. This is called by MicroBitRadio::enable(), so that no memory
+         * is used unless the radio is.
+         *
+         * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if the memory could not be allocated.
+         */
+        int enable();
+
+        /**
+         * Retrieves the next datagram received, if one is available.
+         *
+         * @param source If provided, the serial number of the sending micro:bit is stored here.
+         *
+         * @return the data received, or an empty PacketBuffer if no data is available.
+         */
+        PacketBuffer recv(uint32_t *source = NULL);
+
+        /**
+         * Transmits the given buffer to the given micro:bit, and waits for it to be acknowledged.
+         *
+         * The datagram is retransmitted up to MICROBIT_RADIO_RELIABLE_RETRIES times if it is not acknowledged.
+         *
+         * @param destination The serial number of the micro:bit to send to.
+         *
+         * @param buffer The datagram contents to transmit.
+         *
+         * @param len The number of bytes to transmit.
+         *
+         * @return MICROBIT_OK once the datagram has been acknowledged, MICROBIT_INVALID_PARAMETER if the buffer is invalid
+         *         or longer than `MICROBIT_RADIO_RELIABLE_MAX_PAYLOAD`, MICROBIT_BUSY if another reliable send is in progress,
+         *         MICROBIT_NO_RESOURCES if the radio is not enabled, or MICROBIT_NO_DATA if no acknowledgement was received.
+         */
+        int send(uint32_t destination, uint8_t *buffer, int len);
+
+        /**
+         * Transmits the given buffer to the given micro:bit, and waits for it to be acknowledged.
+         *
+         * @param destination The serial number of the micro:bit to send to.
+         *
+         * @param data The datagram contents to transmit.
+         *
+         * @return MICROBIT_OK once the datagram has been acknowledged, MICROBIT_INVALID_PARAMETER if the buffer is invalid
+         *         or longer than `MICROBIT_RADIO_RELIABLE_MAX_PAYLOAD`, MICROBIT_BUSY if another reliable send is in progress,
+         *         MICROBIT_NO_RESOURCES if the radio is not enabled, or MICROBIT_NO_DATA if no acknowledgement was received.
+         */
+        int send(uint32_t destination, PacketBuffer data);
+
+        /**
+         * Transmits the given string to the given micro:bit, and waits for it to be acknowledged.
+         *
+         * @param destination The serial number of the micro:bit to send to.
+         *
+         * @param data The datagram contents to transmit.
+         *
+         * @return MICROBIT_OK once the datagram has been acknowledged, MICROBIT_INVALID_PARAMETER if the buffer is invalid
+         *         or longer than `MICROBIT_RADIO_RELIABLE_MAX_PAYLOAD`, MICROBIT_BUSY if another reliable send is in progress,
+         *         MICROBIT_NO_RESOURCES if the radio is not enabled, or MICROBIT_NO_DATA if no acknowledgement was received.
+         */
+        int send(uint32_t destination, ManagedString data);
+
+        /**
+         * Retrieves the delivery statistics held for the given peer.
+         *
+         * @param address The serial number of the peer.
+         *
+         * @param stats The structure to fill in.
+         *
+         * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if no state is held for the given peer.
+         */
+        int getStatistics(uint32_t address, MicroBitRadioPeerStatistics &stats);
+
+        /**
+         * Protocol handler callback. This is called when the radio receives a packet marked as using the reliable protocol.
+         *
+         * Data frames addressed to this micro:bit are acknowledged and, unless duplicates, queued for user reception.
+         * Acknowledgements complete any send in progress.
+         */
+        void packetReceived();
+    };
+}
+
+#endif
@@ -53,11 +53,42 @@ DEALINGS IN THE SOFTWARE.
 #define MICROBIT_USB_FLASH_MAX_RX_RETRIES           20
 #endif
 
+// The time (in milliseconds) to wait for the interface chip to raise its interrupt line
+// in response to a request, before the request is retransmitted.
+#ifndef MICROBIT_USB_FLASH_RESPONSE_TIMEOUT
+#define MICROBIT_USB_FLASH_RESPONSE_TIMEOUT         MICROBIT_USB_FLASH_MAX_RX_RETRIES
+#endif
+
+// The number of buckets in each transaction latency histogram. Bucket 0 records transactions
+// taking less than 1ms, bucket n those taking [2^(n-1), 2^n) ms, and the last bucket all longer transactions.
+#ifndef MICROBIT_USB_FLASH_LATENCY_BUCKETS
+#define MICROBIT_USB_FLASH_LATENCY_BUCKETS          10
+#endif
+
+// The largest WRITE transfer (in bytes) supported by the interface chip firmware.
+#ifndef MICROBIT_USB_FLASH_MAX_WRITE_LENGTH
+#define MICROBIT_USB_FLASH_MAX_WRITE_LENGTH         64
+#endif
+
+// The range of READ transfer sizes (in bytes) to probe for when determining the capability of the interface chip.
+#ifndef MICROBIT_USB_FLASH_MAX_READ_LENGTH
+#define MICROBIT_USB_FLASH_MAX_READ_LENGTH          1024
+#endif
+
+#ifndef MICROBIT_USB_FLASH_MIN_READ_LENGTH
+#define MICROBIT_USB_FLASH_MIN_READ_LENGTH          64
+#endif
+
 #ifndef MICROBIT_USB_FLASH_MAX_FLASH_STORAGE
 #define MICROBIT_USB_FLASH_MAX_FLASH_STORAGE        0x1F000
 #endif
 
 
+//
+// Length of the address/length header that precedes the data of READ and WRITE requests and responses
+//
+#define MICROBIT_USB_FLASH_HEADER_LENGTH            8
+
 //
 // Command codes for the USB Interface Chip
 //
@@ -74,6 +105,12 @@ DEALINGS IN THE SOFTWARE.
 #define MICROBIT_USB_FLASH_WRITE_CMD                0x0B            // Perform a WRITE operation from applicaiton FLASH memory.
 #define MICROBIT_USB_FLASH_ERASE_CMD                0x0C            // Perform a ERASE operation from applicaiton FLASH memory.
 
+//
+// Events raised by this component
+//
+#define MICROBIT_USB_FLASH_EVT_RESPONSE             1               // The interface chip has raised its interrupt line.
+#define MICROBIT_USB_FLASH_EVT_TIMEOUT              2               // No response was received within the expected time.
+
 namespace codal
 {
 
@@ -90,6 +127,21 @@ typedef struct
     uint8_t             blockCount;                                 // The number of available blocks on the disk
 } MicroBitUSBFlashGeometry;
 
+typedef struct
+{
+    uint8_t             *buffer;                                    // Memory to read into or write from
+    uint32_t            length;                                     // The number of bytes to transfer
+} MicroBitUSBFlashIOVector;
+
+typedef struct
+{
+    uint32_t            count;                                      // The number of transactions completed
+    uint32_t            failures;                                   // The number of transactions that failed after all retries
+    uint32_t            totalTime;                                  // The total time spent in transactions (microseconds)
+    uint32_t            maxTime;                                    // The longest transaction observed (microseconds)
+    uint32_t            histogram[MICROBIT_USB_FLASH_LATENCY_BUCKETS];  // Transaction count by latency (power of two milliseconds)
+} MicroBitUSBFlashLatency;
+
 
 //
 // Component Status flags
@@ -101,6 +153,17 @@ typedef struct
 #define MICROBIT_USB_FLASH_USE_NULL_TRANSACTION     0x10
 #define MICROBIT_USB_FLASH_BUSY_FLAG_SUPPORTED      0x20
 #define MICROBIT_USB_FLASH_100MS_AFTER_ERASE        0x40
+#define MICROBIT_USB_FLASH_IRQ_LISTENING            0x80
+#define MICROBIT_USB_FLASH_IRQ_SHARED               0x100
+
+//
+// Indexes of per command latency statistics
+//
+#define MICROBIT_USB_FLASH_LATENCY_READ             0
+#define MICROBIT_USB_FLASH_LATENCY_WRITE            1
+#define MICROBIT_USB_FLASH_LATENCY_ERASE            2
+#define MICROBIT_USB_FLASH_LATENCY_OTHER            3
+#define MICROBIT_USB_FLASH_LATENCY_COUNT            4
 
 
 /**
@@ -115,6 +178,9 @@ class MicroBitUSBFlashManager : public CodalComponent, public NVMController
         MicroBitUSBFlashConfig      config;                             // Current configuration of the USB File interface
         MicroBitUSBFlashGeometry    geometry;                           // Current geomtry of the USB File interface
         int                         maxWriteLength;                     // The maximum number of bytes that can be written in a single transaction.
+        uint32_t                    maxReadLength;                      // The maximum number of bytes that can be read in a single transaction.
+        CODAL_TIMESTAMP             transactionStart;                   // The time the current transaction began (microseconds).
+        MicroBitUSBFlashLatency     latency[MICROBIT_USB_FLASH_LATENCY_COUNT];  // Latency statistics for each class of command.
 
     public:
         /**
@@ -188,6 +254,18 @@ class MicroBitUSBFlashManager : public CodalComponent, public NVMController
          */ 
         virtual int read(uint32_t* dest, uint32_t address, uint32_t length) override;
 
+        /**
+         * Reads data from consecutive locations in the USB file storage area into a list of buffers.
+         * Data is transferred directly into the given buffers wherever possible.
+         * 
+         * @param address the logical address of the memory to read.
+         * @param iov the buffers to read into, filled in order. The length of each MUST be 32-bit aligned.
+         * @param count the number of buffers in iov.
+         * 
+         * @return DEVICE_OK on success, DEVICE_INVALID_PARAMETER if a buffer is not 32-bit aligned, or DEVICE_NO_DATA on failure.
+         */
+        int readv(uint32_t address, MicroBitUSBFlashIOVector *iov, int count);
+
         /**
          * Writes data to the specified location in the USB file staorage area.
          * 
@@ -209,6 +287,17 @@ class MicroBitUSBFlashManager : public CodalComponent, public NVMController
          */
         int write(ManagedBuffer data, uint32_t address);
 
+        /**
+         * Writes data gathered from a list of buffers to consecutive locations in the USB file storage area.
+         * 
+         * @param address the location to write to. Must be 32 bit aligned.
+         * @param iov the buffers to write, in order. Their total length MUST be 32-bit aligned.
+         * @param count the number of buffers in iov.
+         * 
+         * @return DEVICE_OK on success, DEVICE_INVALID_PARAMETER if the data is not 32-bit aligned, or DEVICE_I2C_ERROR on failure.
+         */
+        int writev(uint32_t address, MicroBitUSBFlashIOVector *iov, int count);
+
         /**
          * Flash Erase one or more physical blocks in the USB file staorage area.
          * n.b. this method will perform an ERASE operation on all physical
@@ -264,6 +353,21 @@ class MicroBitUSBFlashManager : public CodalComponent, public NVMController
          */
         virtual uint32_t getFlashSize() override;
 
+        /**
+         * Provides latency statistics for transactions with the interface chip.
+         * 
+         * @param command The command to report on. MICROBIT_USB_FLASH_READ_CMD, MICROBIT_USB_FLASH_WRITE_CMD and
+         * MICROBIT_USB_FLASH_ERASE_CMD are tracked individually. All other commands are reported together.
+         * 
+         * @return the number, duration and latency histogram of transactions of the given type.
+         */
+        MicroBitUSBFlashLatency getLatencyStatistics(int command);
+
+        /**
+         * Resets all transaction latency statistics to zero.
+         */
+        void resetLatencyStatistics();
+
         /**
          * Destructor.
          */
@@ -278,7 +382,118 @@ class MicroBitUSBFlashManager : public CodalComponent, public NVMController
          * @return a buffer containing the response to the request, or a zero length buffer on failure.
          */
         ManagedBuffer transact(ManagedBuffer request, int responseLength);
-        ManagedBuffer _transact(ManagedBuffer request, int responseLength);
+
+        /**
+         * Performs a flash storage transaction with the interface chip, receiving the response into the given memory.
+         * @param request The data to write to the interface chip as a request operation.
+         * @param requestLength The length of the request, in bytes.
+         * @param response The memory to receive the response into.
+         * @param responseLength The length of the expected reponse packet. Must be at least 3 bytes.
+         * @return DEVICE_OK on success, or DEVICE_I2C_ERROR on failure.
+         */
+        int transact(uint8_t *request, int requestLength, uint8_t *response, int responseLength);
+        int _transact(uint8_t *request, int requestLength, uint8_t *response, int responseLength);
+
+        /**
+         * Begins a flash storage transaction with the interface chip, returning as soon as the request is sent.
+         * The transaction must be completed through a call to completeTransact().
+         * @param request The data to write to the interface chip as a request operation.
+         * @param requestLength The length of the request, in bytes.
+         * @return DEVICE_OK if the request was sent, or DEVICE_I2C_ERROR otherwise.
+         */
+        int beginTransact(uint8_t *request, int requestLength);
+
+        /**
+         * Completes a flash storage transaction started by beginTransact(), retransmitting the request if necessary.
+         * @param request The request given to beginTransact().
+         * @param requestLength The length of the request, in bytes.
+         * @param response The memory to receive the response into.
+         * @param responseLength The length of the expected reponse packet. Must be at least 3 bytes.
+         * @param sent The value returned by beginTransact().
+         * @return DEVICE_OK on success, or DEVICE_I2C_ERROR on failure.
+         */
+        int completeTransact(uint8_t *request, int requestLength, uint8_t *response, int responseLength, int sent);
+
+        /**
+         * Writes a request to the interface chip, without waiting for a response.
+         * @param request The data to write to the interface chip as a request operation.
+         * @param length The length of the request, in bytes.
+         * @return DEVICE_OK on success, or DEVICE_I2C_ERROR if the request could not be sent.
+         */
+        int _send(uint8_t *request, int length);
+
+        /**
+         * Awaits and reads the response to a request previously written with _send().
+         * @param command The command byte of the request that was sent.
+         * @param response The memory to receive the response into.
+         * @param responseLength The length of the expected reponse packet. Must be at least 3 bytes.
+         * @return DEVICE_OK if a valid response was received, or DEVICE_I2C_ERROR otherwise.
+         */
+        int _receive(uint8_t command, uint8_t *response, int responseLength);
+
+        /**
+         * Blocks the calling fiber until the interrupt line from the interface chip is active, or the given deadline passes.
+         * @param deadline The system time (in milliseconds) at which to give up.
+         * @return true if the interrupt line is active, false on timeout.
+         */
+        bool awaitInterrupt(CODAL_TIMESTAMP deadline);
+
+        /**
+         * Releases the interrupt line and power manager once a transaction has finished.
+         */
+        void endTransact();
+
+        /**
+         * Records the latency of a completed transaction.
+         * @param command The command of the completed transaction.
+         * @param success true if a valid response was received, false otherwise.
+         */
+        void recordLatency(uint8_t command, bool success);
+
+        /**
+         * Reads data from the USB file storage area into the given memory, in transfers of up to maxReadLength bytes.
+         * Responses are received directly into the destination, other than those of small reads, which pass via the stack.
+         * 
+         * @param dest the memory to read into.
+         * @param address the logical address of the memory to read.
+         * @param length the number of bytes to read. MUST be 32-bit aligned.
+         * 
+         * @return DEVICE_OK on success, or DEVICE_NO_DATA on failure.
+         */
+        int readDirect(uint8_t *dest, uint32_t address, uint32_t length);
+
+        /**
+         * Performs a single READ transaction with the interface chip.
+         * 
+         * @param response the memory to receive the response into. MUST have space for length + MICROBIT_USB_FLASH_HEADER_LENGTH bytes.
+         * @param address the logical address of the memory to read.
+         * @param length the number of bytes to read.
+         * 
+         * @return DEVICE_OK on success, or DEVICE_I2C_ERROR on failure.
+         */
+        int readChunk(uint8_t *response, uint32_t address, uint32_t length);
+
+        /**
+         * Determines the largest READ transfer supported by the interface chip, by probing it with progressively smaller requests.
+         */
+        void negotiateReadLength();
+
+        /**
+         * Encodes a WRITE request for the next segment of data, gathering it from the given buffers.
+         * @param request The memory to encode into. Must have space for maxWriteLength + MICROBIT_USB_FLASH_HEADER_LENGTH bytes.
+         * @param address The logical address to write to.
+         * @param iov The buffers holding the data to write.
+         * @param index The buffer holding the next byte to write. Updated on return.
+         * @param offset The offset of the next byte to write in that buffer. Updated on return.
+         * @param remaining The number of bytes left to write.
+         * @return the number of bytes of data encoded into the request.
+         */
+        uint32_t prepareWrite(uint8_t *request, uint32_t address, MicroBitUSBFlashIOVector *iov, int &index, uint32_t &offset, uint32_t remaining);
+
+        /**
+         * Interrupt line event handler. Wakes any fiber awaiting a response from the interface chip.
+         */
+        void onInterrupt(Event);
 
         /**
          * Performs a flash storage transaction with the interface chip.
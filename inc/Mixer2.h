@@ -26,6 +26,7 @@ DEALINGS IN THE SOFTWARE.
 #define CODAL_MIXER2_H
 
 #include "DataStream.h"
+#include "AudioBufferPool.h"
 
 #ifndef CONFIG_MIXER_BUFFER_SIZE
 #define CONFIG_MIXER_BUFFER_SIZE 512
@@ -48,6 +49,40 @@ DEALINGS IN THE SOFTWARE.
 #define CONFIG_MIXER_DEFAULT_CHANNEL_SAMPLERATE  44100
 #endif
 
+// Selects the fixed point mixing kernel by default.
+// The floating point kernel is retained as a reference implementation, and may be selected with Mixer2::setFixedPoint().
+#ifndef CONFIG_MIXER_FIXED_POINT
+#define CONFIG_MIXER_FIXED_POINT 1
+#endif
+
+// When enabled, the Mixer measures the CPU cycles taken by each call to pull() using the DWT cycle counter.
+#ifndef CONFIG_MIXER_CYCLE_COUNT
+#define CONFIG_MIXER_CYCLE_COUNT 0
+#endif
+
+// The number of consecutive output buffers a channel may provide no data for before it is put to sleep.
+// Sleeping channels are skipped by the mixer until their next pullRequest(). Set to zero to disable.
+#ifndef CONFIG_MIXER_CHANNEL_SLEEP_BUFFERS
+#define CONFIG_MIXER_CHANNEL_SLEEP_BUFFERS 8
+#endif
+
+// Number of fractional bits held by the fixed point mix accumulator, in units of CONFIG_MIXER_INTERNAL_RANGE.
+#define MIXER_FIXED_FRACTION_BITS 6
+
+// Resampling quality used by a MixerChannel when its sample rate differs from that of the Mixer.
+#define MIXER_RESAMPLE_NEAREST      0
+#define MIXER_RESAMPLE_LINEAR       1
+#define MIXER_RESAMPLE_POLYPHASE    2
+
+// Geometry of the polyphase resampling filter: the number of taps, and log2 of the number of phases.
+#define MIXER_RESAMPLE_TAPS         8
+#define MIXER_RESAMPLE_PHASE_BITS   5
+
+// The resampling quality applied to newly added channels.
+#ifndef CONFIG_MIXER_DEFAULT_RESAMPLE_QUALITY
+#define CONFIG_MIXER_DEFAULT_RESAMPLE_QUALITY MIXER_RESAMPLE_LINEAR
+#endif
+
 #define DEVICE_ID_MIXER 3030
 
 #define DEVICE_MIXER_EVT_SILENCE 1
@@ -73,10 +108,15 @@ private:
     float           gain;                       // Input gain to applied ot each sample to normalise (optimisation)
     float           skip;                       // Number of input samples to progress for each output sample (when sub/super sampling)
     float           position;                   // fractional position within the buffer of next sample (sub/super sampling) 
+    uint32_t        phase;                      // 16.16 fixed point position within the buffer of next sample (fixed point mixing)
 
     float           volume;                     // Volume leve of channel, in the range 0..CONFIG_MIXER_INTERNAL_RANGE
     int             format;                     // Format of the data recieved on this channel (e.g. DATASTREAM_FORMAT_16BIT_UNSIGNED...)
     int             bytesPerSample;             // The number of bytes used in the input stream for each sample (optimisation)
+    int             quality;                    // Resampling quality (e.g. MIXER_RESAMPLE_LINEAR)
+    int16_t         history[MIXER_RESAMPLE_TAPS-1]; // The last samples of the previous buffer, centred on zero (for interpolation)
+    uint16_t        idleBuffers;                // The number of consecutive output buffers this channel has provided no data for
+    bool            asleep;                     // Set if this channel is excluded from the mix until its next pullRequest()
 
     MixerChannel    *next;                      // Internal Linkage - list of all mixer channels
 
@@ -124,13 +164,34 @@ public:
      * @return float 
      */
     float getSampleRate() { return this->rate; }
+
+    /**
+     * @brief Selects the resampling quality used when this channel's sample rate differs from that of the mixer.
+     *
+     * Higher quality reduces aliasing, at the cost of more CPU time per output sample.
+     * Applies to the fixed point mixing kernel only. The floating point reference kernel always uses MIXER_RESAMPLE_NEAREST.
+     *
+     * @param quality One of MIXER_RESAMPLE_NEAREST, MIXER_RESAMPLE_LINEAR or MIXER_RESAMPLE_POLYPHASE.
+     */
+    void setResampleQuality( int quality ) { this->quality = quality; }
+
+    /**
+     * @brief Gets the resampling quality used by this channel.
+     *
+     * @return int One of MIXER_RESAMPLE_NEAREST, MIXER_RESAMPLE_LINEAR or MIXER_RESAMPLE_POLYPHASE.
+     */
+    int getResampleQuality() { return this->quality; }
 };
 
 class Mixer2 : public DataSource
 {
     MixerChannel    *channels;
     DataSink        *downStream;
-    float           mix[CONFIG_MIXER_BUFFER_SIZE];
+    union {
+        float       mix[CONFIG_MIXER_BUFFER_SIZE];
+        int32_t     mixFixed[CONFIG_MIXER_BUFFER_SIZE];
+    };
+    bool            fixedPoint;
     float           outputRange;
     float           outputRate;
     int             outputFormat;
@@ -141,6 +202,9 @@ class Mixer2 : public DataSource
     bool            silent;
     CODAL_TIMESTAMP silenceStartTime;
     CODAL_TIMESTAMP silenceEndTime;
+    uint32_t        pullCycles;
+    AudioBufferPool *pool;
+    ManagedBuffer   silenceBuffer;
 
 public:
     /**
@@ -292,9 +356,80 @@ public:
      */
     CODAL_TIMESTAMP getSilenceEndTime();
 
+    /**
+     * Selects the mixing kernel used by this Mixer.
+     *
+     * The fixed point kernel mixes using integer arithmetic with a fused per-channel gain, and uses
+     * the Cortex-M4 DSP instructions where available. The floating point kernel is the reference implementation.
+     *
+     * @param enable true to use the fixed point kernel, false to use the floating point kernel.
+     * @return DEVICE_OK on success.
+     */
+    int setFixedPoint(bool enable);
+
+    /**
+     * Determines if this Mixer is using its fixed point mixing kernel.
+     * @return true if the fixed point kernel is in use, false if the floating point kernel is in use.
+     */
+    bool isFixedPoint();
+
+    /**
+     * Determines the number of CPU cycles taken by the most recent call to pull().
+     * Only available when CONFIG_MIXER_CYCLE_COUNT is enabled.
+     *
+     * @return the number of CPU cycles, or zero if cycle counting is disabled.
+     */
+    uint32_t getPullCycles();
+
+    /**
+     * Determines if every channel of this Mixer is idle, having provided no data for at least
+     * CONFIG_MIXER_CHANNEL_SLEEP_BUFFERS consecutive output buffers.
+     *
+     * @return true if the mixer is idle, false otherwise. Always false if CONFIG_MIXER_CHANNEL_SLEEP_BUFFERS is zero.
+     */
+    bool isIdle();
+
+    /**
+     * Wakes every channel of this Mixer, so that each is polled for data again.
+     * Typically used when the downstream component resumes after being stopped.
+     */
+    void wake();
 
     private:
     void configureChannel(MixerChannel *c);
+
+    /**
+     * Mix a section of a channel's current input buffer into the fixed point accumulator.
+     *
+     * @param ch The channel to mix.
+     * @param out The first accumulator sample to mix into.
+     * @param len The number of output samples to generate.
+     */
+    void mixChannelFixed(MixerChannel *ch, int32_t *out, int len);
+
+    /**
+     * Update the interpolation history of a channel from its current input buffer.
+     *
+     * @param ch The channel to update.
+     * @param prime If true, fill the history with the first sample of the buffer (used when a stream starts).
+     * Otherwise, record the final samples of the buffer before it is replaced.
+     */
+    void saveHistory(MixerChannel *ch, bool prime);
+
+    /**
+     * Provide a buffer of silence in the current output format, creating and caching it if necessary.
+     * The cached buffer is shared by successive calls, and is discarded whenever the output configuration changes.
+     *
+     * @return A buffer containing the silence level, packed for output.
+     */
+    ManagedBuffer getSilenceBuffer();
+
+    /**
+     * Scale, clamp and pack the fixed point accumulator into an output buffer.
+     *
+     * @param output The buffer to fill.
+     */
+    void packFixed(ManagedBuffer &output);
 };
 
 } // namespace codal
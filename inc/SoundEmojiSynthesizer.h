@@ -26,14 +26,14 @@ DEALINGS IN THE SOFTWARE.
 #define SOUND_EMOJI_SYNTHESIZER_H
 
 #include "DataStream.h"
+#include "AudioBufferPool.h"
+#include "WavetableOscillator.h"
 
 #ifndef CONFIG_EMOJI_SYNTHESIZER_OUTPUT_BUFFER_DEPTH
 #define CONFIG_EMOJI_SYNTHESIZER_OUTPUT_BUFFER_DEPTH  3
 #endif
 
 #define EMOJI_SYNTHESIZER_SAMPLE_RATE         44100
-#define EMOJI_SYNTHESIZER_TONE_WIDTH          1024
-#define EMOJI_SYNTHESIZER_TONE_WIDTH_F        1024.0f
 #define EMOJI_SYNTHESIZER_BUFFER_SIZE         512
 
 #define EMOJI_SYNTHESIZER_TONE_EFFECT_PARAMETERS        2
@@ -82,22 +82,12 @@ namespace codal
 {
 
     /**
-     * Tone Generator and Effect function prototypes
+     * Tone Effect function prototype
      */
     class SoundEmojiSynthesizer;
     typedef struct ToneEffect ToneEffect;
-    typedef uint16_t (*TonePrintFunction)(void *arg, int position);
     typedef void     (*ToneEffectFunction)(SoundEmojiSynthesizer *synth, ToneEffect *context);
 
-    /**
-     * Definition of a parameterised Toneprint (e.g.SquareWave, SinWave etc)
-     */
-    typedef struct
-    {
-        TonePrintFunction       tonePrint;
-        void *                  parameter;
-    } TonePrint;
-
     /**
      * Definition of a parameterised Tone Effect (e.g. vibrato, chromatic interpolator etc)
      */
@@ -141,6 +131,7 @@ namespace codal
         ManagedBuffer           emptyBuffer;            // Zero length buffer.
         SoundEffect*            effect;                 // The effect within the current EffectBuffer that's being generated.
         uint16_t*               partialBuffer;          // Reference to a position within a DMA buffer, if a SFX completed mid buffer.
+        AudioBufferPool*        pool;                   // The pool from which playout buffers are recycled.
 
         int                     sampleRate;             // The sample rate of our output, measure in samples per second (e.g. 44000).
         float                   sampleRange;            // The maximum sample value that can be output.
@@ -152,7 +143,7 @@ namespace codal
         float                   volume;                 // The instantaneous volume currently being generated within an effect.
         int                     samplesToWrite;         // The number of samples needed from the current sound effect block.
         int                     samplesWritten;         // The number of samples written from the current sound effect block.
-        float                   position;               // Position within the tonePrint.
+        WavetableOscillator     oscillator;             // Renders the TonePrint of the current effect.
         float                   samplesPerStep[EMOJI_SYNTHESIZER_TONE_EFFECTS];     // The number of samples to render per step for each effect.
         /**
           * Default Constructor.
@@ -0,0 +1,132 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef WAVETABLE_OSCILLATOR_H
+#define WAVETABLE_OSCILLATOR_H
+
+#include "CodalConfig.h"
+
+#define EMOJI_SYNTHESIZER_TONE_WIDTH          1024
+#define EMOJI_SYNTHESIZER_TONE_WIDTH_F        1024.0f
+#define EMOJI_SYNTHESIZER_TONE_WIDTH_BITS     10
+
+// The number of samples held in each oscillator wavetable, as a power of two (e.g. 7 -> 128 samples).
+// Output is linearly interpolated between samples, so smaller tables only widen the smoothing applied to discontinuities
+// (such as the edges of a square wave). Each additional bit doubles the RAM used by the wavetables.
+#ifndef CONFIG_EMOJI_SYNTHESIZER_WAVETABLE_BITS
+#define CONFIG_EMOJI_SYNTHESIZER_WAVETABLE_BITS         7
+#endif
+
+#define EMOJI_SYNTHESIZER_WAVETABLE_SIZE                (1 << CONFIG_EMOJI_SYNTHESIZER_WAVETABLE_BITS)
+
+// The number of built in TonePrints rendered from a wavetable (sine, sawtooth, triangle and square).
+#define EMOJI_SYNTHESIZER_WAVETABLES                    4
+
+namespace codal
+{
+    /**
+     * Tone Generator function prototype
+     */
+    typedef uint16_t (*TonePrintFunction)(void *arg, int position);
+
+    /**
+     * Definition of a parameterised Toneprint (e.g.SquareWave, SinWave etc)
+     */
+    typedef struct
+    {
+        TonePrintFunction       tonePrint;
+        void *                  parameter;
+    } TonePrint;
+
+    /**
+     * A wavetable oscillator, used to render TonePrints (e.g. SineTone, SquareWaveTone, NoiseTone) efficiently.
+     *
+     * One cycle of each periodic built in TonePrint is sampled into a wavetable, shared by all oscillators, when the
+     * first oscillator is created. Blocks of samples are then rendered using a 0.32 fixed point phase accumulator,
+     * linear interpolation between adjacent table entries and fixed point gain, so the per sample cost is the same
+     * regardless of the waveform in use. Any other TonePrint (such as NoiseTone) is rendered sample by sample.
+     */
+    class WavetableOscillator
+    {
+        static uint16_t         tables[EMOJI_SYNTHESIZER_WAVETABLES][EMOJI_SYNTHESIZER_WAVETABLE_SIZE + 1];  // One cycle of each built in TonePrint, followed by its first sample.
+        static bool             tablesReady;                                // Set once the wavetables have been sampled.
+
+        const uint16_t          *table;                                     // The wavetable of the current TonePrint, or NULL if it has none.
+        TonePrint               tone;                                       // The current TonePrint.
+        uint32_t                phase;                                      // Position within the cycle, as a 0.32 fixed point fraction.
+        uint32_t                step;                                       // Phase increment per output sample.
+        int32_t                 gain;                                       // 16.16 fixed point gain applied to each sample.
+        int32_t                 offset;                                     // 16.16 fixed point offset applied to each sample.
+        uint16_t                orMask;                                     // A bitmask that is logically OR'd with each output sample.
+
+        /**
+         * Sample one cycle of each built in TonePrint into the shared wavetables.
+         */
+        static void buildTables();
+
+        public:
+
+        /**
+         * Constructor.
+         * Creates an oscillator generating silence, until a TonePrint is loaded.
+         */
+        WavetableOscillator();
+
+        /**
+         * Select the TonePrint to render.
+         * The phase of the oscillator is retained, so waveforms can be changed without discontinuity.
+         *
+         * @param tone The TonePrint to render.
+         */
+        void load(TonePrint &tone);
+
+        /**
+         * Define the frequency to generate.
+         *
+         * @param frequency The frequency to generate, in Hz.
+         * @param sampleRate The sample rate of the output, in samples per second.
+         */
+        void setFrequency(float frequency, float sampleRate);
+
+        /**
+         * Define the scaling applied to each sample. Each output sample is computed as (tone * gain) + offset, OR'd with the given mask.
+         *
+         * @param gain The gain to apply to TonePrint samples.
+         * @param offset The offset to apply after scaling.
+         * @param orMask A bitmask that is logically OR'd with each output sample.
+         */
+        void setLevel(float gain, float offset, uint16_t orMask);
+
+        /**
+         * Render a block of samples.
+         *
+         * @param out The buffer to write samples into.
+         * @param n The number of samples to write.
+         */
+        void renderBlock(uint16_t *out, int n);
+    };
+}
+
+#endif
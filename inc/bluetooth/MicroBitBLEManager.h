@@ -205,6 +205,13 @@ class MicroBitBLEManager : public CodalComponent
      */
     bool getConnected();
 
+    /**
+     * Determine the ATT MTU negotiated with the given connection
+     * @param connection The connection handle
+     * @return the effective ATT MTU, in bytes. Notifications may carry up to this size less 3 bytes.
+     */
+    uint16_t getMTU(uint16_t connection);
+
 #if CONFIG_ENABLED(MICROBIT_BLE_EDDYSTONE_URL)
     /**
       * Set the content of Eddystone URL frames
@@ -52,7 +52,7 @@ class MicroBitUtilityWorkspace;
  * Provides simple BLE request/response
  * See MicroBitUtilityTypes.h
  */
-class MicroBitUtilityService : public MicroBitBLEService
+class MicroBitUtilityService : public MicroBitBLEService, public MicroBitLogSink
 {
     static MicroBitUtilityService *shared;
     
@@ -118,11 +118,14 @@ class MicroBitUtilityService : public MicroBitBLEService
     MicroBitLog         &log;
 
     uint8_t characteristicValue[ 20];
+    uint8_t streamValue[ MICROBIT_BLE_UTILITY_STREAM_CHUNK];
+    uint16_t streamChunk;
 
     // Index for each charactersitic in arrays of handles and UUIDs
     typedef enum mbbs_cIdx
     {
         mbbs_cIdxCTRL,
+        mbbs_cIdxSTREAM,
         mbbs_cIdxCOUNT
     } mbbs_cIdx;
     
@@ -172,6 +175,21 @@ class MicroBitUtilityService : public MicroBitBLEService
      * @return DEVICE_OK if finished
      */
     int processLogRead();
+
+    /**
+     * Process request typeLogStream
+     * @return DEVICE_OK if finished
+     */
+    int processLogStream();
+
+    /**
+     * Callback. Invoked by MicroBitLog::exportData() with the next region of log data to stream.
+     * Sends the data as notifications of the stream characteristic, as far as the BLE stack will accept them.
+     * @param data Data to send
+     * @param len Length of the data
+     * @return The number of bytes sent
+     */
+    int writeData( const uint8_t *data, uint32_t len) override;
 };
 
 } // namespace codal
@@ -58,6 +58,15 @@ DEALINGS IN THE SOFTWARE.
  *              length    (4 bytes)         - length of whole file, from request type 1 (Log file length)
  * reply        data      (up to 19 bytes)  - 1 or more reply packets, to total batchlen bytes
  *
+ * type 3     - Log file stream
+ * request      format    (1 byte)          - 0 = HTML header; 1 = HTML; 2 = CSV
+ *              reserved  (1 byte)          - set to zero
+ *              index     (4 bytes)         - unsigned integer index into file
+ * stream       data      (up to MTU - 3)   - notifications on the stream characteristic, carrying the file from index onwards
+ * reply        length    (4 bytes)         - unsigned number of bytes streamed, sent once the stream is complete
+ *
+ * The stream is paced by the BLE stack, and stops early if a new request is written.
+ *
  */
 namespace codal::MicroBitUtility
 {
@@ -65,7 +74,8 @@ namespace codal::MicroBitUtility
     {
         requestTypeNone,
         requestTypeLogLength,           // reply data = 4 bytes log data length
-        requestTypeLogRead              // reply data = up to 19 bytes of log data
+        requestTypeLogRead,             // reply data = up to 19 bytes of log data
+        requestTypeLogStream            // stream data = up to MTU - 3 bytes of log data per notification, reply data = 4 bytes length streamed
     } requestType_t;
 
     typedef struct request_t
@@ -106,6 +116,15 @@ namespace codal::MicroBitUtility
         uint32_t batchlen;              // size in bytes to return
         uint32_t length;                // length of whole file, from requestTypeLogLength
     } requestLogRead_t;
+
+    typedef struct requestLogStream_t
+    {
+        uint8_t  job;
+        uint8_t  type;                  // requestType_t
+        uint8_t  format;                // requestLogFormat
+        uint8_t  reserved;              // set to zero
+        uint32_t index;                 // index into data
+    } requestLogStream_t;
     
     const uint8_t jobLowMAX = 0x0E;
     const uint8_t jobLowERR = 0x0F;     // reply data = 4 bytes signed integer error
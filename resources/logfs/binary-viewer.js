@@ -0,0 +1,118 @@
+/**
+ * Renders the records of a binary log as CSV text, so that MY_DATA.HTM shows
+ * a binary log exactly as it does a text log.
+ *
+ * MicroBitLog stores this script, minified, at the start of the data of every
+ * binary log. See MicroBitLog.h for the record format. The record holding the
+ * script ends the HTML comment holding the log and opens another, so the page
+ * sees the log as two comments either side of this script.
+ *
+ * Once the page has been parsed, and before the header's scripts read the log,
+ * the records are rendered and the two comments joined back together as a text
+ * log. Offsets in the metadata are adjusted for the change in length.
+ */
+(function () {
+  let d = document;
+  let script = d.currentScript;
+
+  d.addEventListener("readystatechange", function render() {
+    d.removeEventListener("readystatechange", render);
+
+    let log = script.previousSibling;
+    let records = script.nextSibling;
+    let data = records.data;
+    let csv = "";
+    let time = 0;
+    let types = [];
+    // Skip the newline ending this script's record.
+    let i = 1;
+    let c;
+
+    // Read a varint. Continuation digits skip the characters excluded from records.
+    let varint = function () {
+      let v = 0;
+      let p = 1;
+      while ((c = data.charCodeAt(i++)) < 64) {
+        v += (c - 1 - (c > 13) - (c > 33) - (c > 45) - (c > 62)) * p;
+        p *= 59;
+      }
+      return v + (c - 64) * p;
+    };
+
+    // Read text of the given length in bytes. The page holds it as UTF-16.
+    let text = function (n) {
+      let start = i;
+      while (n > 0) {
+        c = data.charCodeAt(i++);
+        n -= c < 128 ? 1 : c < 2048 || c >> 11 == 27 ? 2 : 3;
+      }
+      return data.slice(start, i);
+    };
+
+    // Read and render a value of the given type.
+    let value = function (type) {
+      if (!type) {
+        return "";
+      }
+      if (type == 10) {
+        return text(varint());
+      }
+      let n = varint();
+      let places = type - 1;
+      n = n % 2 ? -(n + 1) / 2 : n / 2;
+      if (type > 10) {
+        time = type > 12 ? n : time + n;
+        n = time;
+        places = ((type - 11) % 2) * 2;
+      }
+      let digits = String(Math.abs(n)).padStart(places + 1, "0");
+      return (
+        (n < 0 ? "-" : "") +
+        (places ? digits.slice(0, -places) + "." + digits.slice(-places) : digits)
+      );
+    };
+
+    // Render records up to the first byte of unused memory.
+    while (i < data.length && data.charCodeAt(i) != 0xfffd) {
+      let tag = data.charCodeAt(i++);
+      if (tag == 84) {
+        // TEXT
+        csv += text(varint());
+      } else {
+        // ROW, or REPEAT using the columns of the last ROW.
+        let row = [];
+        let columns = types.length;
+        if (tag == 82) {
+          columns = varint();
+          types = [];
+        }
+        for (let k = 0; k < columns; k++) {
+          if (tag == 82) {
+            types[k] = varint();
+          }
+          row.push(value(types[k]));
+        }
+        csv += row.join(",") + "\n";
+      }
+    }
+
+    // The first comment holds "FS_START" and the metadata, with the version
+    // at 8 and logEnd at 26. This script's record is 24 characters longer
+    // than the script itself.
+    let meta = log.data;
+    let logEnd =
+      parseInt(meta.substr(26, 10), 16) +
+      csv.length -
+      (script.text.length + 24 + i);
+    log.data =
+      meta.slice(0, 20) +
+      "V" +
+      meta.slice(21, 28) +
+      ("0000000" + logEnd.toString(16)).slice(-8) +
+      meta.slice(36) +
+      csv +
+      data.slice(i);
+    script.remove();
+    records.remove();
+  });
+})();
@@ -94,6 +94,46 @@ const main = (mode) => {
   }
 };
 
+/**
+ * Minifies the script stored at the start of binary logs into the VIEWER record.
+ *
+ * The record ends the HTML comment holding the log, and opens another to hold
+ * the binary records. MicroBitLog finds the end of the record by its newline.
+ */
+const viewer = () => {
+  const inputFile = "binary-viewer.js";
+  const input = fs.readFileSync(inputFile, { encoding: "ascii" });
+  const script = minify(`<script>${input}</script>`, {
+    collapseWhitespace: true,
+    minifyJS: true,
+    removeComments: true,
+  });
+  const result = `-->${script}<!--\n`;
+  const body = script.slice("<script>".length, -"</script>".length);
+
+  if (/[\n\r]|<!--|-->|<\/script/i.test(body) || /[^\x00-\x7f]/.test(body)) {
+    throw new Error(`Minified ${inputFile} cannot be stored in a log.`);
+  }
+  console.log(`${result.length} bytes for ${inputFile}`);
+
+  if (process.argv[2] !== "test") {
+    const cppFile = "../../source/MicroBitLog.cpp";
+    const cppContents = fs.readFileSync(cppFile, {
+      encoding: "utf-8",
+    });
+    const arrayContents = Array.from(result)
+      .map((c) => "0x" + c.charCodeAt(0).toString(16))
+      .join(",");
+    const viewerRegExp = /(MicroBitLog::viewer\[\] = \/\*viewer\*\/)\{[^}]*\}/;
+    if (!viewerRegExp.test(cppContents)) {
+      throw new Error(`Could not find viewer. Review changes to ${cppFile}.`);
+    }
+    const replaced = cppContents.replace(viewerRegExp, `$1{${arrayContents}}`);
+    fs.writeFileSync(cppFile, replaced, { encoding: "utf-8" });
+  }
+};
+
 for (const mode of ["default", "basic", "nextgen"]) {
   main(mode);
 }
+viewer();
@@ -0,0 +1,178 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "AudioBufferPool.h"
+
+using namespace codal;
+
+AudioBufferPool *AudioBufferPool::pools = NULL;
+
+/**
+ * Constructor.
+ * Creates an empty pool. Buffers are created on demand, up to CONFIG_AUDIO_BUFFER_POOL_SIZE.
+ *
+ * @param bufferSize The size of each buffer in the pool, in bytes.
+ */
+AudioBufferPool::AudioBufferPool(int bufferSize)
+{
+    this->bufferSize = bufferSize;
+    this->allocated = 0;
+    this->highWaterMark = 0;
+    this->misses = 0;
+    this->next = NULL;
+}
+
+/**
+ * Retrieve the shared pool for the given buffer size, creating it if necessary.
+ *
+ * @param bufferSize The size of the buffers required, in bytes.
+ * @return The shared pool, or NULL if bufferSize is invalid or memory is exhausted.
+ */
+AudioBufferPool* AudioBufferPool::get(int bufferSize)
+{
+    if (bufferSize <= 0)
+        return NULL;
+
+    for (AudioBufferPool *p = pools; p; p = p->next)
+        if (p->bufferSize == bufferSize)
+            return p;
+
+    AudioBufferPool *p = new AudioBufferPool(bufferSize);
+
+    if (p)
+    {
+        p->next = pools;
+        pools = p;
+    }
+
+    return p;
+}
+
+/**
+ * Determine if the given pool buffer is referenced only by the pool.
+ */
+bool AudioBufferPool::isFree(ManagedBuffer &b)
+{
+    // RefCounted holds the reference count in its upper 15 bits, with the lowest bit always set.
+    // A value of 3 therefore indicates a single reference: the one held by the pool.
+    return b.getBufferData()->refCount == 3;
+}
+
+/**
+ * Provide a buffer from the pool. The contents of the buffer are undefined, and should be fully overwritten.
+ * If every pooled buffer is in use, a new buffer is allocated from the heap.
+ *
+ * @return A buffer of getBufferSize() bytes.
+ */
+ManagedBuffer AudioBufferPool::allocate()
+{
+    for (int i = 0; i < allocated; i++)
+    {
+        if (isFree(buffers[i]))
+        {
+            // Replace any buffer that has been truncated by a previous user.
+            if (buffers[i].length() != bufferSize)
+                buffers[i] = ManagedBuffer(bufferSize);
+
+            int used = getInUse() + 1;
+
+            if (used > highWaterMark)
+                highWaterMark = used;
+
+            return buffers[i];
+        }
+    }
+
+    // Grow the pool if we can, otherwise fall back to a transient heap allocation.
+    if (allocated < CONFIG_AUDIO_BUFFER_POOL_SIZE)
+    {
+        buffers[allocated++] = ManagedBuffer(bufferSize);
+
+        if (allocated > highWaterMark)
+            highWaterMark = allocated;
+
+        return buffers[allocated-1];
+    }
+
+    misses++;
+    return ManagedBuffer(bufferSize);
+}
+
+/**
+ * Determine the size of the buffers in this pool.
+ *
+ * @return The size of each buffer, in bytes.
+ */
+int AudioBufferPool::getBufferSize()
+{
+    return bufferSize;
+}
+
+/**
+ * Determine how many buffers have been created by this pool.
+ *
+ * @return The number of buffers retained by the pool, including those currently in use.
+ */
+int AudioBufferPool::getAllocated()
+{
+    return allocated;
+}
+
+/**
+ * Determine how many pooled buffers are currently in use.
+ *
+ * @return The number of pooled buffers referenced outside of the pool.
+ */
+int AudioBufferPool::getInUse()
+{
+    int used = 0;
+
+    for (int i = 0; i < allocated; i++)
+        if (!isFree(buffers[i]))
+            used++;
+
+    return used;
+}
+
+/**
+ * Determine the largest number of pooled buffers that have been in use at the same time.
+ *
+ * @return The high water mark of the pool.
+ */
+int AudioBufferPool::getHighWaterMark()
+{
+    return highWaterMark;
+}
+
+/**
+ * Determine how many requests could not be satisfied by the pool, and were allocated from the heap.
+ * A non-zero value suggests CONFIG_AUDIO_BUFFER_POOL_SIZE should be increased.
+ *
+ * @return The number of pool misses.
+ */
+uint32_t AudioBufferPool::getMisses()
+{
+    return misses;
+}
@@ -37,6 +37,13 @@ FSCache::FSCache(NVMController &nvm, int blockSize, int size) : flash(nvm), bloc
 
 	// Reset operation counter (used for least-recently-used cache replacement policy)
 	operationCount = 0;
+
+	writeBack = false;
+	readAhead = 0;
+	readAheadBuffer = NULL;
+	nextBlock = 0xFFFFFFFF;
+	lastEntry = NULL;
+	resetStatistics();
 }
 
 /**
@@ -44,6 +51,8 @@ FSCache::FSCache(NVMController &nvm, int blockSize, int size) : flash(nvm), bloc
 */
 void FSCache::clear()
 {
+	flush();
+
 	for (int i = 0; i < cacheSize; i++)
 	{
 		if (cache[i].page != NULL)
@@ -55,26 +64,136 @@ void FSCache::clear()
 
 	// Reset operation counter (used for least-recently-used cache replacement policy)
 	operationCount = 0;
-
+	nextBlock = 0xFFFFFFFF;
 }
 
 /**
-* Erase a single block at the given address in CACHE memory only, (assuming it is loaded into cache)
+* Erase all blocks within the physical page at the given address in CACHE memory only, (assuming they are loaded into cache)
 */
 int FSCache::erase(uint32_t address)
 {
-	CacheEntry *c = getCacheEntry(address);
+	uint32_t pageSize = flash.getPageSize();
+	uint32_t start = address - (address % pageSize);
 
-	// Erase the page in our cache (if it is present)
-	if (c != NULL)
+	// Erase the blocks in our cache (if present). Any pending write back is now redundant.
+	for (int i = 0; i < cacheSize; i++)
 	{
-		memset(c->page, 0xFF, blockSize);
-		c->lastUsed = ++operationCount;
+		CacheEntry *c = &cache[i];
+
+		if (c->page && c->address >= start && c->address < start + pageSize)
+		{
+			memset(c->page, 0xFF, blockSize);
+			c->flags &= ~FSCACHE_FLAG_DIRTY;
+			c->lastUsed = ++operationCount;
+		}
+	}
+
+	return DEVICE_OK;
+}
+
+/**
+* Selects write-back or write-through (the default) operation.
+* In write-back mode, write() only updates the cache. Modified blocks are written to the backing store when
+* evicted, or when flush() is called. Leaving write-back mode performs a flush().
+*
+* @param enable true to enable write-back mode, false for write-through.
+*/
+void FSCache::setWriteBack(bool enable)
+{
+	if (!enable)
+		flush();
+
+	writeBack = enable;
+}
+
+/**
+* Write all modified blocks to the backing store.
+*
+* @return DEVICE_OK on success, or the error reported by the backing store.
+*/
+int FSCache::flush()
+{
+	int result = DEVICE_OK;
+
+	for (int i = 0; i < cacheSize; i++)
+	{
+		int r = flushEntry(&cache[i]);
+
+		if (r != DEVICE_OK)
+			result = r;
+	}
+
+	return result;
+}
+
+/**
+* Write back the dirty region of the given entry, if any.
+*/
+int FSCache::flushEntry(CacheEntry *c)
+{
+	if (!(c->flags & FSCACHE_FLAG_DIRTY))
+		return DEVICE_OK;
+
+	// Maintain 32-bit aligned operations
+	uint32_t alignedStart = c->dirtyStart & 0xFFFFFFFC;
+	uint32_t alignedEnd = (c->dirtyEnd + 3) & 0xFFFFFFFC;
+
+	c->flags &= ~FSCACHE_FLAG_DIRTY;
+	stats.writeBacks++;
+
+	return flash.write(c->address + alignedStart, (uint32_t *)(c->page + alignedStart), (alignedEnd - alignedStart)/4);
+}
+
+/**
+* Configures sequential read-ahead. When a block is missed immediately after the one preceding it,
+* the following blocks are loaded in the same read of the backing store, ready for streaming readers.
+*
+* @param blocks the number of additional blocks to load, or zero to disable read-ahead (the default).
+*               Limited to one less than the size of the cache.
+*
+* @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if no buffer could be allocated to read the blocks into,
+*         in which case read-ahead is disabled.
+*/
+int FSCache::setReadAhead(int blocks)
+{
+	blocks = max(0, min(blocks, cacheSize - 1));
+
+	if (blocks == readAhead && (blocks == 0 || readAheadBuffer))
+		return DEVICE_OK;
+
+	// The blocks are read into a buffer held for as long as read-ahead is enabled, so page fills need no allocation.
+	free(readAheadBuffer);
+	readAheadBuffer = NULL;
+	readAhead = blocks;
+
+	if (readAhead)
+		readAheadBuffer = (uint8_t *) malloc((readAhead + 1) * blockSize);
+
+	if (readAhead && readAheadBuffer == NULL)
+	{
+		readAhead = 0;
+		return DEVICE_NO_RESOURCES;
 	}
 
 	return DEVICE_OK;
 }
 
+/**
+* Retrieves the hit, miss, eviction and write back counts since the cache was created or the counts reset.
+*/
+FSCacheStatistics FSCache::getStatistics()
+{
+	return stats;
+}
+
+/**
+* Resets the hit, miss, eviction and write back counts to zero.
+*/
+void FSCache::resetStatistics()
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
 /**
 * Read the given area of memory into the buffer provided,
 * paging the data in from FLASH as needed.
@@ -105,7 +224,7 @@ int FSCache::read(uint32_t address, const void *data, int len)
 
 /**
 * Write the given area of memory into the buffer provided, paging the data in from FLASH as needed.
-* Also performs a write-through cache operation directly back if possible. 
+* Also performs a write-through cache operation directly back if possible, unless in write-back mode.
 * @param address The logical address of the non-volatile storage to write to. DOES NOT need to be word aligned.
 * @param data the data to write.
 * @param len amount of data to write, in bytes.
@@ -147,7 +266,7 @@ int FSCache::write(uint32_t address, const void *data, int len)
 
 #endif
 
-	// Write operation is valid. Update cache and perform a write-through operation to FLASH.
+	// Write operation is valid. Update cache and perform a write-through operation to FLASH (or mark the block for write back).
 	bytesCopied = 0;
 	while (bytesCopied < len)
 	{
@@ -165,8 +284,22 @@ int FSCache::write(uint32_t address, const void *data, int len)
 		// update cache.
 		memcpy(c->page + offset, (uint8_t *)data + bytesCopied, l);
 
-		// Write through (maintaining 32-bit aligned operations)
-		flash.write(alignedStart, (uint32_t *)(c->page + (alignedStart % blockSize)), (alignedEnd - alignedStart)/4);
+		if (writeBack)
+		{
+			// Extend the region awaiting write back to include this write.
+			if (!(c->flags & FSCACHE_FLAG_DIRTY) || offset < c->dirtyStart)
+				c->dirtyStart = offset;
+
+			if (!(c->flags & FSCACHE_FLAG_DIRTY) || offset + l > c->dirtyEnd)
+				c->dirtyEnd = offset + l;
+
+			c->flags |= FSCACHE_FLAG_DIRTY;
+		}
+		else
+		{
+			// Write through (maintaining 32-bit aligned operations)
+			flash.write(alignedStart, (uint32_t *)(c->page + (alignedStart % blockSize)), (alignedEnd - alignedStart)/4);
+		}
 
 		// Move to next page
 		bytesCopied += l;
@@ -210,15 +343,53 @@ int FSCache::unpin(uint32_t address)
 */
 CacheEntry* FSCache::cachePage(uint32_t address)
 {
-	CacheEntry *lru = NULL;
-
 	// Ensure the page is not already in the cache. If so, then nothing to do...
-	lru = getCacheEntry(address);
-	if (lru)
-		return lru;
+	CacheEntry *c = getCacheEntry(address);
+	if (c)
+	{
+		stats.hits++;
+		return c;
+	}
+
+	stats.misses++;
+
+	// If this block follows the last one loaded, assume a sequential reader and load the blocks following it too,
+	// up to the first that is already cached.
+	int blocks = 1;
+	if (address == nextBlock)
+	{
+		while (blocks <= readAhead && address + (blocks + 1) * blockSize <= flash.getFlashEnd() && findEntry(address + blocks * blockSize) == NULL)
+			blocks++;
+	}
+
+	nextBlock = address + blocks * blockSize;
 
+	// Read all the blocks in one operation, to save on transaction overheads.
+	if (blocks > 1)
+		flash.read((uint32_t *)readAheadBuffer, address, blocks * blockSize / 4);
+
+	// Load the requested block last, so that it is the most recently used.
+	for (int i = blocks - 1; i >= 0; i--)
+	{
+		c = allocateEntry(address + i * blockSize);
+
+		if (blocks > 1)
+			memcpy(c->page, readAheadBuffer + i * blockSize, blockSize);
+		else
+			flash.read((uint32_t *)c->page, c->address, blockSize / 4);
+	}
+
+	return c;
+}
+
+/**
+* Choose an entry to hold the given block, writing back and evicting the LRU block if necessary.
+* The contents of the page are not loaded.
+*/
+CacheEntry* FSCache::allocateEntry(uint32_t address)
+{
 	// Determine the LRU block to replace, or prefereably unused block.
-	lru = &cache[0];
+	CacheEntry *lru = &cache[0];
 	for (int i = 0; i < cacheSize; i++)
 	{
 		// Simply return the first empty block we find
@@ -228,21 +399,25 @@ CacheEntry* FSCache::cachePage(uint32_t address)
 			break;
 		}
 
-		// Alternatively, record the least recently used block
-		if (!(cache[i].flags & FSCACHE_FLAG_PINNED) && (operationCount - cache[i].lastUsed > operationCount - lru->lastUsed))
+		// Alternatively, record the least recently used block.
+		// Ages are calculated with unsigned arithmetic, so remain correct when operationCount wraps around.
+		if (!(cache[i].flags & FSCACHE_FLAG_PINNED) && (uint32_t)(operationCount - cache[i].lastUsed) > (uint32_t)(operationCount - lru->lastUsed))
 			lru = &cache[i];
 	}
 
-	// We now have the best block to replace. Update metadata and load in the block from storage.
-	// We are a write through cache, so all old values are soft state.
+	// We now have the best block to replace. Write back any modifications before reusing it.
+	if (lru->page)
+	{
+		flushEntry(lru);
+		stats.evictions++;
+	}
+
 	lru->address = address;
 	lru->flags = 0;
 	lru->lastUsed = ++operationCount;
 	if (lru->page == NULL)
 		lru->page = (uint8_t *) malloc(blockSize);
 
-	flash.read((uint32_t *)lru->page, address, blockSize / 4);
-
 	return lru;
 }
 
@@ -253,11 +428,28 @@ CacheEntry* FSCache::cachePage(uint32_t address)
 */
 CacheEntry *FSCache::getCacheEntry(uint32_t address)
 {
+	CacheEntry *c = findEntry(address);
+
+	if (c)
+		c->lastUsed = ++operationCount;
+
+	return c;
+}
+
+/**
+* Locate the given block in the cache, without affecting its LRU state.
+*/
+CacheEntry *FSCache::findEntry(uint32_t address)
+{
+	// Accesses are typically clustered, so check the block found last time first.
+	if (lastEntry && lastEntry->address == address && lastEntry->page)
+		return lastEntry;
+
 	for (int i = 0; i < cacheSize; i++)
 	{
 		if (cache[i].address == address && cache[i].page)
 		{
-			cache[i].lastUsed = ++operationCount;
+			lastEntry = &cache[i];
 			return &cache[i];
 		}
 	}
@@ -58,6 +58,9 @@ MicroBitAudio::MicroBitAudio(NRF52Pin &pin, NRF52Pin &speaker, NRF52ADC &adc, NR
     // Request a periodic callback
     status |= DEVICE_COMPONENT_STATUS_SYSTEM_TICK;
 
+    if (CONFIG_AUDIO_STOP_PWM_WHEN_IDLE)
+        status |= MICROBIT_AUDIO_STATUS_STOP_WHEN_IDLE;
+
     synth.allowEmptyBuffers(true);
 
     mic = adc.getChannel(microphone, false);
@@ -108,6 +111,24 @@ void MicroBitAudio::periodicCallback()
         //DMESG("MicroBitAudio::periodicCallback: deactivateMic()...");
         deactivateMic();
     }
+
+    // Stop the PWM while there is nothing to play, and restart it as soon as a channel is re-armed.
+    if (pwm && (status & MICROBIT_AUDIO_STATUS_STOP_WHEN_IDLE))
+    {
+        bool idle = mixer.isIdle();
+
+        if (idle && !(status & MICROBIT_AUDIO_STATUS_PWM_STOPPED))
+        {
+            status |= MICROBIT_AUDIO_STATUS_PWM_STOPPED;
+            pwm->disable();
+        }
+
+        if (!idle && (status & MICROBIT_AUDIO_STATUS_PWM_STOPPED))
+        {
+            status &= ~MICROBIT_AUDIO_STATUS_PWM_STOPPED;
+            pwm->enable();
+        }
+    }
 }
 
 void MicroBitAudio::activateMic(){
@@ -144,6 +165,14 @@ int MicroBitAudio::enable()
         if ( soundExpressionChannel == NULL )
             soundExpressionChannel = mixer.addChannel(synth);
     }
+    else if (status & MICROBIT_AUDIO_STATUS_PWM_STOPPED)
+    {
+        // Restart output that was stopped while idle. Waking the mixer gives every channel
+        // a grace period to deliver data before it can be considered idle again.
+        status &= ~MICROBIT_AUDIO_STATUS_PWM_STOPPED;
+        mixer.wake();
+        pwm->enable();
+    }
     return DEVICE_OK;
 }
 
@@ -153,6 +182,7 @@ int MicroBitAudio::disable()
     setPinEnabled( false );
 
     pwm->disable();
+    status &= ~MICROBIT_AUDIO_STATUS_PWM_STOPPED;
 
     return DEVICE_OK;
 }
@@ -246,6 +276,7 @@ int MicroBitAudio::setSleep(bool doSleep)
           pwm->disconnectPin(*pin);
           delete pwm;
           pwm = NULL;
+          status &= ~MICROBIT_AUDIO_STATUS_PWM_STOPPED;
       }
       this->micSleepState = this->micEnabled;
       deactivateMic();
@@ -264,6 +295,25 @@ int MicroBitAudio::setSleep(bool doSleep)
     return DEVICE_OK;
 }
 
+void MicroBitAudio::setStopWhenIdle(bool enable)
+{
+    if (enable)
+    {
+        status |= MICROBIT_AUDIO_STATUS_STOP_WHEN_IDLE;
+    }
+    else
+    {
+        status &= ~MICROBIT_AUDIO_STATUS_STOP_WHEN_IDLE;
+
+        if (pwm && (status & MICROBIT_AUDIO_STATUS_PWM_STOPPED))
+        {
+            status &= ~MICROBIT_AUDIO_STATUS_PWM_STOPPED;
+            mixer.wake();
+            pwm->enable();
+        }
+    }
+}
+
 bool MicroBitAudio::isPlaying()
 {
     uint32_t t = system_timer_current_time_us();
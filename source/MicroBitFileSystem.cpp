@@ -28,8 +28,47 @@ DEALINGS IN THE SOFTWARE.
 
 using namespace codal;
 
+#define MBFS_BLOCKS_PER_PAGE    (MICROBIT_CODEPAGESIZE / MBFS_BLOCK_SIZE)
+
 static uint32_t *defaultScratchPage = (uint32_t *)MICROBIT_DEFAULT_SCRATCH_PAGE;
 
+/**
+  * Determines if the given region of FLASH memory is erased.
+  *
+  * @param address The start of the region.
+  * @param words The length of the region, in 32 bit words.
+  * @return true if every word of the region is erased, false otherwise.
+  */
+static bool isErased(uint32_t *address, int words)
+{
+    while (words--)
+        if (*address++ != 0xFFFFFFFF)
+            return false;
+
+    return true;
+}
+
+/**
+  * Calculate the directory index hash of a filename.
+  *
+  * @param directory The directory holding the file.
+  * @param name The filename. At most MBFS_FILENAME_LENGTH characters are considered.
+  * @return A hash of the filename and directory.
+  */
+static uint32_t hashFilename(const DirectoryEntry *directory, char const *name)
+{
+    // FNV-1a, seeded with the address of the parent directory.
+    uint32_t hash = 2166136261UL ^ (uint32_t)directory;
+
+    for (int i = 0; i < MBFS_FILENAME_LENGTH && name[i]; i++)
+    {
+        hash ^= (uint8_t)name[i];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
 MicroBitFileSystem* MicroBitFileSystem::defaultFileSystem = NULL;
 
 /**
@@ -44,6 +83,10 @@ uint16_t MicroBitFileSystem::getFreeBlock()
     uint16_t block;
     uint16_t deletedBlock = 0;
 
+    // In log-structured mode, take the next erased block from the RAM bitmap instead.
+    if (status & MBFS_STATUS_LOG_STRUCTURED)
+        return getFreeLogBlock();
+
     for (block = (lastBlockAllocated + 1) % fileSystemSize; block != lastBlockAllocated; block++)
     {
         if (fileSystemTable[block] == MBFS_UNUSED)
@@ -73,6 +116,50 @@ uint16_t MicroBitFileSystem::getFreeBlock()
     return block;
 }
 
+/**
+  * Allocate a free logical block from the RAM free block bitmap, in round robin order.
+  * Deferred garbage collection is only run if no erased blocks remain.
+  * @return a valid, erased and unused block number on success, or zero if no space is available.
+  */
+uint16_t MicroBitFileSystem::getFreeLogBlock()
+{
+    int words = (fileSystemSize + 31) / 32;
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        if (freeBlockCount)
+        {
+            int start = (lastBlockAllocated + 1) % fileSystemSize;
+
+            // Walk the bitmap a word at a time, starting immediately after the last block allocated.
+            // The first word is visited twice: masked to the blocks at or after the start, then in full once we wrap.
+            for (int i = 0; i <= words; i++)
+            {
+                int word = (start / 32 + i) % words;
+                uint32_t bits = freeBlockMap[word];
+
+                if (i == 0)
+                    bits &= 0xFFFFFFFF << (start % 32);
+
+                if (bits)
+                {
+                    uint16_t block = word * 32 + __builtin_ctz(bits);
+
+                    setBlockFree(block, false);
+                    lastBlockAllocated = block;
+                    return block;
+                }
+            }
+        }
+
+        // No erased blocks are left, so garbage collection can be deferred no longer.
+        if (attempt == 0)
+            gc();
+    }
+
+    return 0;
+}
+
 /**
   * Allocates a free physical page of memory.
   * This is chosen using a round robin algorithm, to even out the wear on the physical device.
@@ -88,6 +175,32 @@ uint32_t* MicroBitFileSystem::getFreePage()
     uint16_t page = (currentPage + blocksPerPage) % fileSystemSize;
     uint16_t recyclablePage = 0;
 
+    // In log-structured mode, use the least worn page that is entirely erased and unallocated.
+    // Its blocks are withheld from allocation until the page is returned via updatePageState().
+    if (status & MBFS_STATUS_LOG_STRUCTURED)
+    {
+        int best = -1;
+
+        for (int p = 0; p < fileSystemSize / blocksPerPage; p++)
+        {
+            bool free = true;
+
+            for (int i = 0; i < blocksPerPage && free; i++)
+                free = isBlockFree(p * blocksPerPage + i);
+
+            if (free && (best < 0 || eraseCount[p] < eraseCount[best]))
+                best = p;
+        }
+
+        if (best >= 0)
+        {
+            for (int i = 0; i < blocksPerPage; i++)
+                setBlockFree(best * blocksPerPage + i, false);
+
+            return getBlock(best * blocksPerPage);
+        }
+    }
+
     // Walk around the file table, looking for a free page.
     while (page != currentPage)
     {
@@ -113,6 +226,14 @@ uint32_t* MicroBitFileSystem::getFreePage()
         if (empty)
         {
             lastBlockAllocated = page;
+
+            // Pages holding deleted blocks may not yet have been erased. In log-structured mode, ensure they are.
+            if ((status & MBFS_STATUS_LOG_STRUCTURED) && !isErased(getBlock(page), MICROBIT_CODEPAGESIZE / 4))
+            {
+                flash.erase_page(getBlock(page));
+                recordErase(getBlock(page));
+            }
+
             return getBlock(page);
         }
 
@@ -128,6 +249,7 @@ uint32_t* MicroBitFileSystem::getFreePage()
     {
         uint32_t *address = getBlock(recyclablePage);
         flash.erase_page(address);
+        recordErase(address);
         return address;
     }
 
@@ -180,6 +302,14 @@ int MicroBitFileSystem::init(uint32_t flashStart, int flashPages)
     lastBlockAllocated = 0;
     rootDirectory = NULL;
     openFiles = NULL;
+    freeBlockMap = NULL;
+    dirtyPageMap = NULL;
+    eraseCount = NULL;
+    freeBlockCount = 0;
+    directoryIndex = NULL;
+
+    for (int i = 0; i < MBFS_PATH_CACHE_SIZE; i++)
+        pathCache[i].path = NULL;
 
     // If we have a zero length, then dynamically determine our geometry.
     if (flashStart == 0)
@@ -212,6 +342,10 @@ int MicroBitFileSystem::init(uint32_t flashStart, int flashPages)
 
     // indicate that we have a valid FileSystem
     status = MBFS_STATUS_INITIALISED;
+
+    if (MBFS_LOG_STRUCTURED)
+        setLogStructured(true);
+
     return MICROBIT_OK;
 }
 
@@ -240,6 +374,9 @@ int MicroBitFileSystem::load()
     fileSystemSize = root->length;
     fileSystemTableSize = calculateFileTableSize();
 
+    // Index the directory tree, so that files can be found without scanning FLASH.
+    buildDirectoryIndex();
+
     return MICROBIT_OK;
 }
 
@@ -274,6 +411,8 @@ int MicroBitFileSystem::format()
     rootDirectory = (DirectoryEntry *)getBlock(fileSystemTableSize);
     flash.flash_write(rootDirectory, &magic, sizeof(DirectoryEntry));
 
+    buildDirectoryIndex();
+
     return MICROBIT_OK;
 }
 
@@ -302,6 +441,13 @@ DirectoryEntry* MicroBitFileSystem::getDirectoryEntry(char const * filename, con
     if (directory == NULL)
         directory = rootDirectory;
 
+    // If the directory index is available, it holds every valid entry.
+    if (directoryIndex)
+    {
+        DirectoryIndexEntry *e = indexFind(directory, file);
+        return e ? e->dirent : NULL;
+    }
+
     block = directory->first_block;
     dir = (Directory *) getBlock(block);
     dirent = &dir->entry[0];
@@ -330,6 +476,181 @@ DirectoryEntry* MicroBitFileSystem::getDirectoryEntry(char const * filename, con
     return NULL;
 }
 
+/**
+  * Build the directory index, by walking every directory from the root.
+  * If there is insufficient RAM, the index is discarded and directories are searched in FLASH instead.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_NO_RESOURCES if the index could not be built.
+  */
+int MicroBitFileSystem::buildDirectoryIndex()
+{
+    freeDirectoryIndex();
+
+    if (MBFS_INDEX_BUCKETS == 0)
+        return MICROBIT_NO_RESOURCES;
+
+    directoryIndex = (DirectoryIndexEntry **) malloc(sizeof(DirectoryIndexEntry *) * MBFS_INDEX_BUCKETS);
+    if (directoryIndex == NULL)
+        return MICROBIT_NO_RESOURCES;
+
+    memset(directoryIndex, 0, sizeof(DirectoryIndexEntry *) * MBFS_INDEX_BUCKETS);
+
+    return indexDirectory(rootDirectory);
+}
+
+/**
+  * Add all entries of the given directory, and any subdirectories, to the directory index.
+  *
+  * @param directory The directory to index.
+  * @return MICROBIT_OK on success, or MICROBIT_NO_RESOURCES if there is insufficient RAM.
+  */
+int MicroBitFileSystem::indexDirectory(DirectoryEntry *directory)
+{
+    uint16_t block = directory->first_block;
+
+    while (block != MBFS_EOF)
+    {
+        DirectoryEntry *dirent = (DirectoryEntry *)getBlock(block);
+
+        for (uint16_t entry = 0; entry < MBFS_BLOCK_SIZE / sizeof(DirectoryEntry); entry++)
+        {
+            // Index valid entries, including new files whose flags are yet to be written.
+            // Unused entries have erased filenames, and the root directory entry holds our MAGIC signature.
+            if (dirent != rootDirectory && (dirent->flags & MBFS_DIRECTORY_ENTRY_VALID) && (uint8_t)dirent->file_name[0] != 0xFF)
+            {
+                if (indexInsert(directory, dirent) != MICROBIT_OK)
+                    return MICROBIT_NO_RESOURCES;
+
+                if ((dirent->flags & (MBFS_DIRECTORY_ENTRY_FREE | MBFS_DIRECTORY_ENTRY_DIRECTORY)) == MBFS_DIRECTORY_ENTRY_DIRECTORY)
+                    if (indexDirectory(dirent) != MICROBIT_OK)
+                        return MICROBIT_NO_RESOURCES;
+            }
+
+            dirent++;
+        }
+
+        block = getNextFileBlock(block);
+    }
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Add a DirectoryEntry to the directory index.
+  * If there is insufficient RAM, the index is discarded.
+  *
+  * @param directory The directory holding the entry.
+  * @param dirent The entry to add.
+  * @return MICROBIT_OK on success, or MICROBIT_NO_RESOURCES if there is insufficient RAM.
+  */
+int MicroBitFileSystem::indexInsert(DirectoryEntry *directory, DirectoryEntry *dirent)
+{
+    if (directoryIndex == NULL)
+        return MICROBIT_NO_RESOURCES;
+
+    DirectoryIndexEntry *e = new DirectoryIndexEntry;
+
+    // An incomplete index is worse than none at all, as lookups would miss files.
+    if (e == NULL)
+    {
+        freeDirectoryIndex();
+        return MICROBIT_NO_RESOURCES;
+    }
+
+    e->hash = hashFilename(directory, dirent->file_name);
+    e->dirent = dirent;
+    e->directory = directory;
+    e->next = directoryIndex[e->hash % MBFS_INDEX_BUCKETS];
+
+    directoryIndex[e->hash % MBFS_INDEX_BUCKETS] = e;
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Find the index entry for the given filename.
+  *
+  * @param directory The directory to search.
+  * @param name The filename, with any path removed.
+  * @return The DirectoryIndexEntry for the file, or NULL if no entry is found.
+  */
+DirectoryIndexEntry* MicroBitFileSystem::indexFind(const DirectoryEntry *directory, char const *name)
+{
+    uint32_t hash = hashFilename(directory, name);
+
+    for (DirectoryIndexEntry *e = directoryIndex[hash % MBFS_INDEX_BUCKETS]; e; e = e->next)
+        if (e->hash == hash && e->directory == directory && strncmp(e->dirent->file_name, name, MBFS_FILENAME_LENGTH) == 0)
+            return e;
+
+    return NULL;
+}
+
+/**
+  * Replace a DirectoryEntry in the directory index with another of the same name, or remove it.
+  *
+  * @param directory The directory holding the entry.
+  * @param dirent The entry to replace.
+  * @param replacement The new entry, or NULL to remove the entry from the index.
+  */
+void MicroBitFileSystem::indexReplace(DirectoryEntry *directory, DirectoryEntry *dirent, DirectoryEntry *replacement)
+{
+    if (directoryIndex == NULL)
+        return;
+
+    DirectoryIndexEntry **e = &directoryIndex[hashFilename(directory, dirent->file_name) % MBFS_INDEX_BUCKETS];
+
+    while (*e && (*e)->dirent != dirent)
+        e = &(*e)->next;
+
+    if (*e == NULL)
+        return;
+
+    if (replacement)
+    {
+        (*e)->dirent = replacement;
+    }
+    else
+    {
+        DirectoryIndexEntry *removed = *e;
+        *e = removed->next;
+        delete removed;
+    }
+}
+
+/**
+  * Release all memory held by the directory index.
+  */
+void MicroBitFileSystem::freeDirectoryIndex()
+{
+    if (directoryIndex == NULL)
+        return;
+
+    for (int i = 0; i < MBFS_INDEX_BUCKETS; i++)
+    {
+        while (directoryIndex[i])
+        {
+            DirectoryIndexEntry *e = directoryIndex[i];
+            directoryIndex[i] = e->next;
+            delete e;
+        }
+    }
+
+    free(directoryIndex);
+    directoryIndex = NULL;
+}
+
+/**
+  * Release all entries in the directory path cache.
+  */
+void MicroBitFileSystem::clearPathCache()
+{
+    for (int i = 0; i < MBFS_PATH_CACHE_SIZE; i++)
+    {
+        free(pathCache[i].path);
+        pathCache[i].path = NULL;
+    }
+}
+
 /**
   * Determine the number of logical blocks required to hold the file table.
   *
@@ -403,6 +724,10 @@ uint16_t MicroBitFileSystem::getBlockNumber(void *address)
 int MicroBitFileSystem::fileTableWrite(uint16_t block, uint16_t value)
 {
     flash.flash_write(&fileSystemTable[block], &value, 2);
+
+    if (value != MBFS_UNUSED)
+        setBlockFree(block, false);
+
     return MICROBIT_OK;
 }
 
@@ -427,6 +752,25 @@ DirectoryEntry* MicroBitFileSystem::getDirectoryOf(char const * filename)
 
     uint8_t i = 0;
 
+    // Determine the length of the directory part of the path, and see if we have resolved it recently.
+    char const *path = filename;
+    char const *last = strrchr(filename, '/');
+    int length = last ? last - filename : 0;
+
+    for (int c = 0; c < MBFS_PATH_CACHE_SIZE && length; c++)
+    {
+        DirectoryPathCacheEntry hit = pathCache[c];
+
+        if (hit.path && strncmp(hit.path, path, length) == 0 && hit.path[length] == 0)
+        {
+            // Move the entry to the front of the cache.
+            memmove(&pathCache[1], &pathCache[0], c * sizeof(DirectoryPathCacheEntry));
+            pathCache[0] = hit;
+
+            return hit.directory;
+        }
+    }
+
     directory = rootDirectory;
 
     while (*filename != '\0') {
@@ -452,6 +796,24 @@ DirectoryEntry* MicroBitFileSystem::getDirectoryOf(char const * filename)
         filename++;
     }
 
+    // Cache the resolved directory, evicting the least recently used entry.
+    if (length && MBFS_PATH_CACHE_SIZE)
+    {
+        char *p = (char *) malloc(length + 1);
+
+        if (p)
+        {
+            memcpy(p, path, length);
+            p[length] = 0;
+
+            free(pathCache[MBFS_PATH_CACHE_SIZE - 1].path);
+            memmove(&pathCache[1], &pathCache[0], (MBFS_PATH_CACHE_SIZE - 1) * sizeof(DirectoryPathCacheEntry));
+
+            pathCache[0].path = p;
+            pathCache[0].directory = directory;
+        }
+    }
+
     return directory;
 }
 
@@ -510,9 +872,10 @@ int MicroBitFileSystem::recycleBlock(uint16_t block, int type)
             }
         }
 
-        // Copy all other VALID blocks directly into the scratch page.
+        // Copy all other VALID blocks directly into the (erased) scratch page.
+        // These are queued, and consecutive blocks are programmed as a single operation.
         else
-            flash.flash_write(write, getBlock(b), MBFS_BLOCK_SIZE);
+            flash.flash_burn_async((uint32_t *)write, getBlock(b), MBFS_BLOCK_SIZE / 4);
         
         // move on to next block.
         write += MBFS_BLOCK_SIZE;
@@ -520,9 +883,17 @@ int MicroBitFileSystem::recycleBlock(uint16_t block, int type)
     }
 
     // Now refresh the page originally holding the block.
-    flash.erase_page(page);
-    flash.flash_write(page, scratch, MICROBIT_CODEPAGESIZE);
-    flash.erase_page(scratch);
+    flash.erase_page_async(page);
+    flash.flash_burn_async(page, scratch, MICROBIT_CODEPAGESIZE / 4);
+    flash.erase_page_async(scratch);
+    flash.wait();
+
+    recordErase(page);
+    recordErase(scratch);
+
+    // Both pages are now clean. Return any erased, unallocated blocks to the free pool.
+    updatePageState(page);
+    updatePageState(scratch);
 
     return MICROBIT_OK;
 }
@@ -554,9 +925,297 @@ int MicroBitFileSystem::recycleFileTable()
     for (uint16_t block = 0; getPage(block) < (uint32_t *)rootDirectory; block += MICROBIT_CODEPAGESIZE / MBFS_BLOCK_SIZE)
         recycleBlock(block);
 
+    // Blocks across the whole file system may now be UNUSED, so rebuild the free block bitmap.
+    buildAllocationMap();
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Compact the given directory and any subdirectories, recycling the blocks of
+  * any directory entries that have been deleted.
+  *
+  * @param directory The directory to compact.
+  */
+void MicroBitFileSystem::gcDirectory(DirectoryEntry *directory)
+{
+    uint16_t block = directory->first_block;
+
+    while (block != MBFS_EOF)
+    {
+        DirectoryEntry *dirent = (DirectoryEntry *)getBlock(block);
+        bool deleted = false;
+
+        for (uint16_t entry = 0; entry < MBFS_BLOCK_SIZE / sizeof(DirectoryEntry); entry++)
+        {
+            if ((dirent->flags & MBFS_DIRECTORY_ENTRY_VALID) == 0)
+                deleted = true;
+
+            // Recurse into valid subdirectories. Unwritten entries have every flag set, so test for them explicitly.
+            else if ((dirent->flags & (MBFS_DIRECTORY_ENTRY_FREE | MBFS_DIRECTORY_ENTRY_DIRECTORY)) == MBFS_DIRECTORY_ENTRY_DIRECTORY)
+                gcDirectory(dirent);
+
+            dirent++;
+        }
+
+        // Recycling preserves the location of all valid entries, so open files are unaffected.
+        if (deleted)
+            recycleBlock(block, MBFS_BLOCK_TYPE_DIRECTORY);
+
+        block = getNextFileBlock(block);
+    }
+}
+
+/**
+  * Performs garbage collection. Compacts directories, erases pages left dirty by overwrites
+  * and returns all deleted blocks to the free pool. This may erase several FLASH pages.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_NOT_SUPPORTED if the file system has not been initialised.
+  */
+int MicroBitFileSystem::gc()
+{
+    if ((status & MBFS_STATUS_INITIALISED) == 0)
+        return MICROBIT_NOT_SUPPORTED;
+
+    // Reclaim directory entries invalidated by flush() and remove().
+    gcDirectory(rootDirectory);
+
+    // Erase any pages holding unallocated blocks that have been used as scratch space.
+    if (dirtyPageMap)
+    {
+        for (int p = 0; p < fileSystemSize / MBFS_BLOCKS_PER_PAGE; p++)
+        {
+            if ((dirtyPageMap[p / 32] & (1UL << (p % 32))) == 0)
+                continue;
+
+            uint16_t block = p * MBFS_BLOCKS_PER_PAGE;
+            bool inUse = false;
+
+            for (int i = 0; i < MBFS_BLOCKS_PER_PAGE; i++)
+                if (fileSystemTable[block + i] != MBFS_UNUSED && fileSystemTable[block + i] != MBFS_DELETED)
+                    inUse = true;
+
+            if (inUse)
+            {
+                recycleBlock(block);
+            }
+            else
+            {
+                flash.erase_page(getBlock(block));
+                recordErase(getBlock(block));
+                updatePageState(getBlock(block));
+            }
+        }
+    }
+
+    // Finally, return any blocks marked as DELETED to the free pool.
+    for (uint16_t block = 0; block < fileSystemSize; block++)
+        if (fileSystemTable[block] == MBFS_DELETED)
+            return recycleFileTable();
+
     return MICROBIT_OK;
 }
 
+/**
+  * Enables or disables log-structured allocation.
+  *
+  * @param enable true to enable log-structured mode, false to revert to in-place recycling.
+  * @return MICROBIT_OK on success, MICROBIT_NOT_SUPPORTED if the file system has not been initialised,
+  *         or MICROBIT_NO_RESOURCES if there is insufficient RAM.
+  */
+int MicroBitFileSystem::setLogStructured(bool enable)
+{
+    if ((status & MBFS_STATUS_INITIALISED) == 0)
+        return MICROBIT_NOT_SUPPORTED;
+
+    if (enable && !(status & MBFS_STATUS_LOG_STRUCTURED))
+    {
+        int pages = fileSystemSize / MBFS_BLOCKS_PER_PAGE;
+        int blockMapSize = ((fileSystemSize + 31) / 32) * sizeof(uint32_t);
+        int pageMapSize = ((pages + 31) / 32) * sizeof(uint32_t);
+
+        freeBlockMap = (uint32_t *) malloc(blockMapSize);
+        dirtyPageMap = (uint32_t *) malloc(pageMapSize);
+        eraseCount = (uint16_t *) malloc(pages * sizeof(uint16_t));
+
+        if (freeBlockMap == NULL || dirtyPageMap == NULL || eraseCount == NULL)
+        {
+            setLogStructured(false);
+            return MICROBIT_NO_RESOURCES;
+        }
+
+        memset(freeBlockMap, 0, blockMapSize);
+        memset(eraseCount, 0, pages * sizeof(uint16_t));
+        freeBlockCount = 0;
+
+        status |= MBFS_STATUS_LOG_STRUCTURED;
+        buildAllocationMap();
+    }
+
+    if (!enable)
+    {
+        free(freeBlockMap);
+        free(dirtyPageMap);
+        free(eraseCount);
+
+        freeBlockMap = NULL;
+        dirtyPageMap = NULL;
+        eraseCount = NULL;
+        freeBlockCount = 0;
+
+        status &= ~MBFS_STATUS_LOG_STRUCTURED;
+    }
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Determines the number of times a physical page of the file system has been erased since power on.
+  *
+  * @param page The index of the page, from the start of the file system.
+  * @return The number of erase operations, MICROBIT_NOT_SUPPORTED if not in log-structured mode,
+  *         or MICROBIT_INVALID_PARAMETER if the page is out of range.
+  */
+int MicroBitFileSystem::getEraseCount(int page)
+{
+    if (eraseCount == NULL)
+        return MICROBIT_NOT_SUPPORTED;
+
+    if (page < 0 || page >= fileSystemSize / MBFS_BLOCKS_PER_PAGE)
+        return MICROBIT_INVALID_PARAMETER;
+
+    return eraseCount[page];
+}
+
+/**
+  * Determine if the given block is erased and available for allocation.
+  * Only valid in log-structured mode.
+  *
+  * @param block A valid block number.
+  * @return true if the block is marked in the free block bitmap, false otherwise.
+  */
+bool MicroBitFileSystem::isBlockFree(uint16_t block)
+{
+    return freeBlockMap && (freeBlockMap[block / 32] & (1UL << (block % 32)));
+}
+
+/**
+  * Mark the given block as available (or unavailable) in the free block bitmap.
+  *
+  * @param block A valid block number.
+  * @param free true if the block is erased and may be allocated, false otherwise.
+  */
+void MicroBitFileSystem::setBlockFree(uint16_t block, bool free)
+{
+    if (freeBlockMap == NULL || isBlockFree(block) == free)
+        return;
+
+    freeBlockMap[block / 32] ^= 1UL << (block % 32);
+
+    if (free)
+        freeBlockCount++;
+    else
+        freeBlockCount--;
+}
+
+/**
+  * Determine the index of the physical page within the file system holding the given address.
+  *
+  * @param address A memory location.
+  * @return The page index, or -1 if the address lies outside the file system.
+  */
+int MicroBitFileSystem::getPageIndex(void *address)
+{
+    if ((uint32_t)address < (uint32_t)fileSystemTable || (uint32_t)address >= (uint32_t)getBlock(fileSystemSize))
+        return -1;
+
+    return getBlockNumber(address) / MBFS_BLOCKS_PER_PAGE;
+}
+
+/**
+  * Record that the given physical page has been erased.
+  *
+  * @param page The address of the page.
+  */
+void MicroBitFileSystem::recordErase(uint32_t *page)
+{
+    int p = getPageIndex(page);
+
+    if (eraseCount && p >= 0 && eraseCount[p] < 0xFFFF)
+        eraseCount[p]++;
+}
+
+/**
+  * Recalculate the free block bitmap and dirty state of the given physical page,
+  * from the file table and the contents of FLASH memory.
+  *
+  * @param page The address of the page. Pages outside the file system are ignored.
+  */
+void MicroBitFileSystem::updatePageState(uint32_t *page)
+{
+    int p = getPageIndex(page);
+    bool dirty = false;
+
+    if (dirtyPageMap == NULL || p < 0)
+        return;
+
+    uint16_t block = p * MBFS_BLOCKS_PER_PAGE;
+
+    for (int i = 0; i < MBFS_BLOCKS_PER_PAGE; i++)
+    {
+        bool free = false;
+
+        // An UNUSED block may still hold data if its page was used as scratch space, so check it really is erased.
+        if (fileSystemTable[block] == MBFS_UNUSED)
+        {
+            free = isErased(getBlock(block), MBFS_BLOCK_SIZE / 4);
+            dirty |= !free;
+        }
+
+        setBlockFree(block, free);
+        block++;
+    }
+
+    if (dirty)
+        dirtyPageMap[p / 32] |= 1UL << (p % 32);
+    else
+        dirtyPageMap[p / 32] &= ~(1UL << (p % 32));
+}
+
+/**
+  * Return a page obtained from getFreePage() and used as scratch space by flash_write(),
+  * accounting for any erase operations performed.
+  *
+  * @param scratch The scratch page.
+  * @param address The address that was written.
+  */
+void MicroBitFileSystem::releaseScratchPage(uint32_t *scratch, void *address)
+{
+    uint32_t *page = getPage(getBlockNumber(address));
+
+    // flash_write() only leaves data in its scratch page if it had to erase the destination page.
+    if (!isErased(scratch, MICROBIT_CODEPAGESIZE / 4))
+    {
+        recordErase(scratch);
+        recordErase(page);
+    }
+
+    updatePageState(scratch);
+    updatePageState(page);
+}
+
+/**
+  * Rebuild the free block bitmap and dirty page bitmap for the whole file system.
+  */
+void MicroBitFileSystem::buildAllocationMap()
+{
+    if (freeBlockMap == NULL)
+        return;
+
+    for (int p = 0; p < fileSystemSize / MBFS_BLOCKS_PER_PAGE; p++)
+        updatePageState(getBlock(p * MBFS_BLOCKS_PER_PAGE));
+}
+
 
 /**
   * Allocate a free DiretoryEntry in the given directory, extending and refreshing the directory block if necessary.
@@ -618,7 +1277,8 @@ DirectoryEntry* MicroBitFileSystem::createDirectoryEntry(DirectoryEntry *directo
 
     // if not possible, try to re-use a second-hand block that has been freed. This will result in an erase operation of the block,
     // but will not consume any more resources.
-    else if (invalid)
+    // In log-structured mode, prefer extending the directory into an erased block, and leave the erase to gc().
+    else if (invalid && !((status & MBFS_STATUS_LOG_STRUCTURED) && freeBlockCount))
     {
         dirent = invalid;
         uint16_t b = getBlockNumber(dirent);
@@ -699,6 +1359,7 @@ DirectoryEntry* MicroBitFileSystem::createFile(char const * filename, DirectoryE
     // Push the new data back to FLASH memory
     flash.flash_write(dirent, &d, sizeof(DirectoryEntry));
     fileTableWrite(d.first_block, MBFS_EOF);
+    indexInsert(directory, dirent);
     return dirent;
 }
 
@@ -866,6 +1527,8 @@ int MicroBitFileSystem::open(char const * filename, uint32_t flags)
     file->seek = (flags & MB_APPEND) ? file->length : 0;
     file->dirent = dirent;
     file->directory = directory;
+    file->block = dirent->first_block;
+    file->blockStart = 0;
     file->cacheLength = 0;
 
     // Add the file descriptor to the chain of open files.
@@ -932,7 +1595,14 @@ int MicroBitFileSystem::flush(int fd)
             // invalidate the old directory entry and create a new one with the updated data.
             flash.flash_write(&file->dirent->flags, &value, 2);
             newDirent = createDirectoryEntry(file->directory);
+            if (newDirent == NULL)
+                return MICROBIT_NO_RESOURCES;
+
             flash.flash_write(newDirent, &d, sizeof(DirectoryEntry));
+
+            // Track the replacement entry, as the old one may be reclaimed by gc() while the file is still open.
+            indexReplace(file->directory, file->dirent, newDirent);
+            file->dirent = newDirent;
         }
     }
 
@@ -974,6 +1644,10 @@ int MicroBitFileSystem::close(int fd)
     // n.b. we know this is safe, as flush() validates this.
     delete getFileDescriptor(fd, true);
 
+    // In log-structured mode, run deferred garbage collection once erased blocks run low.
+    if ((status & MBFS_STATUS_LOG_STRUCTURED) && freeBlockCount * 100 < fileSystemSize * MBFS_GC_THRESHOLD)
+        gc();
+
     return MICROBIT_OK;
 }
 
@@ -1067,7 +1741,6 @@ int MicroBitFileSystem::read(int fd, uint8_t* buffer, int size)
     uint8_t *writePointer;
 
     uint32_t offset;
-    uint32_t position = 0;
     int bytesCopied = 0;
     int segmentLength;
 
@@ -1087,18 +1760,8 @@ int MicroBitFileSystem::read(int fd, uint8_t* buffer, int size)
     // Validate the read length.
     size = min(size, file->length - file->seek);
 
-    // Find the read position.
-    block = file->dirent->first_block; 
-
-    // Walk the file table until we reach the start block
-    while (file->seek - position > MBFS_BLOCK_SIZE)
-    {
-        block = getNextFileBlock(block);
-        position += MBFS_BLOCK_SIZE;
-    }
-
-    // Once we have the correct start block, handle the byte offset.
-    offset = file->seek - position;
+    // Find the read position, continuing from where any previous access left off.
+    block = getFileBlock(file, file->seek, &offset);
 
     // Now, start copying bytes into the requested buffer.
     writePointer = buffer;
@@ -1119,6 +1782,13 @@ int MicroBitFileSystem::read(int fd, uint8_t* buffer, int size)
         {
             block = getNextFileBlock(block);
             offset = 0;
+
+            // Move the cursor along with us, so sequential reads never need to walk the file table.
+            if (block != MBFS_EOF)
+            {
+                file->block = block;
+                file->blockStart += MBFS_BLOCK_SIZE;
+            }
         }
     }
 
@@ -1127,6 +1797,99 @@ int MicroBitFileSystem::read(int fd, uint8_t* buffer, int size)
     return bytesCopied;
 }
 
+/**
+  * Map data from the file directly from FLASH memory, without copying.
+  *
+  * @param fd File handle, obtained with open()
+  * @param buffer Set to the address of the data in FLASH memory.
+  * @return number of bytes mapped on success (zero at the end of the file), MICROBIT_NOT_SUPPORTED if
+  *         the file system is not initialised, or MICROBIT_INVALID_PARAMETER if the given file handle is invalid.
+  */
+int MicroBitFileSystem::mmap(int fd, const uint8_t **buffer)
+{
+    FileDescriptor *file;
+    uint16_t block;
+    uint32_t offset;
+    uint32_t length;
+
+    // Protect against accidental re-initialisation
+    if ((status & MBFS_STATUS_INITIALISED) == 0)
+        return MICROBIT_NOT_SUPPORTED;
+
+    // Ensure the file is open.
+    file = getFileDescriptor(fd);
+
+    if (file == NULL || buffer == NULL)
+        return MICROBIT_INVALID_PARAMETER;
+
+    // Any cached data must be in FLASH before we can map it.
+    writeBack(file);
+
+    if (file->seek >= file->length)
+        return 0;
+
+    block = getFileBlock(file, file->seek, &offset);
+
+    // If we're at the very end of a block, step onto the next one.
+    if (offset == MBFS_BLOCK_SIZE)
+    {
+        block = getNextFileBlock(block);
+        offset = 0;
+
+        file->block = block;
+        file->blockStart += MBFS_BLOCK_SIZE;
+    }
+
+    *buffer = (const uint8_t *)getBlock(block) + offset;
+    length = MBFS_BLOCK_SIZE - offset;
+
+    // Blocks are often allocated in sequence. Extend the mapping over any that are physically contiguous.
+    while (file->seek + length < file->length && getNextFileBlock(block) == block + 1)
+    {
+        block++;
+        length += MBFS_BLOCK_SIZE;
+    }
+
+    length = min(length, file->length - file->seek);
+    file->seek += length;
+
+    return length;
+}
+
+/**
+  * Locate the block holding the given position in a file, walking the block chain
+  * from the file's cursor where possible, and moving the cursor to the block found.
+  *
+  * A position on a block boundary may be reported as the end of the preceding block
+  * (offset MBFS_BLOCK_SIZE), as the following block may not yet exist.
+  *
+  * @param file FileDescriptor of the file.
+  * @param position The position in the file, in bytes.
+  * @param offset Set to the offset of the position within the returned block.
+  * @return The block number.
+  */
+uint16_t MicroBitFileSystem::getFileBlock(FileDescriptor *file, uint32_t position, uint32_t *offset)
+{
+    // The chain can only be walked forwards, so restart from the beginning of the file if we need to go back.
+    if (file->blockStart > position)
+    {
+        file->block = file->dirent->first_block;
+        file->blockStart = 0;
+    }
+
+    // Walk the file table until we reach the start block
+    while (position - file->blockStart > MBFS_BLOCK_SIZE)
+    {
+        file->block = getNextFileBlock(file->block);
+        file->blockStart += MBFS_BLOCK_SIZE;
+    }
+
+    // Once we have the correct start block, handle the byte offset.
+    *offset = position - file->blockStart;
+
+    return file->block;
+}
+
 /**
   * Flush a given file's cache back to FLASH memory.
   *
@@ -1160,22 +1923,11 @@ int MicroBitFileSystem::writeBuffer(FileDescriptor *file, uint8_t *buffer, int s
     uint8_t *writePointer;
 
     uint32_t offset;
-    uint32_t position = 0;
     int bytesCopied = 0;
     int segmentLength;
 
-    // Find the read position.
-    block = file->dirent->first_block;
-
-    // Walk the file table until we reach the start block
-    while (file->seek - position > MBFS_BLOCK_SIZE)
-    {
-        block = getNextFileBlock(block);
-        position += MBFS_BLOCK_SIZE;
-    }
-
-    // Once we have the correct start block, handle the byte offset.
-    offset = file->seek - position;
+    // Find the write position, continuing from where any previous access left off.
+    block = getFileBlock(file, file->seek, &offset);
     writePointer = (uint8_t *)getBlock(block) + offset;
 
     // Now, start copying bytes from the requested buffer.
@@ -1186,7 +1938,15 @@ int MicroBitFileSystem::writeBuffer(FileDescriptor *file, uint8_t *buffer, int s
         segmentLength = min(size - bytesCopied, MBFS_BLOCK_SIZE - offset);
 
         if (segmentLength != 0)
-            flash.flash_write(writePointer, readPointer, segmentLength, file->seek + bytesCopied < file->length ? getFreePage() : NULL);
+        {
+            uint32_t *scratch = file->seek + bytesCopied < file->length ? getFreePage() : NULL;
+
+            flash.flash_write(writePointer, readPointer, segmentLength, scratch);
+
+            // Overwriting existing data may have erased the page. Track the wear, and withhold a dirty scratch page from allocation.
+            if (scratch && (status & MBFS_STATUS_LOG_STRUCTURED))
+                releaseScratchPage(scratch, writePointer);
+        }
 
         offset += segmentLength;
         bytesCopied += segmentLength;
@@ -1194,14 +1954,22 @@ int MicroBitFileSystem::writeBuffer(FileDescriptor *file, uint8_t *buffer, int s
 
         if (offset == MBFS_BLOCK_SIZE && bytesCopied < size)
         {
-            newBlock = getFreeBlock();
-            if (newBlock == 0)
-                break;
+            newBlock = getNextFileBlock(block);
+
+            // Only extend the file if we're writing beyond its last block.
+            if (newBlock == MBFS_EOF)
+            {
+                newBlock = getFreeBlock();
+                if (newBlock == 0)
+                    break;
 
-            fileTableWrite(newBlock, MBFS_EOF);
-            fileTableWrite(block, newBlock);
+                fileTableWrite(newBlock, MBFS_EOF);
+                fileTableWrite(block, newBlock);
+            }
 
             block = newBlock;
+            file->block = block;
+            file->blockStart += MBFS_BLOCK_SIZE;
 
             writePointer = (uint8_t *)getBlock(block);
             offset = 0;
@@ -1343,9 +2111,21 @@ int MicroBitFileSystem::remove(char const * filename)
     }
 
     // Mark the directory entry of this file as invalid.
+    bool isDirectory = (file->dirent->flags & (MBFS_DIRECTORY_ENTRY_FREE | MBFS_DIRECTORY_ENTRY_DIRECTORY)) == MBFS_DIRECTORY_ENTRY_DIRECTORY;
     value = MBFS_DIRECTORY_ENTRY_DELETED;
     flash.flash_write(&file->dirent->flags, &value, 2);
 
+    // Forget the file. Removing a directory orphans anything indexed beneath it, so rebuild the index in that case.
+    if (isDirectory)
+    {
+        buildDirectoryIndex();
+        clearPathCache();
+    }
+    else
+    {
+        indexReplace(file->directory, file->dirent, NULL);
+    }
+
     // release file metadata
     delete file;
 
@@ -23,6 +23,8 @@ DEALINGS IN THE SOFTWARE.
 #include "MicroBitFlash.h"
 #include "MicroBitDevice.h"
 #include "ErrorNo.h"                
+#include "CodalComponent.h"
+#include "CodalFiber.h"
 
 #ifdef SOFTDEVICE_PRESENT
 #include "nrf_sdh_soc.h"
@@ -59,6 +61,13 @@ extern "C" void btle_set_user_evt_handler(void (*func)(uint32_t));
 //#endif
 
 static volatile bool flash_op_complete = false;
+static volatile bool flash_op_error = false;
+
+// Flash operations queued by all instances, as they share the same NVMC.
+static MicroBitFlashOperation flash_queue[MICROBIT_FLASH_QUEUE_SIZE];
+static int flash_queue_head = 0;
+static int flash_queue_length = 0;
+static bool flash_op_pending = false;
 
 /*
  * When SoftDevice is present,
@@ -70,14 +79,240 @@ static volatile bool flash_op_complete = false;
 
 static void nvmc_event_handler(uint32_t sys_evt, void *)
 {
-    if (sys_evt == NRF_EVT_FLASH_OPERATION_SUCCESS)
+    if (sys_evt == NRF_EVT_FLASH_OPERATION_SUCCESS || sys_evt == NRF_EVT_FLASH_OPERATION_ERROR)
+    {
+        flash_op_error = (sys_evt == NRF_EVT_FLASH_OPERATION_ERROR);
         flash_op_complete = true;
+
+        if (flash_op_pending)
+            Event(MICROBIT_ID_FLASH, MICROBIT_FLASH_EVT_READY);
+    }
 }
 
 NRF_SDH_SOC_OBSERVER( microbitflash_soc_observer, 0, nvmc_event_handler, NULL);
 
 #endif
 
+/**
+  * Determine if the calling context may be descheduled while waiting for the flash.
+  */
+static bool flash_can_yield()
+{
+    return fiber_scheduler_running() && __get_IPSR() == 0;
+}
+
+/**
+  * Remove the operation at the head of the queue, and notify any waiting fibers.
+  */
+static void flash_queue_pop()
+{
+    flash_queue_head = (flash_queue_head + 1) % MICROBIT_FLASH_QUEUE_SIZE;
+    flash_queue_length--;
+
+    if (fiber_scheduler_running())
+        Event(MICROBIT_ID_FLASH, MICROBIT_FLASH_EVT_READY);
+}
+
+/**
+  * Perform the next step of the operation at the head of the queue using the NVMC directly.
+  * Long operations are split into steps, so that other fibers may run between them.
+  */
+static void flash_nvmc_step(MicroBitFlashOperation *op)
+{
+    if (op->buffer)
+    {
+        int words = MIN(op->length, MICROBIT_FLASH_NVMC_BURST);
+
+        // Turn on flash write enable and wait until the NVMC is ready:
+        NRF_NVMC->CONFIG = (NVMC_CONFIG_WEN_Wen << NVMC_CONFIG_WEN_Pos);
+        while (NRF_NVMC->READY == NVMC_READY_READY_Busy) {};
+
+        for(int i=0;i<words;i++)
+        {
+            *(op->address+i) = *(op->buffer+i);
+            while (NRF_NVMC->READY == NVMC_READY_READY_Busy) {};
+        }
+
+        // Turn off flash write enable and wait until the NVMC is ready:
+        NRF_NVMC->CONFIG = (NVMC_CONFIG_WEN_Ren << NVMC_CONFIG_WEN_Pos);
+        while (NRF_NVMC->READY == NVMC_READY_READY_Busy) {};
+
+        op->address += words;
+        op->buffer += words;
+        op->length -= words;
+    }
+    else
+    {
+        // Turn on flash erase enable and wait until the NVMC is ready:
+        NRF_NVMC->CONFIG = (NVMC_CONFIG_WEN_Een);
+        while (NRF_NVMC->READY == NVMC_READY_READY_Busy) { }
+
+#ifdef NVMC_ERASEPAGEPARTIALCFG_DURATION_Msk
+        // Erase the page in short steps, rather than stalling the CPU for the whole erase time.
+        NRF_NVMC->ERASEPAGEPARTIALCFG = MICROBIT_FLASH_PARTIAL_ERASE_TIME;
+        NRF_NVMC->ERASEPAGEPARTIAL = (uint32_t)op->address;
+        while (NRF_NVMC->READY == NVMC_READY_READY_Busy) { }
+
+        op->length -= MICROBIT_FLASH_PARTIAL_ERASE_TIME;
+#else
+        // Erase page:
+        NRF_NVMC->ERASEPAGE = (uint32_t)op->address;
+        while (NRF_NVMC->READY == NVMC_READY_READY_Busy) { }
+
+        op->length = 0;
+#endif
+
+        // Turn off flash erase enable and wait until the NVMC is ready:
+        NRF_NVMC->CONFIG = (NVMC_CONFIG_WEN_Ren << NVMC_CONFIG_WEN_Pos);
+        while (NRF_NVMC->READY == NVMC_READY_READY_Busy) { }
+    }
+
+    if (op->length <= 0)
+        flash_queue_pop();
+}
+
+/**
+  * Advance the flash operation queue. Completes the operation in flight with the SoftDevice if it
+  * has finished, and starts the next. Without the SoftDevice, performs the next step using the NVMC.
+  * Never blocks for longer than a single step.
+  */
+static void flash_queue_process()
+{
+    if (flash_queue_length == 0)
+        return;
+
+    MicroBitFlashOperation *op = &flash_queue[flash_queue_head];
+
+#ifdef SOFTDEVICE_PRESENT
+    if (flash_op_pending)
+    {
+        // Wait for SoftDevice to diable the write operation when it completes...
+        if (!flash_op_complete)
+            return;
+
+        flash_op_pending = false;
+
+        // The SoftDevice could not find time to perform the operation. Leave it queued, and try again.
+        if (!flash_op_error)
+        {
+            flash_queue_pop();
+
+            if (flash_queue_length == 0)
+                return;
+
+            op = &flash_queue[flash_queue_head];
+        }
+    }
+
+    if (ble_running())
+    {
+        // Schedule SoftDevice to perform the operation for us. This happens ASYNCHRONOUSLY, and
+        // is completed via nvmc_event_handler. If the SoftDevice is busy, we try again later.
+        flash_op_complete = false;
+        flash_op_error = false;
+
+        uint32_t result = op->buffer ? sd_flash_write(op->address, op->buffer, op->length) : sd_flash_page_erase(((uint32_t)op->address)/MICROBIT_CODEPAGESIZE);
+
+        if (result == NRF_SUCCESS)
+            flash_op_pending = true;
+
+        return;
+    }
+#endif
+
+    flash_nvmc_step(op);
+}
+
+/**
+  * Advances the flash operation queue whenever the scheduler is idle, so queued operations
+  * complete even if no fiber is waiting on them.
+  */
+class MicroBitFlashScheduler : public CodalComponent
+{
+    public:
+
+    MicroBitFlashScheduler()
+    {
+        status |= DEVICE_COMPONENT_STATUS_IDLE_TICK;
+    }
+
+    virtual void idleCallback()
+    {
+        flash_queue_process();
+    }
+};
+
+static MicroBitFlashScheduler *flash_scheduler = NULL;
+
+/**
+  * Deschedule the calling fiber until the flash operation queue may have made progress.
+  */
+static void flash_queue_yield()
+{
+    if (flash_can_yield())
+    {
+        if (flash_op_pending)
+        {
+            // Begin waiting before testing for completion, so an operation completing in between still wakes us.
+            fiber_wake_on_event(MICROBIT_ID_FLASH, MICROBIT_FLASH_EVT_READY);
+
+            if (flash_op_complete)
+                Event(MICROBIT_ID_FLASH, MICROBIT_FLASH_EVT_READY);
+
+            schedule();
+        }
+        else if (ble_running())
+            fiber_sleep(10);
+        else
+            schedule();
+    }
+    else
+    {
+        if (!flash_op_pending && ble_running())
+            system_timer_wait_ms(10);
+    }
+}
+
+/**
+  * Add an operation to the tail of the flash operation queue, waiting for space if necessary.
+  */
+static void flash_queue_add(uint32_t *address, uint32_t *buffer, int length)
+{
+    if (flash_scheduler == NULL && fiber_scheduler_running())
+        flash_scheduler = new MicroBitFlashScheduler();
+
+    // Merge contiguous writes within a page into a single operation, provided it has not yet started.
+    if (buffer && flash_queue_length > 1)
+    {
+        MicroBitFlashOperation *tail = &flash_queue[(flash_queue_head + flash_queue_length - 1) % MICROBIT_FLASH_QUEUE_SIZE];
+
+        if (tail->buffer && tail->address + tail->length == address && tail->buffer + tail->length == buffer &&
+            ((uint32_t)tail->address) / MICROBIT_CODEPAGESIZE == ((uint32_t)(address + length - 1)) / MICROBIT_CODEPAGESIZE)
+        {
+            tail->length += length;
+            return;
+        }
+    }
+
+    while (flash_queue_length == MICROBIT_FLASH_QUEUE_SIZE)
+    {
+        flash_queue_process();
+
+        if (flash_queue_length == MICROBIT_FLASH_QUEUE_SIZE)
+            flash_queue_yield();
+    }
+
+    MicroBitFlashOperation *op = &flash_queue[(flash_queue_head + flash_queue_length) % MICROBIT_FLASH_QUEUE_SIZE];
+    op->address = address;
+    op->buffer = buffer;
+    op->length = buffer ? length : MICROBIT_FLASH_PAGE_ERASE_TIME;
+    flash_queue_length++;
+
+    // Start the operation straight away if the flash is idle.
+    if (flash_queue_length == 1)
+        flash_queue_process();
+}
+
 /**
   * Default Constructor
   */
@@ -115,35 +350,8 @@ int MicroBitFlash::need_erase(uint8_t* source, uint8_t* flash_addr, int len)
   */
 void MicroBitFlash::erase_page(uint32_t* pg_addr)
 {
-#ifdef SOFTDEVICE_PRESENT
-    if (ble_running())
-    {
-        flash_op_complete = false;
-        while(1)
-        {
-            if (sd_flash_page_erase(((uint32_t)pg_addr)/MICROBIT_CODEPAGESIZE) == NRF_SUCCESS)
-                break;
-
-            system_timer_wait_ms(10);
-        }
-        // Wait for SoftDevice to diable the write operation when it completes...
-        while(!flash_op_complete);
-    }
-    else
-#endif
-    {
-        // Turn on flash erase enable and wait until the NVMC is ready:
-        NRF_NVMC->CONFIG = (NVMC_CONFIG_WEN_Een);
-        while (NRF_NVMC->READY == NVMC_READY_READY_Busy) { }
-
-        // Erase page:
-        NRF_NVMC->ERASEPAGE = (uint32_t)pg_addr;
-        while (NRF_NVMC->READY == NVMC_READY_READY_Busy) { }
-
-        // Turn off flash erase enable and wait until the NVMC is ready:
-        NRF_NVMC->CONFIG = (NVMC_CONFIG_WEN_Ren << NVMC_CONFIG_WEN_Pos);
-        while (NRF_NVMC->READY == NVMC_READY_READY_Busy) { }
-    }
+    erase_page_async(pg_addr);
+    wait();
 }
 
 /**
@@ -157,41 +365,70 @@ void MicroBitFlash::erase_page(uint32_t* pg_addr)
   */
 void MicroBitFlash::flash_burn(uint32_t* addr, uint32_t* buffer, int size)
 {
-#ifdef SOFTDEVICE_PRESENT
-    if (ble_running())
-    {
-        // Schedule SoftDevice to write this memory for us, and wait for it to complete.
-        // This happens ASYNCHRONOUSLY when SD is enabled (and synchronously if disabled!!)
-        flash_op_complete = false;
+    flash_burn_async(addr, buffer, size);
+    wait();
+}
 
-        while(1)
-        {
-            if (sd_flash_write(addr, buffer, size) == NRF_SUCCESS)
-                break;
+/**
+  * Queue the erase of an entire page, and return without waiting for it to complete.
+  * Operations are performed in the order they are queued. If the queue is full,
+  * the calling fiber waits until space is available.
+  *
+  * @param page_address address of first word of page.
+  * @return MICROBIT_OK on success.
+  */
+int MicroBitFlash::erase_page_async(uint32_t* pg_addr)
+{
+    flash_queue_add(pg_addr, NULL, 0);
+    return MICROBIT_OK;
+}
 
-            system_timer_wait_ms(10);
-        }
+/**
+  * Queue a write to flash memory, and return without waiting for it to complete.
+  * The write is merged with the previously queued write where the two are contiguous.
+  *
+  * @param page_address address of memory to write to. Must be word aligned.
+  * @param buffer address to write from, must be word-aligned. Must remain valid until the
+  *               operation completes (see wait()).
+  * @param len number of uint32_t words to write.
+  * @return MICROBIT_OK on success.
+  */
+int MicroBitFlash::flash_burn_async(uint32_t* addr, uint32_t* buffer, int size)
+{
+    if (size <= 0)
+        return MICROBIT_OK;
 
-        // Wait for SoftDevice to diable the write operation when it completes...
-        while(!flash_op_complete);
-    }
-    else
-#endif
-    {
-        // Turn on flash write enable and wait until the NVMC is ready:
-        NRF_NVMC->CONFIG = (NVMC_CONFIG_WEN_Wen << NVMC_CONFIG_WEN_Pos);
-        while (NRF_NVMC->READY == NVMC_READY_READY_Busy) {};
+    flash_queue_add(addr, buffer, size);
+    return MICROBIT_OK;
+}
 
-        for(int i=0;i<size;i++)
-        {
-            *(addr+i) = *(buffer+i);
-            while (NRF_NVMC->READY == NVMC_READY_READY_Busy) {};
-        }
+/**
+  * Wait for all queued flash operations to complete. The calling fiber is descheduled
+  * while the SoftDevice or NVMC is busy, so other fibers continue to run.
+  *
+  * @return MICROBIT_OK on success.
+  */
+int MicroBitFlash::wait()
+{
+    while (flash_queue_length > 0)
+    {
+        flash_queue_process();
 
-        // Turn off flash write enable and wait until the NVMC is ready:
-        NRF_NVMC->CONFIG = (NVMC_CONFIG_WEN_Ren << NVMC_CONFIG_WEN_Pos);
-        while (NRF_NVMC->READY == NVMC_READY_READY_Busy) {};
+        if (flash_queue_length > 0)
+            flash_queue_yield();
     }
+
+    return MICROBIT_OK;
+}
+
+/**
+  * Determine if any queued flash operations are yet to complete.
+  *
+  * @return true if operations are pending, false otherwise.
+  */
+bool MicroBitFlash::busy()
+{
+    return flash_queue_length > 0;
 }
 
 /**
@@ -214,6 +451,9 @@ void MicroBitFlash::flash_burn(uint32_t* addr, uint32_t* buffer, int size)
 int MicroBitFlash::flash_write(void* address, void* from_buffer,
                                int length, void* scratch_addr)
 {
+    // Ensure any queued operations have completed, as we inspect the current contents of the flash.
+    wait();
+
     // If no scratch_addr has been supplied use the default
     if(scratch_addr == NULL)
         scratch_addr = (uint32_t *)MICROBIT_DEFAULT_SCRATCH_PAGE;
@@ -250,7 +490,11 @@ int MicroBitFlash::flash_write(void* address, void* from_buffer,
         end = MICROBIT_CODEPAGESIZE;
     }
 
+    // Assemble words into a small buffer, so that they are programmed in a few larger operations.
+    uint32_t writeBuffer[MICROBIT_FLASH_WRITE_BURST];
+    uint32_t *writeAddress = pgAddr + (start/4);
     uint32_t writeWord = 0;
+    int words = 0;
 
     for(int i=start;i<end;i++)
     {
@@ -268,11 +512,21 @@ int MicroBitFlash::flash_write(void* address, void* from_buffer,
 
         if( ((i+1)%4) == 0)
         {
-            this->flash_burn(pgAddr + (i/4), &writeWord, 1);
+            writeBuffer[words++] = writeWord;
             writeWord = 0;
+
+            if (words == MICROBIT_FLASH_WRITE_BURST)
+            {
+                this->flash_burn(writeAddress, writeBuffer, words);
+                writeAddress += words;
+                words = 0;
+            }
         }
     }
 
+    if (words)
+        this->flash_burn(writeAddress, writeBuffer, words);
+
     return MICROBIT_OK;
 }
 
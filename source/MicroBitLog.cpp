@@ -24,6 +24,7 @@ DEALINGS IN THE SOFTWARE.
 
 #include "MicroBitLog.h"
 #include "CodalDmesg.h"
+#include "CodalFiber.h"
 #include <new>
 
 #define ARRAY_LEN(array)    (sizeof(array) / sizeof(array[0]))
@@ -52,6 +53,485 @@ static void writeNum(char *buf, uint32_t n)
     buf[i] = 0;
 }
 
+/**
+ * Calculates a 16 bit FNV-1a hash of the given key.
+ */
+static uint16_t hashKey(const char *key, int len)
+{
+    uint32_t h = 2166136261UL;
+
+    for (int i = 0; i < len; i++)
+    {
+        h ^= (uint8_t) key[i];
+        h *= 16777619UL;
+    }
+
+    return (uint16_t) ((h >> 16) ^ h);
+}
+
+/**
+ * Writes the given unsigned value into the buffer as decimal, zero padded to at least the given number of digits.
+ * The buffer is not NULL terminated.
+ *
+ * @return the number of characters written.
+ */
+static int writeDecimal(char *buf, uint64_t n, int digits = 1)
+{
+    char tmp[20];
+    int len = 0;
+
+    do
+    {
+        tmp[len++] = '0' + (n % 10);
+        n /= 10;
+    } while (n || len < digits);
+
+    for (int i = 0; i < len; i++)
+        buf[i] = tmp[len - 1 - i];
+
+    return len;
+}
+
+/**
+ * Writes the given signed value into the buffer as decimal. The buffer is not NULL terminated,
+ * and must be at least 21 bytes long.
+ *
+ * @return the number of characters written.
+ */
+static int writeInt(char *buf, int64_t n)
+{
+    if (n < 0)
+    {
+        buf[0] = '-';
+        return 1 + writeDecimal(buf + 1, -(uint64_t) n);
+    }
+
+    return writeDecimal(buf, n);
+}
+
+/**
+ * Writes the given floating point value into the buffer as decimal, to at most CONFIG_MICROBIT_LOG_FLOAT_PRECISION
+ * decimal places with trailing zeroes removed. The buffer is not NULL terminated, and must be at least 32 bytes long.
+ * Arithmetic is performed at the precision of the type given, so floats avoid the cost of software double precision.
+ *
+ * @return the number of characters written.
+ */
+template <typename T>
+static int writeFloat(char *buf, T f)
+{
+    int len = 0;
+
+    if (f != f)
+    {
+        memcpy(buf, "NaN", 3);
+        return 3;
+    }
+
+    if (f < 0)
+    {
+        buf[len++] = '-';
+        f = -f;
+    }
+
+    // Values too large to represent as integers are logged as infinite.
+    if (f >= (T) 1.8e19)
+    {
+        memcpy(&buf[len], "Infinity", 8);
+        return len + 8;
+    }
+
+    uint32_t scale = 1;
+    for (int i = 0; i < CONFIG_MICROBIT_LOG_FLOAT_PRECISION; i++)
+        scale *= 10;
+
+    uint64_t integer = (uint64_t) f;
+    uint32_t fraction = (uint32_t) ((f - (T) integer) * scale + (T) 0.5);
+
+    // Rounding the fractional part may carry into the integer part.
+    if (fraction >= scale)
+    {
+        integer++;
+        fraction -= scale;
+    }
+
+    len += writeDecimal(&buf[len], integer);
+
+    if (fraction)
+    {
+        int digits = CONFIG_MICROBIT_LOG_FLOAT_PRECISION;
+        while (fraction % 10 == 0)
+        {
+            fraction /= 10;
+            digits--;
+        }
+
+        buf[len++] = '.';
+        len += writeDecimal(&buf[len], fraction, digits);
+    }
+
+    return len;
+}
+
+/**
+ * Replaces invalid LogFS symbols in the given buffer ("-->" and optionally ",\t\n").
+ *
+ * @param s the data to clean
+ * @param len the number of characters to clean
+ * @param removeSeparators if set to false, only "-->" symbols are replaced, otherwise ",\t\n" characters are also replaced.
+ */
+static void cleanInPlace(char *s, int len, bool removeSeparators)
+{
+    for (int i=0; i<len; i++)
+    {
+        if (i+2 < len && s[i] == '-' && s[i+1] == '-' && s[i+2] == '>')
+        {
+            s[i] = CONFIG_MICROBIT_LOG_INVALID_CHAR_VALUE;
+            s[i+1] = CONFIG_MICROBIT_LOG_INVALID_CHAR_VALUE;
+            s[i+2] = CONFIG_MICROBIT_LOG_INVALID_CHAR_VALUE;
+        }
+
+        if (s[i] == '\t' || (removeSeparators && (s[i] == ',' || s[i] == '\n')))
+            s[i] = CONFIG_MICROBIT_LOG_INVALID_CHAR_VALUE;
+    }
+}
+
+/**
+ * Writes the given value into the buffer as decimal, with the given number of decimal places.
+ * The buffer is not NULL terminated, and must be at least 22 bytes long.
+ *
+ * @return the number of characters written.
+ */
+static int writeScaled(char *buf, int64_t n, int places)
+{
+    uint64_t u = (uint64_t) n;
+    int len = 0;
+
+    if (n < 0)
+    {
+        buf[len++] = '-';
+        u = 0 - u;
+    }
+
+    if (places == 0)
+        return len + writeDecimal(&buf[len], u);
+
+    uint64_t scale = 1;
+    for (int i = 0; i < places; i++)
+        scale *= 10;
+
+    len += writeDecimal(&buf[len], u / scale);
+    buf[len++] = '.';
+    len += writeDecimal(&buf[len], u % scale, places);
+
+    return len;
+}
+
+/**
+ * Parses a decimal number, as written by writeScaled().
+ *
+ * @param s the text to parse.
+ * @param len the length of the text.
+ * @param n the value of the number, without its decimal point.
+ * @return the number of decimal places, or -1 if writeScaled() would not reproduce the text exactly.
+ */
+static int parseScaled(const char *s, int len, int64_t &n)
+{
+    uint64_t u = 0;
+    int digits = 0;
+    int places = -1;
+
+    for (int i = (len > 0 && s[0] == '-') ? 1 : 0; i < len; i++)
+    {
+        if (s[i] == '.' && places < 0)
+        {
+            places = 0;
+            continue;
+        }
+
+        if (s[i] < '0' || s[i] > '9' || ++digits > 18)
+            return -1;
+
+        u = u * 10 + (s[i] - '0');
+
+        if (places >= 0)
+            places++;
+    }
+
+    if (digits == 0 || places > MICROBIT_LOG_MAX_DECIMAL_PLACES)
+        return -1;
+
+    if (places < 0)
+        places = 0;
+
+    n = s[0] == '-' ? -(int64_t) u : (int64_t) u;
+
+    // Reject anything not in canonical form (e.g. "007", "-0" or "1."), as it would be rendered differently.
+    char check[MICROBIT_LOG_DECODE_BUFFER_SIZE];
+    if (writeScaled(check, n, places) != len || memcmp(check, s, len) != 0)
+        return -1;
+
+    return places;
+}
+
+// The characters below MICROBIT_LOG_VARINT_FINAL that cannot appear in a record, as they would be altered by, or could end,
+// the HTML comment holding the log in MY_DATA.HTM. In ascending order.
+static const uint8_t excludedCharacters[] = { 0x00, '\r', '!', '-', '>' };
+
+/**
+ * Writes the given value into the buffer as a varint, using only characters that can appear in a record.
+ *
+ * @return the number of bytes written.
+ */
+static int writeVarint(uint8_t *buf, uint64_t v)
+{
+    int len = 0;
+
+    while (v >= MICROBIT_LOG_VARINT_FINAL_BASE)
+    {
+        uint8_t b = v % MICROBIT_LOG_VARINT_BASE;
+
+        for (uint32_t i = 0; i < ARRAY_LEN(excludedCharacters); i++)
+            if (b >= excludedCharacters[i])
+                b++;
+
+        buf[len++] = b;
+        v /= MICROBIT_LOG_VARINT_BASE;
+    }
+
+    buf[len++] = MICROBIT_LOG_VARINT_FINAL + v;
+
+    return len;
+}
+
+/**
+ * Determines the value of a varint continuation digit.
+ */
+static int varintDigit(uint8_t b)
+{
+    int d = b;
+
+    for (uint32_t i = 0; i < ARRAY_LEN(excludedCharacters); i++)
+        if (b >= excludedCharacters[i])
+            d--;
+
+    return d;
+}
+
+/**
+ * Maps signed values onto unsigned values, such that values of small magnitude encode as short varints.
+ */
+static uint64_t zigzag(int64_t n)
+{
+    return ((uint64_t) n << 1) ^ (uint64_t) (n >> 63);
+}
+
+static int64_t unzigzag(uint64_t v)
+{
+    return (int64_t) (v >> 1) ^ -(int64_t) (v & 1);
+}
+
+// The field of a binary record being decoded by MicroBitLogDecoder.
+enum
+{
+    DECODE_TAG,
+    DECODE_VIEWER,
+    DECODE_TEXT_LENGTH,
+    DECODE_TEXT,
+    DECODE_COLUMNS,
+    DECODE_TYPE,
+    DECODE_VALUE,
+    DECODE_STRING_LENGTH,
+    DECODE_STRING
+};
+
+/**
+ * Constructor.
+ *
+ * @param time the value of the most recent timestamp before the first record to be decoded.
+ * @param rowTypes the column types of the most recent ROW record before the first record to be decoded.
+ */
+MicroBitLogDecoder::MicroBitLogDecoder(int64_t time, uint64_t rowTypes)
+{
+    this->state = DECODE_TAG;
+    this->type = 0;
+    this->repeat = false;
+    this->column = 0;
+    this->columns = 0;
+    this->remaining = 0;
+    this->value = 0;
+    this->place = 1;
+    this->time = time;
+    this->rowTypes = rowTypes;
+}
+
+/**
+ * Decodes the next byte of binary log data.
+ *
+ * @param b the byte to decode.
+ * @param text buffer of at least MICROBIT_LOG_DECODE_BUFFER_SIZE bytes to receive the CSV text rendered.
+ * @return the number of characters of text rendered. A row ends with, and only with, a newline as the last character.
+ */
+int MicroBitLogDecoder::decode(uint8_t b, char *text)
+{
+    switch (state)
+    {
+        case DECODE_TAG:
+            if (b == MICROBIT_LOG_RECORD_VIEWER)
+                state = DECODE_VIEWER;
+
+            if (b == MICROBIT_LOG_RECORD_TEXT)
+                state = DECODE_TEXT_LENGTH;
+
+            if (b == MICROBIT_LOG_RECORD_ROW)
+                state = DECODE_COLUMNS;
+
+            if (b == MICROBIT_LOG_RECORD_REPEAT && rowTypes != MICROBIT_LOG_NO_REPEAT)
+            {
+                // The columns are those of the last ROW record. Unused nibbles of rowTypes are all set.
+                repeat = true;
+                column = 0;
+                columns = 0;
+                while (columns < MICROBIT_LOG_REPEAT_COLUMNS && ((rowTypes >> (columns * 4)) & 0x0F) != 0x0F)
+                    columns++;
+
+                return beginValue(text);
+            }
+
+            return 0;
+
+        case DECODE_VIEWER:
+            if (b == '\n')
+                state = DECODE_TAG;
+            return 0;
+
+        case DECODE_TEXT:
+            text[0] = b;
+            if (--remaining == 0)
+                state = DECODE_TAG;
+            return 1;
+
+        case DECODE_STRING:
+            text[0] = b;
+            if (--remaining)
+                return 1;
+            return 1 + endValue(&text[1]);
+    }
+
+    // All other fields are varints.
+    if (b < MICROBIT_LOG_VARINT_FINAL)
+    {
+        value += varintDigit(b) * place;
+        place *= MICROBIT_LOG_VARINT_BASE;
+        return 0;
+    }
+
+    // The varint is complete.
+    uint64_t v = value + (b - MICROBIT_LOG_VARINT_FINAL) * place;
+    value = 0;
+    place = 1;
+
+    switch (state)
+    {
+        case DECODE_TEXT_LENGTH:
+            remaining = v;
+            state = remaining ? DECODE_TEXT : DECODE_TAG;
+            return 0;
+
+        case DECODE_COLUMNS:
+            repeat = false;
+            columns = v;
+            column = 0;
+            rowTypes = MICROBIT_LOG_NO_REPEAT;
+            state = columns ? DECODE_TYPE : DECODE_TAG;
+            return 0;
+
+        case DECODE_TYPE:
+            type = v;
+
+            // Rows with few enough columns may be followed by REPEAT records, so their types are kept.
+            if (columns <= MICROBIT_LOG_REPEAT_COLUMNS)
+                rowTypes = (rowTypes & ~(0x0FULL << (column * 4))) | ((uint64_t) type << (column * 4));
+
+            return beginValue(text);
+
+        case DECODE_STRING_LENGTH:
+            remaining = v;
+            if (remaining)
+            {
+                state = DECODE_STRING;
+                return 0;
+            }
+            return endValue(text);
+    }
+
+    // A number or timestamp.
+    int64_t n = unzigzag(v);
+    int places = type - MICROBIT_LOG_VALUE_NUMBER;
+
+    if (type >= MICROBIT_LOG_VALUE_TIME)
+    {
+        if (type >= MICROBIT_LOG_VALUE_TIME_ABSOLUTE)
+        {
+            time = n;
+            places = (type - MICROBIT_LOG_VALUE_TIME_ABSOLUTE) * 2;
+        }
+        else
+        {
+            time += n;
+            places = (type - MICROBIT_LOG_VALUE_TIME) * 2;
+        }
+
+        n = time;
+    }
+
+    int len = writeScaled(text, n, places);
+
+    return len + endValue(&text[len]);
+}
+
+/**
+ * Prepares to decode the value of the current column, rendering it immediately if it is empty.
+ *
+ * @return the number of characters of text rendered.
+ */
+int MicroBitLogDecoder::beginValue(char *text)
+{
+    // REPEAT records hold no types, so the type of each column is taken from the last ROW record.
+    if (repeat)
+        type = (rowTypes >> (column * 4)) & 0x0F;
+
+    if (type == MICROBIT_LOG_VALUE_EMPTY)
+        return endValue(text);
+
+    state = type == MICROBIT_LOG_VALUE_STRING ? DECODE_STRING_LENGTH : DECODE_VALUE;
+    return 0;
+}
+
+/**
+ * Renders the separator following the current column, and moves on to the next.
+ *
+ * @return the number of characters of text rendered.
+ */
+int MicroBitLogDecoder::endValue(char *text)
+{
+    column++;
+
+    if (column == columns)
+    {
+        text[0] = '\n';
+        state = DECODE_TAG;
+        return 1;
+    }
+
+    text[0] = ',';
+
+    if (repeat)
+        return 1 + beginValue(&text[1]);
+
+    state = DECODE_TYPE;
+    return 1;
+}
+
 /**
  * Constructor.
  */
@@ -70,6 +550,27 @@ MicroBitLog::MicroBitLog(MicroBitUSBFlashManager &flash, MicroBitPowerManager &p
     this->headingsChanged = false;
     this->timeStampChanged = false;
     this->rowData = NULL;
+    this->nextColumn = 0;
+    this->rowBuffer = NULL;
+    this->rowBufferSize = 0;
+    this->rowBufferLength = 0;
+    this->commitBuffer = NULL;
+    this->rowIndex = NULL;
+    this->rowIndexLength = 0;
+    this->rowIndexInterval = CONFIG_MICROBIT_LOG_ROW_INDEX_INTERVAL;
+    this->rowCount = 0;
+    this->csvLength = 0;
+    this->readCursor.address = 0;
+    this->recordBuffer = NULL;
+    this->recordBufferSize = 0;
+    this->lastTime = 0;
+    this->lastTimeValid = false;
+    this->lastTypes = MICROBIT_LOG_NO_REPEAT;
+    this->storageFormat = CONFIG_MICROBIT_LOG_BINARY_BY_DEFAULT ? LogFormat::Binary : LogFormat::Text;
+    this->commitLength = 0;
+    this->commitSize = CONFIG_MICROBIT_LOG_GROUP_COMMIT_SIZE;
+    this->commitDelay = CONFIG_MICROBIT_LOG_GROUP_COMMIT_DELAY;
+    this->commitTime = 0;
     this->timeStampFormat = TimeStampFormat::None;
 }
 
@@ -82,6 +583,10 @@ void MicroBitLog::init()
     if (status & MICROBIT_LOG_STATUS_INITIALIZED)
         return;
 
+    // Reads of the log are typically sequential, so fetch ahead to reduce the number of I2C transactions.
+    // This is configured on first use, so that programs not using the log hold no read-ahead buffer.
+    cache.setReadAhead(CONFIG_MICROBIT_LOG_CACHE_READ_AHEAD);
+
     if (_isPresent())
     {
         // We have a valid file system.
@@ -176,12 +681,24 @@ void MicroBitLog::init()
             {
                 new (&rowData[h]) ColumnEntry;
                 rowData[h].key = ManagedString(&headers[i]);
+                rowData[h].hash = hashKey(rowData[h].key.toCharArray(), rowData[h].key.length());
                 i = i + rowData[h].key.length() + 1;
             }
 
             free(headers);
         }
 
+        // The row index is rebuilt on demand.
+        status &= ~(MICROBIT_LOG_STATUS_ROW_INDEX | MICROBIT_LOG_STATUS_BINARY);
+
+        if (memcmp(metaData.version, MICROBIT_LOG_VERSION_BINARY, 14) == 0)
+            status |= MICROBIT_LOG_STATUS_BINARY;
+
+        // The last timestamp and row types are not known without scanning the log, so the next row is stored in full.
+        lastTimeValid = false;
+        lastTypes = MICROBIT_LOG_NO_REPEAT;
+        readCursor.address = 0;
+
         // We may be full here, but this is still a valid state.
         status |= MICROBIT_LOG_STATUS_INITIALIZED;
         return;
@@ -256,7 +773,16 @@ void MicroBitLog::_clear(bool fullErase)
     dataStart = journalStart + CONFIG_MICROBIT_LOG_JOURNAL_SIZE;
     dataEnd = dataStart;
     logEnd = flash.getFlashEnd() - sizeof(uint32_t);
-    status &= MICROBIT_LOG_STATUS_SERIAL_MIRROR;
+    status &= (MICROBIT_LOG_STATUS_SERIAL_MIRROR | MICROBIT_LOG_STATUS_LISTENING);
+    commitLength = 0;
+
+    if (storageFormat == LogFormat::Binary)
+        status |= MICROBIT_LOG_STATUS_BINARY;
+
+    lastTime = 0;
+    lastTimeValid = true;
+    lastTypes = MICROBIT_LOG_NO_REPEAT;
+    readCursor.address = 0;
     
     // Remove any cached state around column headings
     headingsChanged = false;
@@ -264,6 +790,8 @@ void MicroBitLog::_clear(bool fullErase)
     headingStart = 0;
     headingCount = 0;
     headingLength = 0;
+    nextColumn = 0;
+    rowBufferLength = 0;
 
     if (rowData)
     {
@@ -285,7 +813,7 @@ void MicroBitLog::_clear(bool fullErase)
     flash.write(flash.getFlashStart(), (uint32_t *)header, sizeof(header)/4);
 
     // Generate and write FS metadata
-    memcpy(metaData.version, MICROBIT_LOG_VERSION, 18);
+    memcpy(metaData.version, (status & MICROBIT_LOG_STATUS_BINARY) ? MICROBIT_LOG_VERSION_BINARY : MICROBIT_LOG_VERSION, 18);
     memcpy(metaData.dataStart, "0x00000000\0", 11);
     memcpy(metaData.logEnd, "0x00000000\0", 11);
     memcpy(metaData.daplinkVersion, "0000\0", 5);
@@ -374,7 +902,7 @@ void MicroBitLog::_setTimeStamp(TimeStampFormat format)
 
     // Special case for selecting timestamp headings before the first data is logged.
     // Here, we permit rewriting of Timestamp columns to promote simplicity.
-    if (dataStart == dataEnd && headingCount > 0)
+    if (dataStart == dataEnd && commitLength == 0 && headingCount > 0)
     {
         // If this timestamp has already been added. If so, nothing to do.
         if (rowData[0].key == timeStampHeading)
@@ -385,7 +913,10 @@ void MicroBitLog::_setTimeStamp(TimeStampFormat format)
         {
             // Remove the Timestamp column from the list of headings.
             for (uint32_t i=1; i<headingCount; i++)
+            {
                 rowData[i-1].key = rowData[i].key;
+                rowData[i-1].hash = rowData[i].hash;
+            }
 
             headingCount--;
         }
@@ -443,7 +974,10 @@ int MicroBitLog::_beginRow()
 
     // Reset all values, ready to populate with a new row.
     for (uint32_t i=0; i<headingCount; i++)
-        rowData[i].value = ManagedString();
+        rowData[i].valueLength = 0;
+
+    rowBufferLength = 0;
+    nextColumn = 0;
 
     // indicate that we've started a new row.
     status |= MICROBIT_LOG_STATUS_ROW_STARTED;
@@ -460,7 +994,13 @@ int MicroBitLog::_beginRow()
  */
 int MicroBitLog::logData(const char *key, const char *value)
 {
-    return logData(ManagedString(key), ManagedString(value));
+    int r;
+
+    mutex.wait();
+    r = _logData(key, strlen(key), value, strlen(value));
+    mutex.notify();
+
+    return r;
 }
 
 /**
@@ -483,71 +1023,307 @@ int MicroBitLog::logData(ManagedString key, ManagedString value)
 
 /**
  * Populates the current row with the given key/value pair.
+ * The value is logged as a single character, as it would be if converted to a ManagedString.
+ *
  * @param key the name of the key column) to set.
- * @param value the value to insert 
+ * @param value the value to insert
  *
  * @return DEVICE_OK on success.
  */
-int MicroBitLog::_logData(ManagedString key, ManagedString value)
-{
-    // Perform lazy instatiation if necessary.
-    init();
-
-    // If logData is called before explicitly beginning a row, do so implicitly.
-    if (!(status & MICROBIT_LOG_STATUS_ROW_STARTED))
-        _beginRow();
-
-    ManagedString k = cleanBuffer(key.toCharArray(), key.length());
-    ManagedString v = cleanBuffer(value.toCharArray(), value.length());
-
-    if (k.length())
-        key = k;
-
-    if (v.length())
-        value = v;
-
-    // Add the given key/value pair into our cumulative row data. 
-    bool added = false;
-    for (uint32_t i=0; i<headingCount; i++)
-    {
-        if(rowData[i].key == key)
-        {
-            rowData[i].value = value;
-            added = true;
-            break;
-        }
-    }
-
-    // If the requested heading is not available, add it.
-    if (!added)
-        addHeading(key, value);
-
-    return DEVICE_OK;
-}
-
-/**
- * Complete a row in the log, and pushes to persistent storage.
- * @return DEVICE_OK on success.
- */
-int MicroBitLog::endRow()
+int MicroBitLog::logData(const char *key, char value)
 {
     int r;
 
     mutex.wait();
-    r = _endRow();
+    r = _logData(key, strlen(key), &value, 1);
     mutex.notify();
 
     return r;
 }
 
 /**
- * Complete a row in the log, and pushes to persistent storage.
+ * Populates the current row with the given key/value pair.
+ * Equivalent to logData(key, (long long)value).
+ *
+ * @param key the name of the key column) to set.
+ * @param value the value to insert
+ *
  * @return DEVICE_OK on success.
  */
-int MicroBitLog::_endRow()
+int MicroBitLog::logData(const char *key, int value)
 {
-    if (!(status & MICROBIT_LOG_STATUS_ROW_STARTED))
-        return DEVICE_INVALID_STATE;
+    return logData(key, (long long) value);
+}
+
+/**
+ * Populates the current row with the given key/value pair.
+ * Equivalent to logData(key, (unsigned long long)value).
+ *
+ * @param key the name of the key column) to set.
+ * @param value the value to insert
+ *
+ * @return DEVICE_OK on success.
+ */
+int MicroBitLog::logData(const char *key, unsigned int value)
+{
+    return logData(key, (unsigned long long) value);
+}
+
+/**
+ * Populates the current row with the given key/value pair.
+ * Equivalent to logData(key, (long long)value).
+ *
+ * @param key the name of the key column) to set.
+ * @param value the value to insert
+ *
+ * @return DEVICE_OK on success.
+ */
+int MicroBitLog::logData(const char *key, long value)
+{
+    return logData(key, (long long) value);
+}
+
+/**
+ * Populates the current row with the given key/value pair.
+ * Equivalent to logData(key, (unsigned long long)value).
+ *
+ * @param key the name of the key column) to set.
+ * @param value the value to insert
+ *
+ * @return DEVICE_OK on success.
+ */
+int MicroBitLog::logData(const char *key, unsigned long value)
+{
+    return logData(key, (unsigned long long) value);
+}
+
+/**
+ * Populates the current row with the given key/value pair.
+ * The value is formatted directly into the row, without using the heap.
+ *
+ * @param key the name of the key column) to set.
+ * @param value the value to insert
+ *
+ * @return DEVICE_OK on success.
+ */
+int MicroBitLog::logData(const char *key, long long value)
+{
+    char v[21];
+    int r;
+
+    mutex.wait();
+    r = _logData(key, strlen(key), v, writeInt(v, value));
+    mutex.notify();
+
+    return r;
+}
+
+/**
+ * Populates the current row with the given key/value pair.
+ * The value is formatted directly into the row, without using the heap.
+ *
+ * @param key the name of the key column) to set.
+ * @param value the value to insert
+ *
+ * @return DEVICE_OK on success.
+ */
+int MicroBitLog::logData(const char *key, unsigned long long value)
+{
+    char v[20];
+    int r;
+
+    mutex.wait();
+    r = _logData(key, strlen(key), v, writeDecimal(v, value));
+    mutex.notify();
+
+    return r;
+}
+
+/**
+ * Populates the current row with the given key/value pair.
+ * The value is formatted directly into the row, without using the heap, to at most
+ * CONFIG_MICROBIT_LOG_FLOAT_PRECISION decimal places.
+ *
+ * @param key the name of the key column) to set.
+ * @param value the value to insert
+ *
+ * @return DEVICE_OK on success.
+ */
+int MicroBitLog::logData(const char *key, float value)
+{
+    char v[32];
+    int r;
+
+    mutex.wait();
+    r = _logData(key, strlen(key), v, writeFloat(v, value));
+    mutex.notify();
+
+    return r;
+}
+
+/**
+ * Populates the current row with the given key/value pair.
+ * The value is formatted directly into the row, without using the heap, to at most
+ * CONFIG_MICROBIT_LOG_FLOAT_PRECISION decimal places, using double precision arithmetic.
+ *
+ * @param key the name of the key column) to set.
+ * @param value the value to insert
+ *
+ * @return DEVICE_OK on success.
+ */
+int MicroBitLog::logData(const char *key, double value)
+{
+    char v[32];
+    int r;
+
+    mutex.wait();
+    r = _logData(key, strlen(key), v, writeFloat(v, value));
+    mutex.notify();
+
+    return r;
+}
+
+/**
+ * Populates the current row with the given key/value pair.
+ * @param key the name of the key column) to set.
+ * @param value the value to insert 
+ *
+ * @return DEVICE_OK on success.
+ */
+int MicroBitLog::_logData(ManagedString key, ManagedString value)
+{
+    return _logData(key.toCharArray(), key.length(), value.toCharArray(), value.length());
+}
+
+/**
+ * Populates the current row with the given key/value pair.
+ * The value is copied into the row buffer, so no heap allocation takes place unless a new column is added.
+ *
+ * @param key the name of the key column) to set.
+ * @param keyLength the length of the key, in bytes.
+ * @param value the value to insert
+ * @param valueLength the length of the value, in bytes.
+ *
+ * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if the row is too large to be stored.
+ */
+int MicroBitLog::_logData(const char *key, int keyLength, const char *value, int valueLength)
+{
+    // Perform lazy instatiation if necessary.
+    init();
+
+    // If logData is called before explicitly beginning a row, do so implicitly.
+    if (!(status & MICROBIT_LOG_STATUS_ROW_STARTED))
+        _beginRow();
+
+    // Keys rarely contain invalid symbols, in which case cleanBuffer() returns an empty string without allocating.
+    ManagedString k = cleanBuffer(key, keyLength);
+
+    if (k.length())
+        key = k.toCharArray();
+
+    // Find the column for the given key, adding it if it is not yet available.
+    int column = findColumn(key, keyLength, hashKey(key, keyLength));
+
+    if (column < 0)
+        column = addHeading(ManagedString(key, keyLength));
+
+    nextColumn = column + 1;
+
+    // Store the value in the row buffer, reusing the space of any earlier value for this column if possible.
+    ColumnEntry &c = rowData[column];
+
+    if (valueLength > c.valueLength)
+    {
+        if (reserveRowBuffer(valueLength) != DEVICE_OK)
+            return DEVICE_NO_RESOURCES;
+
+        c.valueOffset = rowBufferLength;
+        rowBufferLength += valueLength;
+    }
+
+    memcpy(&rowBuffer[c.valueOffset], value, valueLength);
+    cleanInPlace(&rowBuffer[c.valueOffset], valueLength, true);
+    c.valueLength = valueLength;
+
+    return DEVICE_OK;
+}
+
+/**
+ * Determines the column holding the given key.
+ *
+ * @param key the heading to find
+ * @param len the length of the key, in bytes
+ * @param hash the hash of the key, as calculated by hashKey()
+ * @return the index of the column in rowData, or -1 if the key is not in use.
+ */
+int MicroBitLog::findColumn(const char *key, int len, uint16_t hash)
+{
+    // Columns are typically logged in the same order on every row, so try the one after the last used first.
+    for (uint32_t n=0; n<headingCount; n++)
+    {
+        uint32_t i = (nextColumn + n) % headingCount;
+
+        if (rowData[i].hash == hash && rowData[i].key.length() == len && memcmp(rowData[i].key.toCharArray(), key, len) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+/**
+ * Ensures the row buffer has space for the given number of additional bytes, growing it if necessary.
+ *
+ * @param len the number of bytes required
+ * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if the buffer cannot be grown.
+ */
+int MicroBitLog::reserveRowBuffer(uint32_t len)
+{
+    uint32_t required = rowBufferLength + len;
+
+    if (required <= rowBufferSize)
+        return DEVICE_OK;
+
+    // Values are referenced by 16 bit offsets.
+    if (required > 0xFFFF)
+        return DEVICE_NO_RESOURCES;
+
+    uint32_t size = rowBufferSize ? rowBufferSize : CONFIG_MICROBIT_LOG_ROW_BUFFER_SIZE;
+    while (size < required)
+        size *= 2;
+
+    char *b = (char *) realloc(rowBuffer, size);
+    if (b == NULL)
+        return DEVICE_NO_RESOURCES;
+
+    rowBuffer = b;
+    rowBufferSize = size;
+
+    return DEVICE_OK;
+}
+
+/**
+ * Complete a row in the log, and pushes to persistent storage.
+ * @return DEVICE_OK on success.
+ */
+int MicroBitLog::endRow()
+{
+    int r;
+
+    mutex.wait();
+    r = _endRow();
+    mutex.notify();
+
+    return r;
+}
+
+/**
+ * Complete a row in the log, and pushes to persistent storage.
+ * @return DEVICE_OK on success.
+ */
+int MicroBitLog::_endRow()
+{
+    if (!(status & MICROBIT_LOG_STATUS_ROW_STARTED))
+        return DEVICE_INVALID_STATE;
 
     init();
 
@@ -557,7 +1333,7 @@ int MicroBitLog::_endRow()
     {
         timeStampChanged = false;
         if (timeStampFormat != TimeStampFormat::None)
-            addHeading(timeStampHeading, ManagedString::EmptyString, dataStart == dataEnd);
+            addHeading(timeStampHeading, dataStart == dataEnd && commitLength == 0);
     }
 
     // Special case the condition where no values are present.
@@ -566,7 +1342,7 @@ int MicroBitLog::_endRow()
 
     for (uint32_t i=0; i<headingCount; i++)
     {
-        if(rowData[i].value != ManagedString::EmptyString)
+        if(rowData[i].valueLength)
         {
             validData = true;
             break;
@@ -574,6 +1350,8 @@ int MicroBitLog::_endRow()
     }
 
     // Insert timestamp field if requested.
+    int timeColumn = -1;
+
     if (validData && timeStampFormat != TimeStampFormat::None)
     {
         // handle 32 bit overflow and fractional components of timestamp
@@ -589,24 +1367,28 @@ int MicroBitLog::_endRow()
             billions = billions / 100;
         }
 
-        ManagedString u(units);
-        ManagedString f(fraction);
-        ManagedString s;
-        f = padString(f, 2);
+        char s[32];
+        int len = 0;
 
         if (billions)
         {
-            s = s + billions;
-            u = padString(u, 9);
+            len += writeInt(s, billions);
+            len += writeDecimal(&s[len], units, 9);
+        }
+        else
+        {
+            len += writeInt(s, units);
         }
-
-        s = s + u;
 
         // Add two decimal places for anything other than milliseconds.
         if ((int)timeStampFormat > 1)
-            s = s + "." + f;
+        {
+            s[len++] = '.';
+            len += writeDecimal(&s[len], fraction, 2);
+        }
 
-        _logData(timeStampHeading, s);
+        _logData(timeStampHeading.toCharArray(), timeStampHeading.length(), s, len);
+        timeColumn = nextColumn - 1;
     }
 
     // If new columns have been added since the last row, update persistent storage accordingly.
@@ -640,24 +1422,33 @@ int MicroBitLog::_endRow()
         headingsChanged = false;
     }
 
-    // Serialize data to CSV
-    ManagedString row;
+    // Serialize data to CSV, directly into the row buffer following the values.
+    // One byte is needed after each value, for either a separator or the terminating newline.
+    uint32_t rowLength = headingCount;
     bool empty = true;
 
     for (uint32_t i=0; i<headingCount;i++)
     {
-        row = row + rowData[i].value;
-         
-        if (rowData[i].value.length())
-            empty = false;
+        rowLength += rowData[i].valueLength;
 
-        if (i + 1 != headingCount)
-            row = row + sep;
+        if (rowData[i].valueLength)
+            empty = false;
     }
-    row = row + "\n";
 
-    if (!empty)
-        _logString(row);
+    if (!empty && reserveRowBuffer(rowLength) == DEVICE_OK)
+    {
+        char *row = &rowBuffer[rowBufferLength];
+        char *p = row;
+
+        for (uint32_t i=0; i<headingCount;i++)
+        {
+            memcpy(p, &rowBuffer[rowData[i].valueOffset], rowData[i].valueLength);
+            p += rowData[i].valueLength;
+            *p++ = (i + 1 != headingCount) ? ',' : '\n';
+        }
+
+        _logBuffer(row, rowLength, timeColumn);
+    }
 
     status &= ~MICROBIT_LOG_STATUS_ROW_STARTED;
 
@@ -721,64 +1512,192 @@ int MicroBitLog::logString(const char *s)
  */
 int MicroBitLog::_logString(const char *s)
 {  
-    init();
-
-    uint32_t oldDataEnd = dataEnd;
     uint32_t l = strlen(s);
-    const char *data = s;
 
-    // If this is the first log entry written, ensure that the file visibility is activated.
-    // (it may have been disabled following a full erase)
-    if (dataStart == dataEnd)
-        _setVisibility(true);
+    ManagedString cleaned = cleanBuffer(s, l, false);
+    if (cleaned.length())
+        s = cleaned.toCharArray();
 
-    // If we can't write a whole line of data, then treat the log as full.
-    if (l > logEnd - dataEnd)
+    return _logBuffer(s, l);
+}
+
+/**
+ * Append the given data to the log. The data must already be free of invalid LogFS symbols,
+ * and should end with a newline.
+ *
+ * In group commit mode, the data is held in RAM until enough data or time has accumulated, and is then
+ * written to storage with the data of other rows. Otherwise, it is written immediately.
+ *
+ * Binary logs encode the data as binary records first.
+ *
+ * @param s the data to append.
+ * @param len the length of the data, in bytes.
+ * @param timeColumn the column holding the timestamp, or -1 if there is none.
+ */
+int MicroBitLog::_logBuffer(const char *s, uint32_t len, int timeColumn)
+{
+    init();
+
+    const char *text = s;
+    uint32_t textLength = len;
+
+    if (status & MICROBIT_LOG_STATUS_BINARY)
     {
-        if (!(status & MICROBIT_LOG_STATUS_FULL))
+        // Binary logs begin with the script MY_DATA.HTM uses to render them.
+        if (dataEnd == dataStart && commitLength == 0)
+            _writeData((const char *) viewer, viewerLength);
+
+        uint32_t required = 3 * len + 16;
+
+        if (required > recordBufferSize)
         {
-            cache.write(logEnd+1, "FUL", 3);
-            status |= MICROBIT_LOG_STATUS_FULL;
+            uint8_t *b = (uint8_t *) realloc(recordBuffer, required);
+            if (b == NULL)
+                return DEVICE_NO_RESOURCES;
+
+            recordBuffer = b;
+            recordBufferSize = required;
         }
 
-        Event(MICROBIT_ID_LOG, MICROBIT_LOG_EVT_LOG_FULL);
-        return DEVICE_NO_RESOURCES;
+        len = encodeRecords(s, len, timeColumn, recordBuffer);
+        s = (const char *) recordBuffer;
     }
 
-    ManagedString cleaned = cleanBuffer(data, l, false);
-    if (cleaned.length())
-        data = cleaned.toCharArray();
-
     // If requested, log the data over the serial port
-    if (status & MICROBIT_LOG_STATUS_SERIAL_MIRROR && l > 0)
+    if (status & MICROBIT_LOG_STATUS_SERIAL_MIRROR && textLength > 0)
     {
-        serial.send((uint8_t *)data, l-1);
+        serial.send((uint8_t *)text, textLength-1);
         serial.send((uint8_t *)"\r\n", 2);
     }
 
-    while (l > 0)
+    // If the data will not fit alongside that already pending, write out what we have
+    // and let _writeData() determine if the log is now full.
+    if (len > logEnd - dataEnd - commitLength)
     {
-        uint32_t spaceOnPage = flash.getPageSize() - (dataEnd % flash.getPageSize());
-        //DMESG("SPACE_ON_PAGE: %d", spaceOnPage);
-        int lengthToWrite = min(l, spaceOnPage);
+        _flush();
+        return _writeData(s, len);
+    }
 
-        // If we're going to fill (or overspill) the current page, erase the next one ready for use.
-        if (spaceOnPage <= l && dataEnd+spaceOnPage < logEnd)
-        {
-            uint32_t nextPage = ((dataEnd / flash.getPageSize()) + 1) * flash.getPageSize();
+    // In write through mode, or if the data is larger than the commit buffer, write it immediately.
+    if (commitSize == 0 || len > commitSize)
+    {
+        _flush();
+        return _writeData(s, len);
+    }
 
-            //DMESG("   ERASING PAGE %p", nextPage);
-            flash.erase(nextPage);
-        }
+    if (commitBuffer == NULL)
+    {
+        commitBuffer = (char *) malloc(commitSize);
 
-        // Perform a write through cache update
-        //DMESG("   WRITING [ADDRESS: %p] [LENGTH: %d] ", dataEnd, lengthToWrite);
-        cache.write(dataEnd, data, lengthToWrite);
+        if (commitBuffer == NULL)
+            return _writeData(s, len);
+    }
 
-        // move on pointers
-        dataEnd += lengthToWrite;
-        data += lengthToWrite;
-        l -= lengthToWrite;
+    if (!(status & MICROBIT_LOG_STATUS_LISTENING) && EventModel::defaultEventBus)
+    {
+        // Commit before power is removed or reduced. These handlers must run before the power manager proceeds.
+        EventModel::defaultEventBus->listen(power.id, MICROBIT_POWER_MANAGER_EVT_POWER_OFF, this, &MicroBitLog::commitEvent, MESSAGE_BUS_LISTENER_IMMEDIATE);
+        EventModel::defaultEventBus->listen(power.id, MICROBIT_POWER_MANAGER_EVT_DEEP_SLEEP, this, &MicroBitLog::commitEvent, MESSAGE_BUS_LISTENER_IMMEDIATE);
+        EventModel::defaultEventBus->listen(MICROBIT_ID_LOG, MICROBIT_LOG_EVT_COMMIT, this, &MicroBitLog::commitEvent);
+        status |= MICROBIT_LOG_STATUS_LISTENING;
+    }
+
+    if (commitLength + len > commitSize)
+        _flush();
+
+    // Bound the time data spends in RAM. The timer is cancelled if the data is committed sooner.
+    if (commitLength == 0 && commitDelay)
+    {
+        commitTime = system_timer_current_time();
+        system_timer_event_after(commitDelay, MICROBIT_ID_LOG, MICROBIT_LOG_EVT_COMMIT);
+    }
+
+    memcpy(&commitBuffer[commitLength], s, len);
+    commitLength += len;
+
+    if (commitLength == commitSize)
+        return _flush();
+
+    return DEVICE_OK;
+}
+
+/**
+ * Writes any data held in RAM by group commit mode to storage, as a single write and journal update.
+ *
+ * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if the log is full.
+ */
+int MicroBitLog::_flush()
+{
+    if (commitLength == 0)
+        return DEVICE_OK;
+
+    if (commitDelay)
+        system_timer_cancel_event(MICROBIT_ID_LOG, MICROBIT_LOG_EVT_COMMIT);
+
+    uint32_t l = commitLength;
+    commitLength = 0;
+
+    return _writeData(commitBuffer, l);
+}
+
+/**
+ * Writes the given data to storage, and updates the journal if necessary.
+ *
+ * @param s the data to write.
+ * @param len the length of the data, in bytes.
+ */
+int MicroBitLog::_writeData(const char *s, uint32_t len)
+{
+    uint32_t oldDataEnd = dataEnd;
+    uint32_t l = len;
+    const char *data = s;
+
+    // If this is the first log entry written, ensure that the file visibility is activated.
+    // (it may have been disabled following a full erase)
+    if (dataStart == dataEnd)
+        _setVisibility(true);
+
+    // If we can't write a whole line of data, then treat the log as full.
+    // Binary records may hold timestamps relative to data that could not be written, so binary logs then accept nothing further.
+    if (l > logEnd - dataEnd || ((status & MICROBIT_LOG_STATUS_BINARY) && (status & MICROBIT_LOG_STATUS_FULL)))
+    {
+        if (!(status & MICROBIT_LOG_STATUS_FULL))
+        {
+            cache.write(logEnd+1, "FUL", 3);
+            status |= MICROBIT_LOG_STATUS_FULL;
+        }
+
+        Event(MICROBIT_ID_LOG, MICROBIT_LOG_EVT_LOG_FULL);
+        return DEVICE_NO_RESOURCES;
+    }
+
+    while (l > 0)
+    {
+        uint32_t spaceOnPage = flash.getPageSize() - (dataEnd % flash.getPageSize());
+        //DMESG("SPACE_ON_PAGE: %d", spaceOnPage);
+        int lengthToWrite = min(l, spaceOnPage);
+
+        // If we're going to fill (or overspill) the current page, erase the next one ready for use.
+        if (spaceOnPage <= l && dataEnd+spaceOnPage < logEnd)
+        {
+            uint32_t nextPage = ((dataEnd / flash.getPageSize()) + 1) * flash.getPageSize();
+
+            //DMESG("   ERASING PAGE %p", nextPage);
+            cache.erase(nextPage);
+            flash.erase(nextPage);
+        }
+
+        // Perform a write through cache update
+        //DMESG("   WRITING [ADDRESS: %p] [LENGTH: %d] ", dataEnd, lengthToWrite);
+        cache.write(dataEnd, data, lengthToWrite);
+
+        if (status & MICROBIT_LOG_STATUS_ROW_INDEX)
+            indexRows(dataEnd, data, lengthToWrite);
+
+        // move on pointers
+        dataEnd += lengthToWrite;
+        data += lengthToWrite;
+        l -= lengthToWrite;
     }
 
     // Write a new entry into the log journal if we crossed a cache block boundary
@@ -855,14 +1774,16 @@ int MicroBitLog::_logString(ManagedString s)
  * this method has no effect.
  * 
  * @param key the heading to add
- * @param value the initial value to add, or ManagedString::EmptyString
  * @param head true to add the given field at the front of the list, false to add at the end.
+ * @return the index of the column holding the given heading.
  */
-void MicroBitLog::addHeading(ManagedString key, ManagedString value, bool head)
+int MicroBitLog::addHeading(ManagedString key, bool head)
 {
-    for (uint32_t i=0; i<headingCount; i++)
-        if (rowData[i].key == key)
-            return;
+    uint16_t hash = hashKey(key.toCharArray(), key.length());
+    int column = findColumn(key.toCharArray(), key.length(), hash);
+
+    if (column >= 0)
+        return column;
 
     ColumnEntry* newRowData = (ColumnEntry *) malloc(sizeof(ColumnEntry) * (headingCount+1));
     int columnShift = head ? 1 : 0;
@@ -871,10 +1792,8 @@ void MicroBitLog::addHeading(ManagedString key, ManagedString value, bool head)
     for (uint32_t i=0; i<headingCount; i++)
     {
         new (&newRowData[i+columnShift]) ColumnEntry;
-        newRowData[i+columnShift].key = rowData[i].key;
-        newRowData[i+columnShift].value = rowData[i].value;
+        newRowData[i+columnShift] = rowData[i];
         rowData[i].key = ManagedString::EmptyString;
-        rowData[i].value = ManagedString::EmptyString;
     }   
     
     if (rowData)
@@ -882,11 +1801,13 @@ void MicroBitLog::addHeading(ManagedString key, ManagedString value, bool head)
 
     new (&newRowData[newColumn]) ColumnEntry;
     newRowData[newColumn].key = key;
-    newRowData[newColumn].value = value;
+    newRowData[newColumn].hash = hash;
     headingCount++;
 
     rowData = newRowData;
     headingsChanged = true;
+
+    return newColumn;
 }
 
 /**
@@ -921,9 +1842,273 @@ void MicroBitLog::_invalidate()
         flash.write(logEnd, (uint32_t *) &m, 1);
     }
 
+    commitLength = 0;
     status &= ~MICROBIT_LOG_STATUS_INITIALIZED; 
 }
 
+/**
+ * Selects the format rows are stored in. The binary format stores typed values, with numbers as varints
+ * and timestamps as the difference from the previous row. Rows repeating the columns of the last are stored
+ * without their types. Typical sensor data fits two to two and a half times as many rows into the log.
+ * All APIs that read the log render binary data as CSV text identical to that of the text format.
+ *
+ * The copy of MY_DATA.HTM on the MICROBIT drive is served directly from storage by the interface chip.
+ * Binary logs store a short script ahead of their data, which renders it as CSV text when the page is opened.
+ *
+ * An existing log keeps its format until cleared, unless it is empty, in which case it is reformatted immediately.
+ *
+ * @param format LogFormat::Text (the default), or LogFormat::Binary.
+ */
+void MicroBitLog::setStorageFormat(LogFormat format)
+{
+    mutex.wait();
+
+    storageFormat = format;
+    init();
+
+    // The format is recorded in the metadata, which can only be changed by reformatting. Nothing is lost if the log is empty.
+    bool binary = (status & MICROBIT_LOG_STATUS_BINARY) != 0;
+
+    if (binary != (format == LogFormat::Binary) && dataStart == dataEnd && commitLength == 0 && !(status & MICROBIT_LOG_STATUS_ROW_STARTED))
+        _clear(false);
+
+    mutex.notify();
+}
+
+/**
+ * Encodes text logged as CSV as binary records.
+ *
+ * @param s the text to encode. Any number of lines may be given.
+ * @param len the length of the text, in bytes.
+ * @param timeColumn the column of the timestamp, or -1 if there is none.
+ * @param out buffer to receive the records. Must be at least 3 * len + 16 bytes long.
+ * @return the length of the records, in bytes.
+ */
+uint32_t MicroBitLog::encodeRecords(const char *s, uint32_t len, int timeColumn, uint8_t *out)
+{
+    uint32_t length = 0;
+    int64_t n;
+
+    while (len)
+    {
+        // Each line is held in its own record, so that every row starts on a record boundary.
+        uint32_t lineLength = 0;
+        while (lineLength < len && s[lineLength] != '\n')
+            lineLength++;
+
+        uint32_t newline = lineLength < len ? 1 : 0;
+        uint32_t columns = 0;
+        uint64_t types = MICROBIT_LOG_NO_REPEAT;
+        bool numeric = false;
+        const char *v = s;
+
+        // Determine the type of each column.
+        for (uint32_t i = 0; i <= lineLength; i++)
+        {
+            if (i < lineLength && s[i] != ',')
+                continue;
+
+            uint8_t type = valueType(v, &s[i] - v, (int)columns == timeColumn, n);
+
+            if (type != MICROBIT_LOG_VALUE_EMPTY && type != MICROBIT_LOG_VALUE_STRING)
+                numeric = true;
+
+            if (columns < MICROBIT_LOG_REPEAT_COLUMNS)
+                types = (types & ~(0x0FULL << (columns * 4))) | ((uint64_t) type << (columns * 4));
+
+            columns++;
+            v = &s[i+1];
+        }
+
+        if (columns > MICROBIT_LOG_REPEAT_COLUMNS)
+            types = MICROBIT_LOG_NO_REPEAT;
+
+        // Lines without numbers (such as headings) are stored more compactly as text.
+        if (!numeric || !newline)
+        {
+            out[length++] = MICROBIT_LOG_RECORD_TEXT;
+            length += writeVarint(&out[length], lineLength + newline);
+            memcpy(&out[length], s, lineLength + newline);
+            length += lineLength + newline;
+        }
+        else
+        {
+            // Rows are typically logged with the same columns each time, so their types need only be stored once.
+            bool repeat = types != MICROBIT_LOG_NO_REPEAT && types == lastTypes;
+
+            if (repeat)
+            {
+                out[length++] = MICROBIT_LOG_RECORD_REPEAT;
+            }
+            else
+            {
+                out[length++] = MICROBIT_LOG_RECORD_ROW;
+                length += writeVarint(&out[length], columns);
+                lastTypes = types;
+            }
+
+            uint32_t column = 0;
+            v = s;
+
+            for (uint32_t i = 0; i <= lineLength; i++)
+            {
+                if (i < lineLength && s[i] != ',')
+                    continue;
+
+                int valueLength = &s[i] - v;
+                uint8_t type = valueType(v, valueLength, (int)column == timeColumn, n);
+
+                if (!repeat)
+                    length += writeVarint(&out[length], type);
+
+                if (type >= MICROBIT_LOG_VALUE_TIME)
+                {
+                    length += writeVarint(&out[length], zigzag(type < MICROBIT_LOG_VALUE_TIME_ABSOLUTE ? n - lastTime : n));
+                    lastTime = n;
+                    lastTimeValid = true;
+                }
+                else if (type == MICROBIT_LOG_VALUE_STRING)
+                {
+                    length += writeVarint(&out[length], valueLength);
+                    memcpy(&out[length], v, valueLength);
+                    length += valueLength;
+                }
+                else if (type != MICROBIT_LOG_VALUE_EMPTY)
+                {
+                    length += writeVarint(&out[length], zigzag(n));
+                }
+
+                column++;
+                v = &s[i+1];
+            }
+        }
+
+        s += lineLength + newline;
+        len -= lineLength + newline;
+    }
+
+    return length;
+}
+
+/**
+ * Determines the type a value is stored as in a binary log.
+ *
+ * @param s the text of the value.
+ * @param len the length of the text.
+ * @param time true if the value is in the timestamp column.
+ * @param n the value of a number or timestamp, without its decimal point.
+ * @return the type of the value, as one of the MICROBIT_LOG_VALUE_* types.
+ */
+uint8_t MicroBitLog::valueType(const char *s, int len, bool time, int64_t &n)
+{
+    if (len == 0)
+        return MICROBIT_LOG_VALUE_EMPTY;
+
+    int places = parseScaled(s, len, n);
+
+    if (places < 0 || n >= MICROBIT_LOG_MAX_NUMBER || n <= -MICROBIT_LOG_MAX_NUMBER)
+        return MICROBIT_LOG_VALUE_STRING;
+
+    if (time && (places == 0 || places == 2))
+        return (lastTimeValid ? MICROBIT_LOG_VALUE_TIME : MICROBIT_LOG_VALUE_TIME_ABSOLUTE) + places / 2;
+
+    return MICROBIT_LOG_VALUE_NUMBER + places;
+}
+
+/**
+ * Configures group commit mode. Rather than writing each row to storage as it is logged, rows are held
+ * in RAM and written together once maxBytes of data, or maxDelay milliseconds, have accumulated. This
+ * replaces several I2C transactions per row with a single write and journal update per group of rows.
+ *
+ * Pending data is committed automatically before MicroBitPowerManager powers off or deep sleeps the micro:bit,
+ * and before any data is read back from the log. If power is lost unexpectedly (e.g. the battery is removed
+ * or the reset button is pressed), at most the rows logged in the last maxDelay milliseconds, and never more
+ * than maxBytes bytes, are lost.
+ *
+ * @param maxBytes The maximum number of bytes to hold in RAM, or zero to write each row immediately (the default).
+ * @param maxDelay The maximum time, in milliseconds, a row is held in RAM before being written, or zero for no limit.
+ *
+ * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if pending data could not be written as the log is full.
+ */
+int MicroBitLog::setGroupCommit(uint32_t maxBytes, uint32_t maxDelay)
+{
+    int r;
+
+    mutex.wait();
+
+    // Write out anything held under the previous configuration.
+    r = _flush();
+
+    if (maxBytes != commitSize && commitBuffer)
+    {
+        free(commitBuffer);
+        commitBuffer = NULL;
+    }
+
+    commitSize = maxBytes;
+    commitDelay = maxDelay;
+
+    mutex.notify();
+
+    return r;
+}
+
+/**
+ * Writes any rows held in RAM by group commit mode to storage.
+ *
+ * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if the log is full.
+ */
+int MicroBitLog::flush()
+{
+    int r;
+
+    mutex.wait();
+    r = _flush();
+    mutex.notify();
+
+    return r;
+}
+
+/**
+ * Event handler callback. Commits any pending data when the group commit timer expires,
+ * or the micro:bit is about to be powered down.
+ */
+void MicroBitLog::commitEvent(Event e)
+{
+    if (e.source == MICROBIT_ID_LOG)
+    {
+        // A timer event may already have been queued when its rows were committed by other means.
+        // Only act on it if the rows now pending have been held for the full delay, as younger rows have a timer of their own.
+        if (commitLength && system_timer_current_time() - commitTime >= commitDelay)
+            flush();
+
+        return;
+    }
+
+    // Power down is imminent. This handler runs synchronously within the power manager, so rather than block it with
+    // flash and I2C operations, hold off power down whilst the pending rows are committed by a fiber of their own.
+    if (commitLength && !(status & MICROBIT_LOG_STATUS_COMMITTING))
+    {
+        status |= MICROBIT_LOG_STATUS_COMMITTING;
+        power.powerDownDisable();
+        create_fiber(MicroBitLog::commitFiber, this);
+    }
+}
+
+/**
+ * Fiber entry point used to commit pending data before power down, without blocking the power manager.
+ *
+ * @param log the MicroBitLog to commit.
+ */
+void MicroBitLog::commitFiber(void *log)
+{
+    MicroBitLog *l = (MicroBitLog *) log;
+
+    l->flush();
+    l->status &= ~MICROBIT_LOG_STATUS_COMMITTING;
+    l->power.powerDownEnable();
+}
+
 /**
  * Determines if a MicroMitLogFS header is present.
  *
@@ -973,10 +2158,11 @@ bool MicroBitLog::_isPresent()
     // This intentionally does not check the full LOG_VERSION string, but instead checks if there is a valid
     // version string _preamble_, aka 'UBIT_LOG_FS_V_' to avoid bugs where old flash logs are not detected
     // correctly and erase on a new flash event, as they don't match the version string _exactly_.
+    // Binary logs have a preamble of their own, so that firmware unaware of them never appends text to one.
     return ( dataStart >= journalStart + flash.getPageSize() &&
         dataStart < logEnd &&
         logEnd < flash.getFlashEnd() &&
-        memcmp(metaData.version, MICROBIT_LOG_VERSION, 14) == 0 );
+        (memcmp(metaData.version, MICROBIT_LOG_VERSION, 14) == 0 || memcmp(metaData.version, MICROBIT_LOG_VERSION_BINARY, 14) == 0) );
 }
 
 /**
@@ -1002,9 +2188,10 @@ uint32_t MicroBitLog::getDataLength(DataFormat format)
     uint32_t r = 0;
     mutex.wait();
     init();
+    _flush();
     uint32_t hdr = sizeof(header);
     uint32_t mtr = sizeof(MicroBitLogMetaData);
-    uint32_t csv = dataEnd - dataStart;
+    uint32_t csv = getCSVLength();
     switch (format)
     {
         case DataFormat::HTMLHeader:
@@ -1047,12 +2234,13 @@ int MicroBitLog::_readData(uint8_t *data, uint32_t index, uint32_t len, DataForm
     int r = DEVICE_OK;
     
     init();
+    _flush();
     
     uint32_t hdr = sizeof(header);
     uint32_t mtr = sizeof(MicroBitLogMetaData);
 
     // Check if there is less data than expected
-    uint32_t dataMax = dataEnd - dataStart;
+    uint32_t dataMax = getCSVLength();
     uint32_t dataLen = dataMax;
     switch (format)
     {
@@ -1068,12 +2256,8 @@ int MicroBitLog::_readData(uint8_t *data, uint32_t index, uint32_t len, DataForm
     if ( dataLen > dataMax)
         return DEVICE_INVALID_PARAMETER;
 
-    // Generate metadata without journal pages
-    // logEnd is reduced by the same amount as dataStart
-    // TODO Do we want the journal pages in the HTML?
-    MicroBitLogMetaData meta = metaData;
-    writeNum(meta.dataStart+2, hdr + mtr);
-    writeNum(meta.logEnd+2, logEnd - (dataStart - hdr - mtr));
+    MicroBitLogMetaData meta;
+    _getExportMetaData(meta);
 
     uint8_t end = 0xFF;
     
@@ -1125,7 +2309,7 @@ int MicroBitLog::_readSource( uint8_t *&data, uint32_t &index, uint32_t &len, ui
         if ( srcPtr)
             memcpy(data, (const uint8_t *) srcPtr + (index - srcIndex), length);
         else
-            r = cache.read( srcAddress + (index - srcIndex), data, length);
+            r = _readCSV( data, (srcAddress - dataStart) + (index - srcIndex), length);
     }
 
     if ( r == DEVICE_OK)
@@ -1139,6 +2323,217 @@ int MicroBitLog::_readSource( uint8_t *&data, uint32_t &index, uint32_t &len, ui
     return r;
 }
 
+/**
+ * Generate the metadata presented in the HTML file, which excludes the journal pages.
+ * @param meta the metadata to populate.
+ */
+void MicroBitLog::_getExportMetaData(MicroBitLogMetaData &meta)
+{
+    uint32_t hdr = sizeof(header);
+    uint32_t mtr = sizeof(MicroBitLogMetaData);
+
+    // Generate metadata without journal pages
+    // logEnd is reduced by the same amount as dataStart
+    // TODO Do we want the journal pages in the HTML?
+    meta = metaData;
+    memcpy(meta.version, MICROBIT_LOG_VERSION, 18);     // Binary logs are presented as CSV text.
+    writeNum(meta.dataStart+2, hdr + mtr);
+    writeNum(meta.logEnd+2, logEnd - (dataStart - hdr - mtr));
+}
+
+/**
+ * Streams the recorded data to the given sink, directly from the log's cache pages.
+ * Unlike readData(), no intermediate copies are made, and the sink controls the rate at which
+ * data is delivered. Data logged while an export is paused is included when it resumes.
+ *
+ * @param sink the consumer of the data.
+ * @param index the index into the data to start from. Updated to the index of the first byte not yet consumed.
+ * @param format the data format
+ *          DataFormat::HTMLHeader = 0,   - The HTML header without data
+ *          DataFormat::HTML = 1,               - The entire HTML file with data
+ *          DataFormat::CSV = 2                   - CSV data
+ *
+ * @return DEVICE_OK once all the data has been consumed, or DEVICE_BUSY if the sink applied back-pressure.
+ *         In that case, call again with the updated index to resume. DEVICE_INVALID_PARAMETER if the format is unknown.
+ */
+int MicroBitLog::exportData(MicroBitLogSink &sink, uint32_t &index, DataFormat format)
+{
+    int r = DEVICE_OK;
+
+    mutex.wait();
+    init();
+    _flush();
+
+    MicroBitLogMetaData meta;
+    _getExportMetaData(meta);
+
+    uint8_t end = 0xFF;
+    uint32_t pos = 0;
+
+    switch (format)
+    {
+        case DataFormat::HTMLHeader:
+            r = _exportSource(sink, index, pos, header, 0, sizeof(header));
+            if (r == DEVICE_OK)
+                r = _exportSource(sink, index, pos, &meta, 0, sizeof(meta));
+            if (r == DEVICE_OK)
+                r = _exportSource(sink, index, pos, &end, 0, sizeof(end));
+            break;
+        case DataFormat::HTML:
+            r = _exportSource(sink, index, pos, header, 0, sizeof(header));
+            if (r == DEVICE_OK)
+                r = _exportSource(sink, index, pos, &meta, 0, sizeof(meta));
+            if (r == DEVICE_OK)
+                r = _exportSource(sink, index, pos, NULL, dataStart, getCSVLength());
+            if (r == DEVICE_OK)
+                r = _exportSource(sink, index, pos, &end, 0, sizeof(end));
+            break;
+        case DataFormat::CSV:
+            r = _exportSource(sink, index, pos, NULL, dataStart, getCSVLength());
+            break;
+        default:
+            r = DEVICE_INVALID_PARAMETER;
+            break;
+    }
+
+    mutex.notify();
+    return r;
+}
+
+/**
+ * Stream the source data from local memory or interface flash to the given sink
+ * @param sink the consumer of the data
+ * @param index reference to the index into the data
+ * @param srcIndex reference to the index where the source data should begin
+ * @param srcPtr pointer to source data in local memory. NULL to use srcAddress
+ * @param srcAddress address of source data in interface flash. Ignored if srcPtr is not NULL.
+ * @param srcLen the length of the source data
+ * @return DEVICE_OK if the sink consumed all the data requested; DEVICE_BUSY if the sink applied back-pressure
+ * @note The referenced indices are updated ready for the next call
+ */
+int MicroBitLog::_exportSource(MicroBitLogSink &sink, uint32_t &index, uint32_t &srcIndex, const void *srcPtr, uint32_t srcAddress, uint32_t srcLen)
+{
+    uint32_t next = srcIndex + srcLen;
+    uint8_t text[64];
+    MicroBitLogCursor cursor;
+
+    while (index < next)
+    {
+        uint32_t offset = index - srcIndex;
+        uint32_t length = next - index;
+        const uint8_t *data;
+
+        if (srcPtr)
+        {
+            data = (const uint8_t *) srcPtr + offset;
+        }
+        else if (status & MICROBIT_LOG_STATUS_BINARY)
+        {
+            // Binary logs are rendered as CSV a chunk at a time. The read cursor is only moved on once the sink
+            // has consumed the whole chunk, so it never passes the export index.
+            uint32_t position = (srcAddress - dataStart) + offset;
+
+            if (length > sizeof(text))
+                length = sizeof(text);
+
+            if (seekCursor(position) != DEVICE_OK)
+                return DEVICE_NO_RESOURCES;
+
+            cursor = readCursor;
+            length = renderData(cursor, text, position, length);
+            data = text;
+
+            if (length == 0)
+                break;
+        }
+        else
+        {
+            // Hand the sink the cache page itself, one block at a time.
+            uint32_t address = srcAddress + offset;
+            uint32_t block = address - (address % CONFIG_MICROBIT_LOG_CACHE_BLOCK_SIZE);
+            uint32_t spaceInBlock = CONFIG_MICROBIT_LOG_CACHE_BLOCK_SIZE - (address - block);
+
+            if (length > spaceInBlock)
+                length = spaceInBlock;
+
+            data = cache.cachePage(block)->page + (address - block);
+        }
+
+        int consumed = sink.writeData(data, length);
+
+        if (consumed > 0)
+            index += consumed;
+
+        if (data == text && consumed == (int)length)
+            readCursor = cursor;
+
+        if (consumed < (int)length)
+            return DEVICE_BUSY;
+    }
+
+    srcIndex = next;
+    return DEVICE_OK;
+}
+
+/**
+ * A MicroBitLogSink that writes to a serial port, blocking until each region has been sent.
+ */
+class MicroBitLogSerialSink : public MicroBitLogSink
+{
+    NRF52Serial &serial;
+
+    public:
+    int error;          // The most recent error reported by the serial port, or DEVICE_OK.
+
+    MicroBitLogSerialSink(NRF52Serial &serial) : serial(serial), error(DEVICE_OK) {}
+
+    virtual int writeData(const uint8_t *data, uint32_t len) override
+    {
+        int r = serial.send((uint8_t *)data, len, SYNC_SLEEP);
+
+        if (r < 0)
+            error = r;
+
+        return r;
+    }
+};
+
+/**
+ * Streams the recorded data over the serial port. This blocks the calling fiber until complete.
+ *
+ * @param format the data format
+ *          DataFormat::HTMLHeader = 0,   - The HTML header without data
+ *          DataFormat::HTML = 1,               - The entire HTML file with data
+ *          DataFormat::CSV = 2                   - CSV data
+ *
+ * @return DEVICE_OK on success, or the serial port's error if it stops accepting data.
+ */
+int MicroBitLog::exportToSerial(DataFormat format)
+{
+    MicroBitLogSerialSink sink(serial);
+    uint32_t index = 0;
+    int r;
+
+    // The serial port blocks rather than applying back-pressure, so this only repeats if a send is cut short.
+    // Give up if no progress is made.
+    do
+    {
+        uint32_t start = index;
+        r = exportData(sink, index, format);
+
+        if (index == start)
+        {
+            if (r == DEVICE_BUSY && sink.error != DEVICE_OK)
+                r = sink.error;
+
+            break;
+        }
+
+    } while (r == DEVICE_BUSY);
+
+    return r;
+}
+
 /**
 * Get the number of rows (including the header) in the datalogger.
 * @param fromRowIndex 0-based index of starting row: bumped up to 0 if negative.
@@ -1146,31 +2541,19 @@ int MicroBitLog::_readSource( uint8_t *&data, uint32_t &index, uint32_t &len, ui
 */
 uint32_t MicroBitLog::getNumberOfRows(uint32_t fromRowIndex)
 {
-    constexpr uint8_t rowSeparator = 10; // newline char
-    uint32_t rowCount = 0;
-
-    uint32_t end = dataStart;
-    bool startRowFound = (fromRowIndex == 0) ? true : false;
-
-    // Read read until we see a 0xFF character (unused memory)
-    uint8_t c = 0;
-    while(c != 0xff)
-    { 
-        cache.read(end, &c, 1);
-        if (c == rowSeparator) {
-            rowCount++;
-            if (!startRowFound && fromRowIndex == rowCount) {
-                startRowFound = true;
-                rowCount = 0;
-            }
-        }
-        end++;
-    }
+    uint32_t r = 0;
 
-    // Will be the case if fromRowIndex is beyond the number of rows:
-    if (!startRowFound)
-        return 0;
-    return rowCount;
+    flush();
+
+    mutex.wait();
+    init();
+
+    // Will be zero if fromRowIndex is beyond the number of rows.
+    if (buildRowIndex() == DEVICE_OK && fromRowIndex <= rowCount)
+        r = rowCount - fromRowIndex;
+
+    mutex.notify();
+    return r;
 }
 
 /**
@@ -1181,51 +2564,308 @@ uint32_t MicroBitLog::getNumberOfRows(uint32_t fromRowIndex)
 */
 ManagedString MicroBitLog::getRows(uint32_t fromRowIndex, int nRows)
 {
-    if (fromRowIndex >= dataEnd || nRows <= 0)
+    flush();
+
+    mutex.wait();
+    init();
+
+    // fromRowIndex was beyond the datalogger:
+    if (buildRowIndex() != DEVICE_OK || fromRowIndex > rowCount || nRows <= 0)
+    {
+        mutex.notify();
         return ManagedString("", 0);
+    }
 
-    constexpr uint8_t rowSeparator = 10; // newline char in asci
-    const uint32_t rowSeparatorTargetCount = fromRowIndex + nRows;
+    uint32_t startOfRowN = findRow(fromRowIndex);
+    uint32_t endOfDataChunk = getCSVLength();
 
-    uint32_t startOfRowN = dataStart;
-    uint32_t endOfDataChunk = dataEnd;
-    
-    uint32_t end = dataStart;
-    uint32_t rowSeparatorCount = 0;
-    bool startRowFound = (fromRowIndex == 0) ? true : false;
-    
-    // Read until we see a 0xFF character (unused memory)
-    uint8_t c = 0;
-    while(c != 0xff)
+    // Exclude the separator of the last row requested, unless the request runs beyond the end of the log.
+    if (nRows <= (int)(rowCount - fromRowIndex))
+        endOfDataChunk = findRow(fromRowIndex + nRows) - 1;
+
+    const int dataLength = endOfDataChunk - startOfRowN;
+    char rows[dataLength];
+    _readCSV((uint8_t *) rows, startOfRowN, dataLength);
+
+    mutex.notify();
+    return ManagedString(rows, dataLength);
+}
+
+/**
+ * Ensures the row index is available, scanning the data region to rebuild it if necessary.
+ * Once built, the index is kept up to date as data is written.
+ *
+ * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if memory for the index could not be allocated.
+ */
+int MicroBitLog::buildRowIndex()
+{
+    if (status & MICROBIT_LOG_STATUS_ROW_INDEX)
+        return DEVICE_OK;
+
+    if (rowIndex == NULL)
+    {
+        rowIndex = (MicroBitLogRowIndexEntry *) malloc(sizeof(MicroBitLogRowIndexEntry) * CONFIG_MICROBIT_LOG_ROW_INDEX_SIZE);
+
+        if (rowIndex == NULL)
+            return DEVICE_NO_RESOURCES;
+    }
+
+    rowIndex[0].address = dataStart;
+    rowIndex[0].position = 0;
+    rowIndex[0].time = 0;
+    rowIndex[0].rowTypes = MICROBIT_LOG_NO_REPEAT;
+    rowIndexLength = 1;
+    rowIndexInterval = CONFIG_MICROBIT_LOG_ROW_INDEX_INTERVAL;
+    rowCount = 0;
+    csvLength = 0;
+    indexDecoder = MicroBitLogDecoder();
+
+    char buf[32];
+    uint32_t address = dataStart;
+
+    while (address < dataEnd)
+    {
+        uint32_t l = min(dataEnd - address, sizeof(buf));
+        cache.read(address, buf, l);
+        indexRows(address, buf, l);
+        address += l;
+    }
+
+    status |= MICROBIT_LOG_STATUS_ROW_INDEX;
+
+    return DEVICE_OK;
+}
+
+/**
+ * Updates the row index to account for the given data, which has been written to the log.
+ *
+ * @param address the logical address the data was written to.
+ * @param data the data written.
+ * @param len the length of the data, in bytes.
+ */
+void MicroBitLog::indexRows(uint32_t address, const char *data, uint32_t len)
+{
+    bool binary = status & MICROBIT_LOG_STATUS_BINARY;
+    char text[MICROBIT_LOG_DECODE_BUFFER_SIZE];
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        // Binary logs are decoded to track the length of their CSV text. A row ends with the text rendered by its last byte.
+        if (binary)
+        {
+            int n = indexDecoder.decode(data[i], text);
+            csvLength += n;
+
+            if (n == 0 || text[n-1] != '\n')
+                continue;
+        }
+        else if (data[i] != '\n')
+        {
+            continue;
+        }
+
+        rowCount++;
+
+        if (rowCount % rowIndexInterval)
+            continue;
+
+        // If the index is full, halve its resolution to make space. The index then remains a fixed size
+        // however large the log becomes, with the cost of a lookup bounded by the interval.
+        if (rowIndexLength == CONFIG_MICROBIT_LOG_ROW_INDEX_SIZE)
+        {
+            for (uint32_t j = 1; j < rowIndexLength / 2; j++)
+                rowIndex[j] = rowIndex[j * 2];
+
+            rowIndexLength /= 2;
+            rowIndexInterval *= 2;
+        }
+
+        MicroBitLogRowIndexEntry &e = rowIndex[rowIndexLength++];
+        e.address = address + i + 1;
+        e.position = binary ? csvLength : e.address - dataStart;
+        e.time = indexDecoder.time;
+        e.rowTypes = indexDecoder.rowTypes;
+    }
+}
+
+/**
+ * Determines the offset of the start of the given row in the CSV text, using the row index.
+ *
+ * @param row the 0-based index of the row. Must be no greater than rowCount.
+ * @return the offset of the first character of the row.
+ */
+uint32_t MicroBitLog::findRow(uint32_t row)
+{
+    // Seek to the nearest checkpoint, then scan forward over the remaining rows.
+    MicroBitLogRowIndexEntry &e = rowIndex[row / rowIndexInterval];
+    MicroBitLogDecoder decoder(e.time, e.rowTypes);
+    uint32_t address = e.address;
+    uint32_t position = e.position;
+    uint32_t remaining = row % rowIndexInterval;
+    bool binary = status & MICROBIT_LOG_STATUS_BINARY;
+    char buf[32];
+    char text[MICROBIT_LOG_DECODE_BUFFER_SIZE];
+
+    while (remaining)
+    {
+        uint32_t l = min(dataEnd - address, sizeof(buf));
+        if (l == 0)
+            break;
+
+        cache.read(address, buf, l);
+
+        for (uint32_t i = 0; i < l; i++)
+        {
+            int n = 1;
+            text[0] = buf[i];
+
+            if (binary)
+                n = decoder.decode(buf[i], text);
+
+            position += n;
+
+            if (n && text[n-1] == '\n' && --remaining == 0)
+                return position;
+        }
+
+        address += l;
+    }
+
+    return position;
+}
+
+/**
+ * Determines the length of the log data, once rendered as CSV text.
+ *
+ * @return the length of the CSV text, or zero if a binary log could not be indexed.
+ */
+uint32_t MicroBitLog::getCSVLength()
+{
+    if (!(status & MICROBIT_LOG_STATUS_BINARY))
+        return dataEnd - dataStart;
+
+    if (buildRowIndex() != DEVICE_OK)
+        return 0;
+
+    return csvLength;
+}
+
+/**
+ * Reads the log data as CSV text, rendering binary records if necessary.
+ *
+ * @param data the buffer to fill.
+ * @param position the offset into the CSV text to read from.
+ * @param len the number of characters to read. The range must lie within getCSVLength().
+ * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if a binary log could not be indexed.
+ */
+int MicroBitLog::_readCSV(uint8_t *data, uint32_t position, uint32_t len)
+{
+    if (!(status & MICROBIT_LOG_STATUS_BINARY))
+        return cache.read(dataStart + position, data, len);
+
+    if (seekCursor(position) != DEVICE_OK)
+        return DEVICE_NO_RESOURCES;
+
+    renderData(readCursor, data, position, len);
+
+    return DEVICE_OK;
+}
+
+/**
+ * Moves readCursor to the closest point in a binary log at or before the given offset in the CSV text.
+ *
+ * @param position the offset in the CSV text.
+ * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if the log could not be indexed.
+ */
+int MicroBitLog::seekCursor(uint32_t position)
+{
+    if (buildRowIndex() != DEVICE_OK)
+        return DEVICE_NO_RESOURCES;
+
+    // Find the last checkpoint at or before the position.
+    uint32_t low = 0;
+    uint32_t high = rowIndexLength;
+
+    while (high - low > 1)
+    {
+        uint32_t mid = (low + high) / 2;
+
+        if (rowIndex[mid].position <= position)
+            low = mid;
+        else
+            high = mid;
+    }
+
+    MicroBitLogRowIndexEntry &e = rowIndex[low];
+
+    // Sequential reads carry on from where the last one finished.
+    if (readCursor.address && readCursor.position <= position && readCursor.position >= e.position)
+        return DEVICE_OK;
+
+    readCursor.address = e.address;
+    readCursor.position = e.position;
+    readCursor.decoder = MicroBitLogDecoder(e.time, e.rowTypes);
+
+    return DEVICE_OK;
+}
+
+/**
+ * Renders part of a binary log as CSV text, advancing the given cursor.
+ * The cursor never moves past the end of the range requested, so can be used for the following range.
+ *
+ * @param cursor the position to render from, which must be at or before index.
+ * @param data the buffer to fill.
+ * @param index the offset into the CSV text of the first character to render.
+ * @param len the number of characters to render.
+ * @return the number of characters rendered, which is less than len only at the end of the log.
+ */
+uint32_t MicroBitLog::renderData(MicroBitLogCursor &cursor, uint8_t *data, uint32_t index, uint32_t len)
+{
+    uint32_t end = index + len;
+    char text[MICROBIT_LOG_DECODE_BUFFER_SIZE];
+
+    while (cursor.position < end && cursor.address < dataEnd)
     {
-        cache.read(end, &c, 1);
+        // Decode directly from the cache page, one block at a time.
+        uint32_t block = cursor.address - (cursor.address % CONFIG_MICROBIT_LOG_CACHE_BLOCK_SIZE);
+        uint32_t blockEnd = block + CONFIG_MICROBIT_LOG_CACHE_BLOCK_SIZE;
+        const uint8_t *page = cache.cachePage(block)->page;
+
+        if (blockEnd > dataEnd)
+            blockEnd = dataEnd;
+
+        while (cursor.address < blockEnd && cursor.position < end)
+        {
+            // The text of the last byte may run past the end of the range. If so, the decoder is restored to its state
+            // before that byte, leaving the cursor within the range, and the text is rendered again by the next read.
+            MicroBitLogDecoder before;
+            bool last = cursor.position + MICROBIT_LOG_DECODE_BUFFER_SIZE > end;
 
-        if (c == rowSeparator) {
-            rowSeparatorCount++;
-            if (!startRowFound && rowSeparatorCount == fromRowIndex) 
+            if (last)
+                before = cursor.decoder;
+
+            int n = cursor.decoder.decode(page[cursor.address - block], text);
+
+            for (int i = 0; i < n; i++)
             {
-                startRowFound = true;
-                startOfRowN = end + 1;
+                uint32_t p = cursor.position + i;
+
+                if (p >= index && p < end)
+                    data[p - index] = text[i];
             }
 
-            else if (rowSeparatorCount == rowSeparatorTargetCount) 
+            if (cursor.position + n > end)
             {
-                endOfDataChunk = end;
-                break;
+                cursor.decoder = before;
+                return len;
             }
-        }
 
-        end++;
+            cursor.position += n;
+            cursor.address++;
+        }
     }
 
-    // fromRowIndex was beyond the datalogger:
-    if (!startRowFound)
-        return ManagedString("", 0);
-
-    const int dataLength = endOfDataChunk - startOfRowN;
-    char rows[dataLength];
-    cache.read(startOfRowN, rows, dataLength);
-    return ManagedString(rows, dataLength);
+    return cursor.position > index ? cursor.position - index : 0;
 }
 
 /**
@@ -1244,4 +2884,7 @@ const uint8_t MicroBitLog::header[2048] = /*basic*/{0x3c,0x6d,0x65,0x74,0x61,0x2
 const uint8_t MicroBitLog::header[2048] = /*nextgen*/{0x3c,0x21,0x64,0x6f,0x63,0x74,0x79,0x70,0x65,0x20,0x68,0x74,0x6d,0x6c,0x3e,0x3c,0x6d,0x65,0x74,0x61,0x20,0x63,0x68,0x61,0x72,0x73,0x65,0x74,0x3d,0x75,0x74,0x66,0x2d,0x38,0x3e,0x3c,0x73,0x74,0x79,0x6c,0x65,0x3e,0x62,0x6f,0x64,0x79,0x7b,0x66,0x6f,0x6e,0x74,0x2d,0x66,0x61,0x6d,0x69,0x6c,0x79,0x3a,0x73,0x61,0x6e,0x73,0x2d,0x73,0x65,0x72,0x69,0x66,0x3b,0x6d,0x61,0x72,0x67,0x69,0x6e,0x3a,0x31,0x65,0x6d,0x7d,0x3c,0x2f,0x73,0x74,0x79,0x6c,0x65,0x3e,0x3c,0x73,0x63,0x72,0x69,0x70,0x74,0x3e,0x6c,0x65,0x74,0x20,0x77,0x3d,0x77,0x69,0x6e,0x64,0x6f,0x77,0x3b,0x77,0x2e,0x64,0x6c,0x3d,0x7b,0x6d,0x6f,0x64,0x65,0x3a,0x22,0x6e,0x65,0x78,0x74,0x67,0x65,0x6e,0x22,0x2c,0x6c,0x6f,0x61,0x64,0x3a,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,0x28,0x29,0x7b,0x7d,0x2c,0x68,0x61,0x6e,0x64,0x6c,0x65,0x42,0x6f,0x6f,0x74,0x73,0x74,0x72,0x61,0x70,0x45,0x72,0x72,0x6f,0x72,0x3a,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,0x28,0x29,0x7b,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,0x20,0x65,0x28,0x29,0x7b,0x64,0x6f,0x63,0x75,0x6d,0x65,0x6e,0x74,0x2e,0x71,0x75,0x65,0x72,0x79,0x53,0x65,0x6c,0x65,0x63,0x74,0x6f,0x72,0x28,0x22,0x23,0x76,0x22,0x29,0x2e,0x69,0x6e,0x6e,0x65,0x72,0x54,0x65,0x78,0x74,0x3d,0x22,0x41,0x6e,0x20,0x65,0x72,0x72,0x6f,0x72,0x20,0x6f,0x63,0x63,0x75,0x72,0x72,0x65,0x64,0x20,0x6c,0x6f,0x61,0x64,0x69,0x6e,0x67,0x20,0x74,0x68,0x65,0x20,0x70,0x61,0x67,0x65,0x2e,0x20,0x50,0x6c,0x65,0x61,0x73,0x65,0x20,0x63,0x68,0x65,0x63,0x6b,0x20,0x79,0x6f,0x75,0x72,0x20,0x69,0x6e,0x74,0x65,0x72,0x6e,0x65,0x74,0x20,0x63,0x6f,0x6e,0x6e,0x65,0x63,0x74,0x69,0x6f,0x6e,0x20,0x61,0x6e,0x64,0x20,0x72,0x65,0x6f,0x70,0x65,0x6e,0x20,0x74,0x68,0x69,0x73,0x20,0x66,0x69,0x6c,0x65,0x2e,0x22,0x7d,0x22,0x6c,0x6f,0x61,0x64,0x69,0x6e,0x67,0x22,0x21,0x3d,0x3d,0x64,0x6f,0x63,0x75,0x6d,0x65,0x6e,0x74,0x2e,0x72,0x65,0x61,0x64,0x79,0x53,0x74,0x61,0x74,0x65,0x3f,0x65,0x28,0x29,0x3a,0x64,0x6f,0x63,0x75,0x6d,0x65,0x6e,0x74,0x2e,0x61,0x64,0x64,0x45,0x76,0x65,0x6e,0x74,0x4c,0x69,0x73,0x74,0x65,0x6e,0x65,0x72,0x28,0x22,0x44,0x4f,0x4d,0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x4c,0x6f,0x61,0x64,0x65,0x64,0x22,0x2c,0x65,0x29,0x7d,0x7d,0x3b,0x63,0x6f,0x6e,0x73,0x74,0x20,0x61,0x3d,0x22,0x46,0x53,0x5f,0x53,0x54,0x41,0x52,0x54,0x22,0x3c,0x2f,0x73,0x63,0x72,0x69,0x70,0x74,0x3e,0x3c,0x62,0x61,0x73,0x65,0x20,0x68,0x72,0x65,0x66,0x3d,0x68,0x74,0x74,0x70,0x73,0x3a,0x2f,0x2f,0x64,0x61,0x74,0x61,0x2e,0x6d,0x69,0x63,0x72,0x6f,0x62,0x69,0x74,0x2e,0x6f,0x72,0x67,0x3e,0x3c,0x73,0x63,0x72,0x69,0x70,0x74,0x20,0x6f,0x6e,0x65,0x72,0x72,0x6f,0x72,0x3d,0x77,0x69,0x6e,0x64,0x6f,0x77,0x2e,0x64,0x6c,0x2e,0x68,0x61,0x6e,0x64,0x6c,0x65,0x42,0x6f,0x6f,0x74,0x73,0x74,0x72,0x61,0x70,0x45,0x72,0x72,0x6f,0x72,0x28,0x29,0x20,0x73,0x72,0x63,0x3d,0x76,0x33,0x2f,0x64,0x6c,0x2e,0x6a,0x73,0x3e,0x3c,0x2f,0x73,0x63,0x72,0x69,0x70,0x74,0x3e,0x3c,0x74,0x69,0x74,0x6c,0x65,0x3e,0x6d,0x69,0x63,0x72,0x6f,0x3a,0x62,0x69,0x74,0x20,0x64,0x61,0x74,0x61,0x20,0x6c,0x6f,0x67,0x3c,0x2f,0x74,0x69,0x74,0x6c,0x65,0x3e,0x3c,0x64,0x69,0x76,0x20,0x69,0x64,0x3d,0x77,0x3e,0x3c,0x68,0x31,0x3e,0x6d,0x69,0x63,0x72,0x6f,0x3a,0x62,0x69,0x74,0x20,0x64,0x61,0x74,0x61,0x20,0x6c,0x6f,0x67,0x3c,0x2f,0x68,0x31,0x3e,0x3c,0x70,0x20,0x69,0x64,0x3d,0x76,0x3e,0x4c,0x6f,0x61,0x64,0x69,0x6e,0x67,0x26,0x68,0x65,0x6c,0x6c,0x69,0x70,0x3b,0x3c,0x2f,0x64,0x69,0x76,0x3e,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x3c,0x21,0x2d,0x2d,0x46,0x53,0x5f,0x53,0x54,0x41,0x52,0x54};
 #else
     #error
-#endif
\ No newline at end of file
+#endif
+
+const uint8_t MicroBitLog::viewer[] = /*viewer*/{0x2d,0x2d,0x3e,0x3c,0x73,0x63,0x72,0x69,0x70,0x74,0x3e,0x28,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,0x28,0x29,0x7b,0x6c,0x65,0x74,0x20,0x64,0x3d,0x64,0x6f,0x63,0x75,0x6d,0x65,0x6e,0x74,0x2c,0x73,0x3d,0x64,0x2e,0x63,0x75,0x72,0x72,0x65,0x6e,0x74,0x53,0x63,0x72,0x69,0x70,0x74,0x3b,0x64,0x2e,0x61,0x64,0x64,0x45,0x76,0x65,0x6e,0x74,0x4c,0x69,0x73,0x74,0x65,0x6e,0x65,0x72,0x28,0x22,0x72,0x65,0x61,0x64,0x79,0x73,0x74,0x61,0x74,0x65,0x63,0x68,0x61,0x6e,0x67,0x65,0x22,0x2c,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,0x20,0x65,0x28,0x29,0x7b,0x64,0x2e,0x72,0x65,0x6d,0x6f,0x76,0x65,0x45,0x76,0x65,0x6e,0x74,0x4c,0x69,0x73,0x74,0x65,0x6e,0x65,0x72,0x28,0x22,0x72,0x65,0x61,0x64,0x79,0x73,0x74,0x61,0x74,0x65,0x63,0x68,0x61,0x6e,0x67,0x65,0x22,0x2c,0x65,0x29,0x3b,0x6c,0x65,0x74,0x20,0x67,0x3d,0x73,0x2e,0x70,0x72,0x65,0x76,0x69,0x6f,0x75,0x73,0x53,0x69,0x62,0x6c,0x69,0x6e,0x67,0x2c,0x72,0x3d,0x73,0x2e,0x6e,0x65,0x78,0x74,0x53,0x69,0x62,0x6c,0x69,0x6e,0x67,0x2c,0x61,0x3d,0x72,0x2e,0x64,0x61,0x74,0x61,0x2c,0x6f,0x3d,0x22,0x22,0x2c,0x6d,0x3d,0x30,0x2c,0x79,0x3d,0x5b,0x5d,0x2c,0x69,0x3d,0x31,0x2c,0x63,0x2c,0x76,0x3d,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,0x28,0x29,0x7b,0x6c,0x65,0x74,0x20,0x76,0x3d,0x30,0x2c,0x70,0x3d,0x31,0x3b,0x66,0x6f,0x72,0x28,0x3b,0x36,0x34,0x3e,0x28,0x63,0x3d,0x61,0x2e,0x63,0x68,0x61,0x72,0x43,0x6f,0x64,0x65,0x41,0x74,0x28,0x69,0x2b,0x2b,0x29,0x29,0x3b,0x29,0x76,0x2b,0x3d,0x28,0x63,0x2d,0x31,0x2d,0x28,0x63,0x3e,0x31,0x33,0x29,0x2d,0x28,0x63,0x3e,0x33,0x33,0x29,0x2d,0x28,0x63,0x3e,0x34,0x35,0x29,0x2d,0x28,0x63,0x3e,0x36,0x32,0x29,0x29,0x2a,0x70,0x2c,0x70,0x2a,0x3d,0x35,0x39,0x3b,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x76,0x2b,0x28,0x63,0x2d,0x36,0x34,0x29,0x2a,0x70,0x7d,0x2c,0x78,0x3d,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,0x28,0x6e,0x29,0x7b,0x6c,0x65,0x74,0x20,0x74,0x3d,0x69,0x3b,0x66,0x6f,0x72,0x28,0x3b,0x6e,0x3e,0x30,0x3b,0x29,0x63,0x3d,0x61,0x2e,0x63,0x68,0x61,0x72,0x43,0x6f,0x64,0x65,0x41,0x74,0x28,0x69,0x2b,0x2b,0x29,0x2c,0x6e,0x2d,0x3d,0x63,0x3c,0x31,0x32,0x38,0x3f,0x31,0x3a,0x63,0x3c,0x32,0x30,0x34,0x38,0x7c,0x7c,0x63,0x3e,0x3e,0x31,0x31,0x3d,0x3d,0x32,0x37,0x3f,0x32,0x3a,0x33,0x3b,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x61,0x2e,0x73,0x6c,0x69,0x63,0x65,0x28,0x74,0x2c,0x69,0x29,0x7d,0x2c,0x75,0x3d,0x66,0x75,0x6e,0x63,0x74,0x69,0x6f,0x6e,0x28,0x74,0x29,0x7b,0x69,0x66,0x28,0x21,0x74,0x29,0x72,0x65,0x74,0x75,0x72,0x6e,0x22,0x22,0x3b,0x69,0x66,0x28,0x31,0x30,0x3d,0x3d,0x74,0x29,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x78,0x28,0x76,0x28,0x29,0x29,0x3b,0x6c,0x65,0x74,0x20,0x6e,0x3d,0x76,0x28,0x29,0x2c,0x70,0x3d,0x74,0x2d,0x31,0x3b,0x6e,0x3d,0x6e,0x25,0x32,0x3f,0x2d,0x28,0x6e,0x2b,0x31,0x29,0x2f,0x32,0x3a,0x6e,0x2f,0x32,0x3b,0x74,0x3e,0x31,0x30,0x26,0x26,0x28,0x6d,0x3d,0x74,0x3e,0x31,0x32,0x3f,0x6e,0x3a,0x6d,0x2b,0x6e,0x2c,0x6e,0x3d,0x6d,0x2c,0x70,0x3d,0x28,0x74,0x2d,0x31,0x31,0x29,0x25,0x32,0x2a,0x32,0x29,0x3b,0x6c,0x65,0x74,0x20,0x66,0x3d,0x53,0x74,0x72,0x69,0x6e,0x67,0x28,0x4d,0x61,0x74,0x68,0x2e,0x61,0x62,0x73,0x28,0x6e,0x29,0x29,0x2e,0x70,0x61,0x64,0x53,0x74,0x61,0x72,0x74,0x28,0x70,0x2b,0x31,0x2c,0x22,0x30,0x22,0x29,0x3b,0x72,0x65,0x74,0x75,0x72,0x6e,0x28,0x6e,0x3c,0x30,0x3f,0x22,0x2d,0x22,0x3a,0x22,0x22,0x29,0x2b,0x28,0x70,0x3f,0x66,0x2e,0x73,0x6c,0x69,0x63,0x65,0x28,0x30,0x2c,0x2d,0x70,0x29,0x2b,0x22,0x2e,0x22,0x2b,0x66,0x2e,0x73,0x6c,0x69,0x63,0x65,0x28,0x2d,0x70,0x29,0x3a,0x66,0x29,0x7d,0x3b,0x66,0x6f,0x72,0x28,0x3b,0x69,0x3c,0x61,0x2e,0x6c,0x65,0x6e,0x67,0x74,0x68,0x26,0x26,0x36,0x35,0x35,0x33,0x33,0x21,0x3d,0x61,0x2e,0x63,0x68,0x61,0x72,0x43,0x6f,0x64,0x65,0x41,0x74,0x28,0x69,0x29,0x3b,0x29,0x7b,0x6c,0x65,0x74,0x20,0x74,0x3d,0x61,0x2e,0x63,0x68,0x61,0x72,0x43,0x6f,0x64,0x65,0x41,0x74,0x28,0x69,0x2b,0x2b,0x29,0x3b,0x69,0x66,0x28,0x38,0x34,0x3d,0x3d,0x74,0x29,0x6f,0x2b,0x3d,0x78,0x28,0x76,0x28,0x29,0x29,0x3b,0x65,0x6c,0x73,0x65,0x7b,0x6c,0x65,0x74,0x20,0x6b,0x3d,0x5b,0x5d,0x2c,0x6e,0x3d,0x79,0x2e,0x6c,0x65,0x6e,0x67,0x74,0x68,0x3b,0x38,0x32,0x3d,0x3d,0x74,0x26,0x26,0x28,0x6e,0x3d,0x76,0x28,0x29,0x2c,0x79,0x3d,0x5b,0x5d,0x29,0x3b,0x66,0x6f,0x72,0x28,0x6c,0x65,0x74,0x20,0x6a,0x3d,0x30,0x3b,0x6a,0x3c,0x6e,0x3b,0x6a,0x2b,0x2b,0x29,0x38,0x32,0x3d,0x3d,0x74,0x26,0x26,0x28,0x79,0x5b,0x6a,0x5d,0x3d,0x76,0x28,0x29,0x29,0x2c,0x6b,0x2e,0x70,0x75,0x73,0x68,0x28,0x75,0x28,0x79,0x5b,0x6a,0x5d,0x29,0x29,0x3b,0x6f,0x2b,0x3d,0x6b,0x2e,0x6a,0x6f,0x69,0x6e,0x28,0x22,0x2c,0x22,0x29,0x2b,0x22,0x5c,0x6e,0x22,0x7d,0x7d,0x6c,0x65,0x74,0x20,0x66,0x3d,0x67,0x2e,0x64,0x61,0x74,0x61,0x2c,0x6c,0x3d,0x70,0x61,0x72,0x73,0x65,0x49,0x6e,0x74,0x28,0x66,0x2e,0x73,0x75,0x62,0x73,0x74,0x72,0x28,0x32,0x36,0x2c,0x31,0x30,0x29,0x2c,0x31,0x36,0x29,0x2b,0x6f,0x2e,0x6c,0x65,0x6e,0x67,0x74,0x68,0x2d,0x28,0x73,0x2e,0x74,0x65,0x78,0x74,0x2e,0x6c,0x65,0x6e,0x67,0x74,0x68,0x2b,0x32,0x34,0x2b,0x69,0x29,0x3b,0x67,0x2e,0x64,0x61,0x74,0x61,0x3d,0x66,0x2e,0x73,0x6c,0x69,0x63,0x65,0x28,0x30,0x2c,0x32,0x30,0x29,0x2b,0x22,0x56,0x22,0x2b,0x66,0x2e,0x73,0x6c,0x69,0x63,0x65,0x28,0x32,0x31,0x2c,0x32,0x38,0x29,0x2b,0x28,0x22,0x30,0x30,0x30,0x30,0x30,0x30,0x30,0x22,0x2b,0x6c,0x2e,0x74,0x6f,0x53,0x74,0x72,0x69,0x6e,0x67,0x28,0x31,0x36,0x29,0x29,0x2e,0x73,0x6c,0x69,0x63,0x65,0x28,0x2d,0x38,0x29,0x2b,0x66,0x2e,0x73,0x6c,0x69,0x63,0x65,0x28,0x33,0x36,0x29,0x2b,0x6f,0x2b,0x61,0x2e,0x73,0x6c,0x69,0x63,0x65,0x28,0x69,0x29,0x2c,0x73,0x2e,0x72,0x65,0x6d,0x6f,0x76,0x65,0x28,0x29,0x2c,0x72,0x2e,0x72,0x65,0x6d,0x6f,0x76,0x65,0x28,0x29,0x7d,0x29,0x7d,0x29,0x28,0x29,0x3b,0x3c,0x2f,0x73,0x63,0x72,0x69,0x70,0x74,0x3e,0x3c,0x21,0x2d,0x2d,0xa};
+const uint32_t MicroBitLog::viewerLength = sizeof(MicroBitLog::viewer);
\ No newline at end of file
@@ -313,6 +313,13 @@ ManagedBuffer MicroBitPowerManager::readProperty(int property)
  */
 void MicroBitPowerManager::off()
 {
+    // Allow subsystems to commit any data held in RAM. They may hold off power down, for a limited time, whilst they do so.
+    Event(id, MICROBIT_POWER_MANAGER_EVT_POWER_OFF);
+
+    CODAL_TIMESTAMP start = system_timer_current_time();
+    while (!powerDownIsEnabled() && fiber_scheduler_running() && system_timer_current_time() - start < CONFIG_MAXIMUM_POWER_OFF_DELAY)
+        fiber_sleep(1);
+
     setPowerLED( true /*doSleep*/);
 
     // Update peripheral drivers
@@ -704,6 +711,10 @@ void MicroBitPowerManager::prepareDeepSleep()
 {
     if ( !fiber_scheduler_get_deepsleep_pending())
     {
+        // Allow subsystems to commit any data held in RAM, in case the micro:bit never wakes.
+        // This is raised before deep sleep is pending, so that work they defer to other fibers is able to run.
+        Event(id, MICROBIT_POWER_MANAGER_EVT_DEEP_SLEEP);
+
         fiber_scheduler_set_deepsleep_pending( true);
         listen();
         CodalComponent::deepSleepAll( deepSleepCallbackPrepare, NULL);
@@ -28,12 +28,21 @@ DEALINGS IN THE SOFTWARE.
 #include "CodalComponent.h"
 #include "ErrorNo.h"
 #include "CodalFiber.h"
+#include "Timer.h"
 #include "nrf.h"
 
 using namespace codal;
 
 const uint8_t MICROBIT_RADIO_POWER_LEVEL[] = {0xD8, 0xEC, 0xF0, 0xF4, 0xF8, 0xFC, 0x00, 0x04};
 
+// RADIO MODE register value and preamble length for each MICROBIT_RADIO_MODE_*. The 2Mbps PHYs use a 16 bit preamble.
+const uint8_t MICROBIT_RADIO_MODE_REGISTER[] = {RADIO_MODE_MODE_Nrf_1Mbit, RADIO_MODE_MODE_Nrf_2Mbit, RADIO_MODE_MODE_Ble_1Mbit, RADIO_MODE_MODE_Ble_2Mbit};
+const uint8_t MICROBIT_RADIO_MODE_PREAMBLE[] = {RADIO_PCNF0_PLEN_8bit, RADIO_PCNF0_PLEN_16bit, RADIO_PCNF0_PLEN_8bit, RADIO_PCNF0_PLEN_16bit};
+
+// CRC initial value and polynomial for each supported CRC length (1..3 bytes).
+const uint32_t MICROBIT_RADIO_CRC_INIT[] = {0xFF, 0xFFFF, 0x555555};
+const uint32_t MICROBIT_RADIO_CRC_POLY[] = {0x107, 0x11021, 0x100065B};
+
 /**
   * Provides a simple broadcast radio abstraction, built upon the raw nrf51822 RADIO module.
   *
@@ -71,6 +80,9 @@ extern "C" void RADIO_IRQHandler(void)
 
     if(NRF_RADIO->EVENTS_END)
     {
+#if CONFIG_ENABLED(MICROBIT_RADIO_INSTRUMENTATION)
+        uint32_t isrStart = (uint32_t) system_timer_current_time_us();
+#endif
         NRF_RADIO->EVENTS_END = 0;
         if(NRF_RADIO->CRCSTATUS == 1)
         {
@@ -90,10 +102,21 @@ extern "C" void RADIO_IRQHandler(void)
         else
         {
             MicroBitRadio::instance->setRSSI(0);
+            MicroBitRadio::instance->stats.rxCrcErrors++;
         }
 
         // Start listening and wait for the END event
         NRF_RADIO->TASKS_START = 1;
+
+#if CONFIG_ENABLED(MICROBIT_RADIO_INSTRUMENTATION)
+        uint32_t isrTime = (uint32_t) system_timer_current_time_us() - isrStart;
+        MicroBitRadioStatistics &stats = MicroBitRadio::instance->stats;
+
+        stats.isrCount++;
+        stats.isrTimeTotal += isrTime;
+        if (isrTime > stats.isrTimeMax)
+            stats.isrTimeMax = isrTime;
+#endif
     }
 }
 
@@ -105,17 +128,32 @@ extern "C" void RADIO_IRQHandler(void)
   * @note This class is demand activated, as a result most resources are only
   *       committed if send/recv or event registrations calls are made.
   */
-MicroBitRadio::MicroBitRadio(uint16_t id) : datagram(*this), event (*this)
+MicroBitRadio::MicroBitRadio(uint16_t id) : datagram(*this), event (*this), largeDatagram(*this), reliable(*this)
 {
     this->id = id;
     this->status = 0;
     this->band  = MICROBIT_RADIO_DEFAULT_FREQUENCY;
     this->power = MICROBIT_RADIO_DEFAULT_TX_POWER;
-    this->group = MICROBIT_RADIO_DEFAULT_GROUP;
-    this->queueDepth = 0;
+    this->groups[0] = MICROBIT_RADIO_DEFAULT_GROUP;
+    this->groupMask = 1;
+    this->mode = MICROBIT_RADIO_DEFAULT_MODE;
+    this->crcLength = MICROBIT_RADIO_DEFAULT_CRC_LENGTH;
+    this->whiteningIV = MICROBIT_RADIO_DEFAULT_WHITENING_IV;
     this->rssi = 0;
-    this->rxQueue = NULL;
-    this->rxBuf = NULL;
+    this->rxRing = NULL;
+    this->rxHead = 0;
+    this->rxTail = 0;
+    this->rxInUse = 0;
+    this->rxTimestamp = NULL;
+    this->macMode = MICROBIT_RADIO_MAC_NONE;
+    this->ccaThreshold = MICROBIT_RADIO_LBT_THRESHOLD;
+    this->tdmaSlot = 1;
+    this->tdmaSlotCount = 0;
+    this->tdmaSlotDuration = 0;
+    this->tdmaEpoch = 0;
+    this->txTimestamp = 0;
+
+    resetStatistics();
 
     instance = this;
 }
@@ -184,6 +222,370 @@ int MicroBitRadio::setFrequencyBand(int band)
     return DEVICE_OK;
 }
 
+/**
+  * Change the on-air mode (PHY) used by the radio.
+  *
+  * Running at 2Mbps halves the time each packet spends on air, reducing the chance of collisions
+  * in busy environments. Only micro:bits using the same mode can communicate with each other.
+  *
+  * @param mode One of MICROBIT_RADIO_MODE_NRF_1MBIT, MICROBIT_RADIO_MODE_NRF_2MBIT,
+  *             MICROBIT_RADIO_MODE_BLE_1MBIT or MICROBIT_RADIO_MODE_BLE_2MBIT.
+  *
+  * @return DEVICE_OK on success, or DEVICE_INVALID_PARAMETER if the mode is not supported,
+  *         or DEVICE_NOT_SUPPORTED if the BLE stack is running.
+  */
+int MicroBitRadio::setMode(int mode)
+{
+    if (ble_running())
+        return DEVICE_NOT_SUPPORTED;
+
+    // Only modes that carry a FrameBuffer as a plain length field and payload are supported.
+    // The long range (coded) PHYs need additional S0/CI/TERM fields, so are not compatible with this layout.
+    if (mode < MICROBIT_RADIO_MODE_NRF_1MBIT || mode > MICROBIT_RADIO_MODE_BLE_2MBIT)
+        return DEVICE_INVALID_PARAMETER;
+
+    this->mode = mode;
+    reconfigure();
+
+    return DEVICE_OK;
+}
+
+/**
+  * Change the length of the CRC appended to, and checked on, each packet.
+  *
+  * @param length The CRC length in bytes, in the range 1..3. Packets are only received if their CRC is valid,
+  *               so a CRC cannot be disabled.
+  *
+  * @return DEVICE_OK on success, or DEVICE_INVALID_PARAMETER if the value is out of range,
+  *         or DEVICE_NOT_SUPPORTED if the BLE stack is running.
+  */
+int MicroBitRadio::setCRCLength(int length)
+{
+    if (ble_running())
+        return DEVICE_NOT_SUPPORTED;
+
+    if (length < 1 || length > 3)
+        return DEVICE_INVALID_PARAMETER;
+
+    this->crcLength = length;
+    reconfigure();
+
+    return DEVICE_OK;
+}
+
+/**
+  * Change the initial value of the data whitening algorithm.
+  *
+  * @param iv The initial value, in the range 1..127.
+  *
+  * @return DEVICE_OK on success, or DEVICE_INVALID_PARAMETER if the value is out of range,
+  *         or DEVICE_NOT_SUPPORTED if the BLE stack is running.
+  */
+int MicroBitRadio::setWhiteningIV(int iv)
+{
+    if (ble_running())
+        return DEVICE_NOT_SUPPORTED;
+
+    // The whitening LFSR is 7 bits wide, and must not be seeded with zero.
+    if (iv < 1 || iv > 0x7F)
+        return DEVICE_INVALID_PARAMETER;
+
+    this->whiteningIV = iv;
+    reconfigure();
+
+    return DEVICE_OK;
+}
+
+/**
+  * Selects how the radio gains access to the channel before each transmission.
+  *
+  * Frames sent whilst received packets are being processed (such as acknowledgements) are always sent
+  * immediately, as they directly follow a frame that already holds the channel.
+  *
+  * @param mode One of MICROBIT_RADIO_MAC_NONE, MICROBIT_RADIO_MAC_LBT or MICROBIT_RADIO_MAC_TDMA.
+  *             In TDMA mode, transmissions are made using listen before talk until a beacon has been received.
+  *
+  * @return DEVICE_OK on success, or DEVICE_INVALID_PARAMETER if the mode is not supported.
+  */
+int MicroBitRadio::setMACMode(int mode)
+{
+    if (mode < MICROBIT_RADIO_MAC_NONE || mode > MICROBIT_RADIO_MAC_TDMA)
+        return DEVICE_INVALID_PARAMETER;
+
+    this->macMode = mode;
+
+    return DEVICE_OK;
+}
+
+/**
+  * Sets the signal strength above which the channel is considered busy when listening before talking.
+  *
+  * @param threshold The threshold in dBm, in the range -128..-30.
+  *
+  * @return DEVICE_OK on success, or DEVICE_INVALID_PARAMETER if the value is out of range.
+  */
+int MicroBitRadio::setCCAThreshold(int threshold)
+{
+    if (threshold < -128 || threshold > -30)
+        return DEVICE_INVALID_PARAMETER;
+
+    this->ccaThreshold = threshold;
+
+    return DEVICE_OK;
+}
+
+/**
+  * Sets the TDMA slot in which this micro:bit may transmit. The number and duration of the
+  * slots are determined by the beacons received from the coordinating micro:bit.
+  *
+  * @param slot The slot to use, in the range 1..255. Slot 0 is reserved for the coordinating micro:bit.
+  *
+  * @return DEVICE_OK on success, or DEVICE_INVALID_PARAMETER if the value is out of range, or lies beyond
+  * the end of the frame we are currently synchronised to.
+  */
+int MicroBitRadio::setTDMASlot(int slot)
+{
+    if (slot < 1 || slot > 255)
+        return DEVICE_INVALID_PARAMETER;
+
+    if ((status & MICROBIT_RADIO_STATUS_TDMA_SYNC) && slot >= tdmaSlotCount)
+        return DEVICE_INVALID_PARAMETER;
+
+    this->tdmaSlot = slot;
+
+    return DEVICE_OK;
+}
+
+/**
+  * Makes this micro:bit the TDMA coordinator, periodically transmitting beacons that other micro:bits
+  * synchronise their slots to. The coordinator transmits in slot 0, and is placed into MICROBIT_RADIO_MAC_TDMA mode.
+  *
+  * @param slotCount The number of slots in each frame, including the coordinator's slot, in the range 2..255.
+  *
+  * @param slotDuration The duration of each slot in milliseconds, in the range 2..1000.
+  *
+  * @return DEVICE_OK on success, or DEVICE_INVALID_PARAMETER if a value is out of range.
+  */
+int MicroBitRadio::startBeacon(int slotCount, int slotDuration)
+{
+    if (slotCount < 2 || slotCount > 255 || slotDuration < 2 || slotDuration > 1000)
+        return DEVICE_INVALID_PARAMETER;
+
+    this->tdmaSlot = 0;
+    this->tdmaSlotCount = slotCount;
+    this->tdmaSlotDuration = slotDuration;
+    this->macMode = MICROBIT_RADIO_MAC_TDMA;
+
+    // Ensure a beacon is sent on our next idle callback.
+    this->tdmaEpoch = (uint32_t) system_timer_current_time_us() - (uint32_t)slotCount * slotDuration * 1000;
+
+    status |= MICROBIT_RADIO_STATUS_BEACON | MICROBIT_RADIO_STATUS_TDMA_SYNC;
+
+    return DEVICE_OK;
+}
+
+/**
+  * Stops transmitting TDMA beacons.
+  *
+  * @return DEVICE_OK on success.
+  */
+int MicroBitRadio::stopBeacon()
+{
+    status &= ~(MICROBIT_RADIO_STATUS_BEACON | MICROBIT_RADIO_STATUS_TDMA_SYNC);
+    this->tdmaSlot = 1;
+
+    return DEVICE_OK;
+}
+
+/**
+  * Samples the channel until it is quiet, backing off for a random, exponentially increasing period whilst it is busy.
+  *
+  * @return DEVICE_OK if the channel is quiet, or DEVICE_BUSY if it remained busy.
+  */
+int MicroBitRadio::listenBeforeTalk()
+{
+    for (int attempt = 0; attempt < MICROBIT_RADIO_LBT_MAX_ATTEMPTS; attempt++)
+    {
+        // The receiver is already running, so sampling the signal strength on our channel takes only a few microseconds.
+        NRF_RADIO->EVENTS_RSSIEND = 0;
+        NRF_RADIO->TASKS_RSSISTART = 1;
+        while (NRF_RADIO->EVENTS_RSSIEND == 0);
+
+        if (-(int)NRF_RADIO->RSSISAMPLE < ccaThreshold)
+            return DEVICE_OK;
+
+        // The channel is busy. Back off for a random period, doubling the contention window on each attempt
+        // up to a limit. We sleep rather than spin, so that other fibers can run whilst we wait.
+        uint32_t backoff = (1 + microbit_random(1 << min(attempt + 1, MICROBIT_RADIO_LBT_MAX_BACKOFF_EXPONENT))) * MICROBIT_RADIO_LBT_BACKOFF_UNIT;
+        uint32_t start = (uint32_t) system_timer_current_time_us();
+
+        fiber_sleep(backoff);
+
+        stats.txBackoffs++;
+        stats.txBackoffTime += (uint32_t) system_timer_current_time_us() - start;
+    }
+
+    stats.txChannelBusy++;
+
+    return DEVICE_BUSY;
+}
+
+/**
+  * Waits until the current time falls within our TDMA slot.
+  * Returns immediately if we are not synchronised to a beacon.
+  *
+  * @return MICROBIT_OK on success, or MICROBIT_INVALID_PARAMETER if our slot does not exist in the current frame.
+  */
+int MicroBitRadio::waitForSlot()
+{
+    uint32_t start = (uint32_t) system_timer_current_time_us();
+
+    // A slot beyond the end of the frame would never come around, so refuse rather than transmit at a random time.
+    if ((status & MICROBIT_RADIO_STATUS_TDMA_SYNC) && tdmaSlot >= tdmaSlotCount)
+        return DEVICE_INVALID_PARAMETER;
+
+    while (status & MICROBIT_RADIO_STATUS_TDMA_SYNC)
+    {
+        uint32_t now = (uint32_t) system_timer_current_time_us();
+        uint32_t slotDuration = (uint32_t)tdmaSlotDuration * 1000;
+        uint32_t period = tdmaSlotCount * slotDuration;
+        uint32_t elapsed = now - tdmaEpoch;
+
+        // If we have missed several beacons, we can no longer trust our view of the frame.
+        if (!(status & MICROBIT_RADIO_STATUS_BEACON) && elapsed > 4 * period)
+        {
+            status &= ~MICROBIT_RADIO_STATUS_TDMA_SYNC;
+            break;
+        }
+
+        uint32_t offset = elapsed % period;
+        uint32_t slotStart = tdmaSlot * slotDuration;
+
+        if (offset >= slotStart && offset < slotStart + slotDuration - MICROBIT_RADIO_TDMA_GUARD_TIME)
+            break;
+
+        uint32_t wait = (slotStart + period - offset) % period;
+
+        // Sleep through most of a long wait, so other fibers can run, then wait precisely for the start of the slot.
+        if (wait > 2000)
+            fiber_sleep(wait / 1000 - 1);
+        else
+            system_timer_wait_us(wait);
+    }
+
+    stats.txSlotWaitTime += (uint32_t) system_timer_current_time_us() - start;
+
+    return DEVICE_OK;
+}
+
+/**
+  * Transmits a TDMA synchronisation beacon, and uses it as the start of the next frame.
+  */
+void MicroBitRadio::sendBeacon()
+{
+    FrameBuffer buf;
+    MicroBitRadioBeacon beacon;
+
+    beacon.slotDuration = tdmaSlotDuration;
+    beacon.slotCount = tdmaSlotCount;
+
+    buf.length = sizeof(MicroBitRadioBeacon) + MICROBIT_RADIO_HEADER_SIZE - 1;
+    buf.version = 1;
+    buf.group = 0;
+    buf.protocol = MICROBIT_RADIO_PROTOCOL_BEACON;
+    memcpy(buf.payload, &beacon, sizeof(MicroBitRadioBeacon));
+
+    // Receivers timestamp the beacon at the end of its reception, so we do the same at the end of its transmission.
+    if (send(&buf) == DEVICE_OK)
+        tdmaEpoch = txTimestamp;
+}
+
+/**
+  * Synchronises our TDMA frame to a received beacon.
+  *
+  * @param p The beacon frame.
+  *
+  * @param timestamp The time at which the beacon was received, in microseconds.
+  */
+void MicroBitRadio::beaconReceived(FrameBuffer *p, uint32_t timestamp)
+{
+    MicroBitRadioBeacon beacon;
+
+    // Ignore beacons from any other coordinator, or that are malformed.
+    if ((status & MICROBIT_RADIO_STATUS_BEACON) || p->length < sizeof(MicroBitRadioBeacon) + MICROBIT_RADIO_HEADER_SIZE - 1)
+        return;
+
+    memcpy(&beacon, p->payload, sizeof(MicroBitRadioBeacon));
+
+    if (beacon.slotCount < 2 || beacon.slotDuration < 2)
+        return;
+
+    tdmaSlotCount = beacon.slotCount;
+    tdmaSlotDuration = beacon.slotDuration;
+    tdmaEpoch = timestamp;
+
+    status |= MICROBIT_RADIO_STATUS_TDMA_SYNC;
+}
+
+/**
+  * Writes the on-air mode and packet format currently configured into the RADIO hardware.
+  *
+  * @note The RADIO must be disabled when this is called.
+  */
+void MicroBitRadio::configurePacketFormat()
+{
+    // Configure the on-air data rate. The default is Nordic's proprietary 1Mbps mode.
+    // This may sound excessive, but running a high data rates reduces the chances of collisions...
+    NRF_RADIO->MODE = MICROBIT_RADIO_MODE_REGISTER[mode];
+
+    // Packet layout configuration. The nrf51822 has a highly capable and flexible RADIO module that, in addition to transmission
+    // and reception of data, also contains a LENGTH field, two optional additional 1 byte fields (S0 and S1) and a CRC calculation.
+    // Configure the packet format for a simple 8 bit length field and no additional fields, matching the layout of a FrameBuffer.
+    NRF_RADIO->PCNF0 = (8 << RADIO_PCNF0_LFLEN_Pos) | ((uint32_t)MICROBIT_RADIO_MODE_PREAMBLE[mode] << RADIO_PCNF0_PLEN_Pos);
+    NRF_RADIO->PCNF1 = 0x02040000 | MICROBIT_RADIO_MAX_PACKET_SIZE;
+
+    // Most communication channels contain some form of checksum - a mathematical calculation taken based on all the data
+    // in a packet, that is also sent as part of the packet. When received, this calculation can be repeated, and the results
+    // from the sender and receiver compared. If they are different, then some corruption of the data ahas happened in transit,
+    // and we know we can't trust it. The nrf51822 RADIO uses a CRC for this - a very effective checksum calculation.
+    //
+    // Enable automatic CRC generation and checking (16 bit by default), and configure how the CRC is calculated.
+    NRF_RADIO->CRCCNF = crcLength;
+    NRF_RADIO->CRCINIT = MICROBIT_RADIO_CRC_INIT[crcLength - 1];
+    NRF_RADIO->CRCPOLY = MICROBIT_RADIO_CRC_POLY[crcLength - 1];
+
+    // Set the start random value of the data whitening algorithm. This can be any non zero number.
+    NRF_RADIO->DATAWHITEIV = whiteningIV;
+}
+
+/**
+  * Applies a change to the on-air mode or packet format, restarting the receiver if it is running.
+  */
+void MicroBitRadio::reconfigure()
+{
+    if (!(status & MICROBIT_RADIO_STATUS_INITIALISED))
+        return;
+
+    // We need to restart the radio for the change to take effect
+    NVIC_DisableIRQ(RADIO_IRQn);
+    NRF_RADIO->EVENTS_DISABLED = 0;
+    NRF_RADIO->TASKS_DISABLE = 1;
+    while (NRF_RADIO->EVENTS_DISABLED == 0);
+
+    configurePacketFormat();
+
+    // Reenable the radio to wait for the next packet
+    NRF_RADIO->EVENTS_READY = 0;
+    NRF_RADIO->TASKS_RXEN = 1;
+    while (NRF_RADIO->EVENTS_READY == 0);
+
+    NRF_RADIO->EVENTS_END = 0;
+    NRF_RADIO->TASKS_START = 1;
+
+    NVIC_ClearPendingIRQ(RADIO_IRQn);
+    NVIC_EnableIRQ(RADIO_IRQn);
+}
+
 /**
   * Retrieve a pointer to the currently allocated receive buffer. This is the area of memory
   * actively being used by the radio hardware to store incoming data.
@@ -192,57 +594,102 @@ int MicroBitRadio::setFrequencyBand(int band)
   */
 FrameBuffer* MicroBitRadio::getRxBuf()
 {
-    return rxBuf;
+    if (rxRing == NULL)
+        return NULL;
+
+    return &rxRing[rxHead];
 }
 
 /**
   * Attempt to queue a buffer received by the radio hardware, if sufficient space is available.
   *
-  * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if a replacement receiver buffer
-  *         could not be allocated (either by policy or memory exhaustion).
+  * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if no free buffer is available in the
+  *         receive ring, in which case the packet is dropped and the current buffer reused.
+  *
+  * @note should only be called from RADIO_IRQHandler...
   */
 int MicroBitRadio::queueRxBuf()
 {
-    if (rxBuf == NULL)
+    if (rxRing == NULL)
         return DEVICE_INVALID_PARAMETER;
 
-    if (queueDepth >= MICROBIT_RADIO_MAXIMUM_RX_BUFFERS)
+    uint8_t next = (rxHead + 1) % MICROBIT_RADIO_RX_BUFFERS;
+
+    // The next buffer must be neither awaiting processing nor still held by the application.
+    if (next == rxTail || (rxInUse & (1UL << next)))
+    {
+        stats.rxOverruns++;
         return DEVICE_NO_RESOURCES;
+    }
+
+    // Record which of our groups the packet was received on, as matched by the RADIO hardware.
+    rxRing[rxHead].group = groups[NRF_RADIO->RXMATCH & (MICROBIT_RADIO_MAX_GROUPS - 1)];
 
     // Store the received RSSI value in the frame
-    rxBuf->rssi = getRSSI();
+    rxRing[rxHead].rssi = getRSSI();
+    rxRing[rxHead].next = NULL;
 
-    // Ensure that a replacement buffer is available before queuing.
-    FrameBuffer *newRxBuf = new FrameBuffer();
+    // Timestamps are only needed to synchronise to TDMA beacons and to measure latency, so avoid reading the timer otherwise.
+#if CONFIG_ENABLED(MICROBIT_RADIO_INSTRUMENTATION)
+    rxTimestamp[rxHead] = (uint32_t) system_timer_current_time_us();
+#else
+    if (macMode == MICROBIT_RADIO_MAC_TDMA)
+        rxTimestamp[rxHead] = (uint32_t) system_timer_current_time_us();
+#endif
 
-    if (newRxBuf == NULL)
-        return DEVICE_NO_RESOURCES;
+    // Ensure the frame is complete before publishing it to the consumer.
+    __DMB();
+    rxHead = next;
 
-    // We add to the tail of the queue to preserve causal ordering.
-    rxBuf->next = NULL;
+    stats.rxPackets++;
 
-    if (rxQueue == NULL)
-    {
-        rxQueue = rxBuf;
-    }
-    else
-    {
-        FrameBuffer *p = rxQueue;
-        while (p->next != NULL)
-            p = p->next;
+    uint32_t depth = dataReady();
+    if (depth > stats.rxHighWaterMark)
+        stats.rxHighWaterMark = depth;
 
-        p->next = rxBuf;
-    }
+    return DEVICE_OK;
+}
 
-    // Increase our received packet count
-    queueDepth++;
+/**
+  * Returns a buffer previously handed out by recv() to the receive ring, so that the
+  * RADIO hardware may reuse it.
+  *
+  * @param buffer The buffer to release.
+  *
+  * @return DEVICE_OK on success, or DEVICE_INVALID_PARAMETER if the buffer is not part of the receive ring.
+  *
+  * @note This is called automatically when a received FrameBuffer is deleted.
+  */
+int MicroBitRadio::releaseRxBuf(FrameBuffer *buffer)
+{
+    if (rxRing == NULL || buffer < rxRing || buffer >= rxRing + MICROBIT_RADIO_RX_BUFFERS)
+        return DEVICE_INVALID_PARAMETER;
 
-    // Allocate a new buffer for the receiver hardware to use. the old on will be passed on to higher layer protocols/apps.
-    rxBuf = newRxBuf;
+    rxInUse &= ~(1UL << (buffer - rxRing));
 
     return DEVICE_OK;
 }
 
+/**
+  * Resets all of the counters held in MicroBitRadio::stats to zero.
+  */
+void MicroBitRadio::resetStatistics()
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+  * Releases a FrameBuffer. Buffers taken from the radio's receive ring are handed back to the
+  * radio for reuse, any others are returned to the heap.
+  */
+void FrameBuffer::operator delete(void *p)
+{
+    if (MicroBitRadio::instance && MicroBitRadio::instance->releaseRxBuf((FrameBuffer *)p) == DEVICE_OK)
+        return;
+
+    ::operator delete(p);
+}
+
 /**
   * Sets the RSSI for the most recent packet.
   * The value is measured in -dbm. The higher the value, the stronger the signal.
@@ -292,11 +739,21 @@ int MicroBitRadio::enable()
     if (ble_running())
         return DEVICE_NOT_SUPPORTED;
 
-    // If this is the first time we've been enable, allocate out receive buffers.
-    if (rxBuf == NULL)
-        rxBuf = new FrameBuffer();
+    // If this is the first time we've been enable, allocate our receive buffers.
+    // These are never freed, so no memory is allocated or released as packets arrive.
+    if (rxRing == NULL)
+        rxRing = new FrameBuffer[MICROBIT_RADIO_RX_BUFFERS]();
+
+    if (rxRing == NULL)
+        return DEVICE_NO_RESOURCES;
+
+    if (rxTimestamp == NULL)
+        rxTimestamp = new uint32_t[MICROBIT_RADIO_RX_BUFFERS]();
 
-    if (rxBuf == NULL)
+    if (rxTimestamp == NULL)
+        return DEVICE_NO_RESOURCES;
+
+    if (largeDatagram.enable() != DEVICE_OK || reliable.enable() != DEVICE_OK)
         return DEVICE_NO_RESOURCES;
 
     // Enable the High Frequency clock on the processor. This is a pre-requisite for
@@ -305,50 +762,30 @@ int MicroBitRadio::enable()
     NRF_CLOCK->TASKS_HFCLKSTART = 1;
     while (NRF_CLOCK->EVENTS_HFCLKSTARTED == 0);
 
-    // Bring up the nrf RADIO module in Nordic's proprietary 1MBps packet radio mode.
+    // Bring up the nrf RADIO module in the configured packet radio mode (Nordic's proprietary 1MBps by default).
     NRF_RADIO->TXPOWER = (uint32_t)MICROBIT_RADIO_POWER_LEVEL[this->power];
     NRF_RADIO->FREQUENCY = (uint32_t)this->band;
 
-    // Configure for 1Mbps throughput.
-    // This may sound excessive, but running a high data rates reduces the chances of collisions...
-    NRF_RADIO->MODE = RADIO_MODE_MODE_Nrf_1Mbit;
-
     // Configure the addresses we use for this protocol. We run ANONYMOUSLY at the core.
     // A 40 bit addresses is used. The first 32 bits match the ASCII character code for "uBit".
     // Statistically, this provides assurance to avoid other similar 2.4GHz protocols that may be in the vicinity.
     // We also map the assigned 8-bit GROUP id into the PREFIX field. This allows the RADIO hardware to perform
     // address matching for us, and only generate an interrupt when a packet matching our group is received.
+    // Logical addresses 1..7 take their base from BASE1, so this is set identically to allow further groups to be received.
     NRF_RADIO->BASE0 = MICROBIT_RADIO_BASE_ADDRESS;
+    NRF_RADIO->BASE1 = MICROBIT_RADIO_BASE_ADDRESS;
 
-    // Join the default group. This will configure the remaining byte in the RADIO hardware module.
-    setGroup(this->group);
+    // Join the configured groups. This will configure the remaining byte of each address in the RADIO hardware module.
+    configureGroups();
 
-    // The RADIO hardware module supports the use of multiple addresses, but as we're running anonymously, we only need one.
-    // Configure the RADIO module to use the default address (address 0) for both send and receive operations.
+    // We always transmit on the default address (address 0), which carries the group set by setGroup().
     NRF_RADIO->TXADDRESS = 0;
-    NRF_RADIO->RXADDRESSES = 1;
 
-    // Packet layout configuration. The nrf51822 has a highly capable and flexible RADIO module that, in addition to transmission
-    // and reception of data, also contains a LENGTH field, two optional additional 1 byte fields (S0 and S1) and a CRC calculation.
-    // Configure the packet format for a simple 8 bit length field and no additional fields.
-    NRF_RADIO->PCNF0 = 0x00000008;
-    NRF_RADIO->PCNF1 = 0x02040000 | MICROBIT_RADIO_MAX_PACKET_SIZE;
-
-    // Most communication channels contain some form of checksum - a mathematical calculation taken based on all the data
-    // in a packet, that is also sent as part of the packet. When received, this calculation can be repeated, and the results
-    // from the sender and receiver compared. If they are different, then some corruption of the data ahas happened in transit,
-    // and we know we can't trust it. The nrf51822 RADIO uses a CRC for this - a very effective checksum calculation.
-    //
-    // Enable automatic 16bit CRC generation and checking, and configure how the CRC is calculated.
-    NRF_RADIO->CRCCNF = RADIO_CRCCNF_LEN_Two;
-    NRF_RADIO->CRCINIT = 0xFFFF;
-    NRF_RADIO->CRCPOLY = 0x11021;
-
-    // Set the start random value of the data whitening algorithm. This can be any non zero number.
-    NRF_RADIO->DATAWHITEIV = 0x18;
+    // Configure the data rate, packet layout, CRC and data whitening.
+    configurePacketFormat();
 
     // Set up the RADIO module to read and write from our internal buffer.
-    NRF_RADIO->PACKETPTR = (uint32_t)rxBuf;
+    NRF_RADIO->PACKETPTR = (uint32_t)getRxBuf();
 
     // Configure the hardware to issue an interrupt whenever a task is complete (e.g. send/receive).
     NRF_RADIO->INTENSET = 0x00000008;
@@ -404,10 +841,27 @@ int MicroBitRadio::disable()
     return DEVICE_OK;
 }
 
+/**
+  * Writes the groups we are listening to into the address matching registers of the RADIO hardware.
+  */
+void MicroBitRadio::configureGroups()
+{
+    uint32_t prefix[2] = {0, 0};
+
+    // Logical addresses 0..3 take their prefix from PREFIX0, and 4..7 from PREFIX1, one byte each.
+    for (int i = 0; i < MICROBIT_RADIO_MAX_GROUPS; i++)
+        prefix[i / 4] |= (uint32_t)groups[i] << ((i % 4) * 8);
+
+    NRF_RADIO->PREFIX0 = prefix[0];
+    NRF_RADIO->PREFIX1 = prefix[1];
+    NRF_RADIO->RXADDRESSES = groupMask;
+}
+
 /**
   * Sets the radio to listen to packets sent with the given group id.
   *
-  * @param group The group to join. A micro:bit can only listen to one group ID at any time.
+  * @param group The group to join. This is the group that packets are transmitted on. Use addGroup()
+  *              to listen to further groups at the same time.
   *
   * @return DEVICE_OK on success, or DEVICE_NOT_SUPPORTED if the BLE stack is running.
   */
@@ -417,24 +871,111 @@ int MicroBitRadio::setGroup(uint8_t group)
         return DEVICE_NOT_SUPPORTED;
 
     // Record our group id locally
-    this->group = group;
+    this->groups[0] = group;
 
     // Also append it to the address of this device, to allow the RADIO module to filter for us.
-    NRF_RADIO->PREFIX0 = (uint32_t)group;
+    configureGroups();
 
     return DEVICE_OK;
 }
 
+/**
+  * Additionally listens to packets sent with the given group id. The RADIO hardware performs the address
+  * matching, so up to MICROBIT_RADIO_MAX_GROUPS groups (including that given to setGroup()) can be received
+  * at no extra cost. The group a packet was received on is recorded in the group field of its FrameBuffer.
+  *
+  * @param group The group to listen to.
+  *
+  * @return DEVICE_OK on success, DEVICE_NO_RESOURCES if already listening to MICROBIT_RADIO_MAX_GROUPS groups,
+  *         or DEVICE_NOT_SUPPORTED if the BLE stack is running.
+  */
+int MicroBitRadio::addGroup(uint8_t group)
+{
+    if (ble_running())
+        return DEVICE_NOT_SUPPORTED;
+
+    int slot = -1;
+
+    for (int i = 0; i < MICROBIT_RADIO_MAX_GROUPS; i++)
+    {
+        if (groupMask & (1 << i))
+        {
+            if (groups[i] == group)
+                return DEVICE_OK;
+        }
+        else if (slot < 0)
+        {
+            slot = i;
+        }
+    }
+
+    if (slot < 0)
+        return DEVICE_NO_RESOURCES;
+
+    groups[slot] = group;
+    groupMask |= (1 << slot);
+    configureGroups();
+
+    return DEVICE_OK;
+}
+
+/**
+  * Stops listening to packets sent with a group id previously passed to addGroup().
+  *
+  * @param group The group to stop listening to.
+  *
+  * @return DEVICE_OK on success, DEVICE_INVALID_PARAMETER if the group was not added using addGroup(),
+  *         or DEVICE_NOT_SUPPORTED if the BLE stack is running.
+  */
+int MicroBitRadio::removeGroup(uint8_t group)
+{
+    if (ble_running())
+        return DEVICE_NOT_SUPPORTED;
+
+    // Logical address 0 is reserved for the group set by setGroup(), so is never removed.
+    for (int i = 1; i < MICROBIT_RADIO_MAX_GROUPS; i++)
+    {
+        if ((groupMask & (1 << i)) && groups[i] == group)
+        {
+            groupMask &= ~(1 << i);
+            configureGroups();
+            return DEVICE_OK;
+        }
+    }
+
+    return DEVICE_INVALID_PARAMETER;
+}
+
 /**
   * A background, low priority callback that is triggered whenever the processor is idle.
   * Here, we empty our queue of received packets, and pass them onto higher level protocol handlers.
   */
 void MicroBitRadio::idleCallback()
 {
-    // Walk the list of packets and process each one.
-    while(rxQueue)
+    // If we are the TDMA coordinator, start a new frame when the current one ends.
+    if ((status & MICROBIT_RADIO_STATUS_BEACON) && (uint32_t) system_timer_current_time_us() - tdmaEpoch >= (uint32_t)tdmaSlotCount * tdmaSlotDuration * 1000)
     {
-        FrameBuffer *p = rxQueue;
+        status |= MICROBIT_RADIO_STATUS_DISPATCHING;
+        sendBeacon();
+        status &= ~MICROBIT_RADIO_STATUS_DISPATCHING;
+    }
+
+    // Frames sent whilst we process received packets bypass the MAC layer.
+    status |= MICROBIT_RADIO_STATUS_DISPATCHING;
+
+    // Walk the queue of packets and process each one.
+    while(rxRing && rxTail != rxHead)
+    {
+        FrameBuffer *p = &rxRing[rxTail];
+
+#if CONFIG_ENABLED(MICROBIT_RADIO_INSTRUMENTATION)
+        uint32_t latency = (uint32_t) system_timer_current_time_us() - rxTimestamp[rxTail];
+
+        stats.latencyCount++;
+        stats.latencyTotal += latency;
+        if (latency > stats.latencyMax)
+            stats.latencyMax = latency;
+#endif
 
         switch (p->protocol)
         {
@@ -446,18 +987,36 @@ void MicroBitRadio::idleCallback()
                 event.packetReceived();
                 break;
 
+            case MICROBIT_RADIO_PROTOCOL_FRAGMENT:
+                largeDatagram.packetReceived();
+                break;
+
+            case MICROBIT_RADIO_PROTOCOL_RELIABLE:
+                reliable.packetReceived();
+                break;
+
+            case MICROBIT_RADIO_PROTOCOL_BEACON:
+                // Beacons are only timestamped, and so only meaningful, whilst we are in TDMA mode.
+                if (macMode == MICROBIT_RADIO_MAC_TDMA)
+                    beaconReceived(p, rxTimestamp[rxTail]);
+                break;
+
             default:
                 Event(DEVICE_ID_RADIO_DATA_READY, p->protocol);
         }
 
         // If the packet was processed, it will have been recv'd, and taken from the queue.
         // If this was a packet for an unknown protocol, it will still be there, so simply free it.
-        if (p == rxQueue)
+        if (rxTail != rxHead && p == &rxRing[rxTail])
         {
             recv();
             delete p;
         }
     }
+
+    status &= ~MICROBIT_RADIO_STATUS_DISPATCHING;
+
+    datagram.packetsProcessed();
 }
 
 /**
@@ -467,7 +1026,7 @@ void MicroBitRadio::idleCallback()
   */
 int MicroBitRadio::dataReady()
 {
-    return queueDepth;
+    return (rxHead - rxTail + MICROBIT_RADIO_RX_BUFFERS) % MICROBIT_RADIO_RX_BUFFERS;
 }
 
 /**
@@ -478,25 +1037,55 @@ int MicroBitRadio::dataReady()
   * @return The buffer containing the the packet. If no data is available, NULL is returned.
   *
   * @note Once recv() has been called, it is the callers responsibility to
-  *       delete the buffer when appropriate.
+  *       delete the buffer when appropriate. The buffer belongs to the receive ring,
+  *       so holding on to it reduces the number of packets that can be queued.
   */
 FrameBuffer* MicroBitRadio::recv()
 {
-    FrameBuffer *p = rxQueue;
+    FrameBuffer *p = NULL;
 
-    if (p)
-    {
-         // Protect shared resource from ISR activity
-        NVIC_DisableIRQ(RADIO_IRQn);
+    recvBatch(&p, 1);
 
-        rxQueue = rxQueue->next;
-        queueDepth--;
+    return p;
+}
 
-        // Allow ISR access to shared resource
-        NVIC_EnableIRQ(RADIO_IRQn);
+/**
+  * Retrieves up to the given number of packets from the receive buffer in a single operation.
+  * Packets are returned in the order they were received, and are dequeued.
+  *
+  * @param out An array of at least 'max' entries, into which pointers to the received packets are stored.
+  *
+  * @param max The maximum number of packets to retrieve.
+  *
+  * @return The number of packets stored in 'out', or DEVICE_INVALID_PARAMETER if the parameters are invalid.
+  *
+  * @note As with recv(), it is the callers responsibility to delete each buffer when appropriate.
+  */
+int MicroBitRadio::recvBatch(FrameBuffer **out, int max)
+{
+    if (out == NULL || max < 0)
+        return DEVICE_INVALID_PARAMETER;
+
+    if (rxRing == NULL)
+        return 0;
+
+    // The ISR only ever advances rxHead and we only ever advance rxTail, so no locking is needed.
+    // Mark the buffers as held before releasing their slots, so the ISR will not receive into them.
+    uint8_t tail = rxTail;
+    uint8_t head = rxHead;
+    int count = 0;
+
+    while (tail != head && count < max)
+    {
+        out[count++] = &rxRing[tail];
+        rxInUse |= (1UL << tail);
+        tail = (tail + 1) % MICROBIT_RADIO_RX_BUFFERS;
     }
 
-    return p;
+    __DMB();
+    rxTail = tail;
+
+    return count;
 }
 
 /**
@@ -518,6 +1107,21 @@ int MicroBitRadio::send(FrameBuffer *buffer)
     if (buffer->length > MICROBIT_RADIO_MAX_PACKET_SIZE + MICROBIT_RADIO_HEADER_SIZE - 1)
         return DEVICE_INVALID_PARAMETER;
 
+    // Gain access to the channel, if a MAC layer is in use.
+    if (macMode != MICROBIT_RADIO_MAC_NONE && (status & MICROBIT_RADIO_STATUS_INITIALISED) && !(status & MICROBIT_RADIO_STATUS_DISPATCHING))
+    {
+        int result = DEVICE_OK;
+
+        if (macMode == MICROBIT_RADIO_MAC_TDMA)
+            result = waitForSlot();
+
+        if (result == DEVICE_OK)
+            result = listenBeforeTalk();
+
+        if (result != DEVICE_OK)
+            return result;
+    }
+
     // Firstly, disable the Radio interrupt. We want to wait until the trasmission completes.
     NVIC_DisableIRQ(RADIO_IRQn);
 
@@ -539,8 +1143,10 @@ int MicroBitRadio::send(FrameBuffer *buffer)
     NRF_RADIO->EVENTS_END = 0;
     while(NRF_RADIO->EVENTS_END == 0);
 
+    txTimestamp = (uint32_t) system_timer_current_time_us();
+
     // Return the radio to using the default receive buffer
-    NRF_RADIO->PACKETPTR = (uint32_t) rxBuf;
+    NRF_RADIO->PACKETPTR = (uint32_t) getRxBuf();
 
     // Turn off the transmitter.
     NRF_RADIO->EVENTS_DISABLED = 0;
@@ -50,6 +50,30 @@ using namespace codal;
 MicroBitRadioDatagram::MicroBitRadioDatagram(MicroBitRadio &r) : radio(r)
 {
     this->rxQueue = NULL;
+    this->rxQueueTail = NULL;
+    this->queueDepth = 0;
+    this->eventPending = false;
+}
+
+/**
+  * Removes the first packet from the queue.
+  *
+  * @return the packet removed, or NULL if the queue is empty.
+  */
+FrameBuffer* MicroBitRadioDatagram::dequeue()
+{
+    FrameBuffer *p = rxQueue;
+
+    if (p)
+    {
+        rxQueue = p->next;
+        queueDepth--;
+
+        if (rxQueue == NULL)
+            rxQueueTail = NULL;
+    }
+
+    return p;
 }
 
 /**
@@ -70,8 +94,7 @@ int MicroBitRadioDatagram::recv(uint8_t *buf, int len)
         return DEVICE_INVALID_PARAMETER;
 
     // Take the first buffer from the queue.
-    FrameBuffer *p = rxQueue;
-    rxQueue = rxQueue->next;
+    FrameBuffer *p = dequeue();
 
     int l = min(len, p->length - (MICROBIT_RADIO_HEADER_SIZE - 1));
 
@@ -95,15 +118,68 @@ PacketBuffer MicroBitRadioDatagram::recv()
     if (rxQueue == NULL)
         return PacketBuffer::EmptyPacket;
 
-    FrameBuffer *p = rxQueue;
-    rxQueue = rxQueue->next;
+    FrameBuffer *p = dequeue();
+
+    PacketBuffer packet(p->payload, p->length - (MICROBIT_RADIO_HEADER_SIZE - 1), p->rssi);
+
+    delete p;
+    return packet;
+}
+
+/**
+  * Retreives packet payload data into the given buffer, along with the group it was received on.
+  *
+  * This allows datagrams from each of the groups added using MicroBitRadio::addGroup() to be told apart.
+  *
+  * @param group Set to the group the packet was received on, if a packet is available.
+  *
+  * @return the data received, or an empty PacketBuffer if no data is available.
+  */
+PacketBuffer MicroBitRadioDatagram::recvFrom(uint8_t *group)
+{
+    if (rxQueue == NULL)
+        return PacketBuffer::EmptyPacket;
+
+    FrameBuffer *p = dequeue();
 
     PacketBuffer packet(p->payload, p->length - (MICROBIT_RADIO_HEADER_SIZE - 1), p->rssi);
 
+    if (group)
+        *group = p->group;
+
     delete p;
     return packet;
 }
 
+/**
+  * Retrieves up to the given number of queued packets in a single operation.
+  *
+  * This allows all of the datagrams received in a burst to be processed from a single
+  * MICROBIT_RADIO_EVT_DATAGRAM event.
+  *
+  * @param out An array of at least 'max' PacketBuffers, into which the received data is stored.
+  *
+  * @param max The maximum number of packets to retrieve.
+  *
+  * @return The number of packets stored in 'out', or DEVICE_INVALID_PARAMETER if the parameters are invalid.
+  */
+int MicroBitRadioDatagram::recv(PacketBuffer *out, int max)
+{
+    if (out == NULL || max < 0)
+        return DEVICE_INVALID_PARAMETER;
+
+    int count = 0;
+    FrameBuffer *p;
+
+    while (count < max && (p = dequeue()) != NULL)
+    {
+        out[count++] = PacketBuffer(p->payload, p->length - (MICROBIT_RADIO_HEADER_SIZE - 1), p->rssi);
+        delete p;
+    }
+
+    return count;
+}
+
 /**
   * Transmits the given buffer onto the broadcast radio.
   *
@@ -173,32 +249,44 @@ int MicroBitRadioDatagram::send(ManagedString data)
 void MicroBitRadioDatagram::packetReceived()
 {
     FrameBuffer *packet = radio.recv();
-    int queueDepth = 0;
+
+    // The queue has always held one datagram more than MICROBIT_RADIO_MAXIMUM_RX_BUFFERS, so keep that capacity.
+    if (queueDepth > MICROBIT_RADIO_MAXIMUM_RX_BUFFERS)
+    {
+        radio.stats.rxDropped++;
+        delete packet;
+        return;
+    }
 
     // We add to the tail of the queue to preserve causal ordering.
     packet->next = NULL;
 
-    if (rxQueue == NULL)
-    {
+    if (rxQueueTail == NULL)
         rxQueue = packet;
-    }
     else
-    {
-        FrameBuffer *p = rxQueue;
-        while (p->next != NULL)
-        {
-            p = p->next;
-            queueDepth++;
-        }
-
-        if (queueDepth >= MICROBIT_RADIO_MAXIMUM_RX_BUFFERS)
-        {
-            delete packet;
-            return;
-        }
-
-        p->next = packet;
-    }
+        rxQueueTail->next = packet;
+
+    rxQueueTail = packet;
+    queueDepth++;
+
+#if CONFIG_ENABLED(MICROBIT_RADIO_DATAGRAM_BATCH_EVENTS)
+    eventPending = true;
+#else
+    Event(DEVICE_ID_RADIO, MICROBIT_RADIO_EVT_DATAGRAM);
+#endif
+}
+
+/**
+  * Called by the radio once it has finished processing a burst of received packets.
+  *
+  * If MICROBIT_RADIO_DATAGRAM_BATCH_EVENTS is enabled, a single MICROBIT_RADIO_EVT_DATAGRAM
+  * event is raised here for all the datagrams queued during that burst.
+  */
+void MicroBitRadioDatagram::packetsProcessed()
+{
+    if (!eventPending)
+        return;
 
+    eventPending = false;
     Event(DEVICE_ID_RADIO, MICROBIT_RADIO_EVT_DATAGRAM);
 }
@@ -52,6 +52,7 @@ using namespace codal;
 MicroBitRadioEvent::MicroBitRadioEvent(MicroBitRadio &r) : radio(r)
 {
     this->suppressForwarding = false;
+    this->groupFilter = MICROBIT_RADIO_GROUP_ANY;
 }
 
 /**
@@ -136,6 +137,25 @@ int MicroBitRadioEvent::ignore(uint16_t id, uint16_t value, EventModel &eventBus
     return eventBus.ignore(id, value, this, &MicroBitRadioEvent::eventReceived);
 }
 
+/**
+  * Restricts the events raised from the radio to those received on the given group.
+  *
+  * When listening to several groups via MicroBitRadio::addGroup(), this allows events to be
+  * taken from one group while the others are used for datagrams.
+  *
+  * @param group The group to accept events from, or MICROBIT_RADIO_GROUP_ANY (the default) to accept events from all groups.
+  *
+  * @return DEVICE_OK on success, or DEVICE_INVALID_PARAMETER if the group is out of range.
+  */
+int MicroBitRadioEvent::setGroupFilter(int group)
+{
+    if (group != MICROBIT_RADIO_GROUP_ANY && (group < 0 || group > 255))
+        return DEVICE_INVALID_PARAMETER;
+
+    groupFilter = group;
+
+    return DEVICE_OK;
+}
 
 /**
   * Protocol handler callback. This is called when the radio receives a packet marked as using the event protocol.
@@ -147,9 +167,12 @@ void MicroBitRadioEvent::packetReceived()
     FrameBuffer *p = radio.recv();
     Event *e = (Event *) p->payload;
 
-    suppressForwarding = true;
-    e->fire();
-    suppressForwarding = false;
+    if (groupFilter == MICROBIT_RADIO_GROUP_ANY || groupFilter == p->group)
+    {
+        suppressForwarding = true;
+        e->fire();
+        suppressForwarding = false;
+    }
 
     delete p;
 }
@@ -0,0 +1,296 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "MicroBitRadio.h"
+#include "MicroBitDevice.h"
+#include "Timer.h"
+
+using namespace codal;
+
+/**
+  * Provides datagrams larger than a single radio frame, built upon the MicroBitRadio.
+  *
+  * Datagrams of up to MICROBIT_RADIO_FRAGMENT_MAX_SIZE bytes are split into sequenced frames using the
+  * MICROBIT_RADIO_PROTOCOL_FRAGMENT protocol, and reassembled by the receiver. Reassembly uses a bounded number of
+  * buffers, and incomplete datagrams are discarded after MICROBIT_RADIO_FRAGMENT_TIMEOUT milliseconds of inactivity.
+  * As with MicroBitRadioDatagram, delivery is not guaranteed: if any fragment is lost, the whole datagram is lost.
+  *
+  * @note This API does not contain any form of encryption, authentication or authorisation. Its purpose is solely for use as a
+  * teaching aid to demonstrate how simple communications operates, and to provide a sandpit through which learning can take place.
+  * For serious applications, BLE should be considered a substantially more secure alternative.
+  */
+
+/**
+  * Constructor.
+  *
+  * Creates an instance of a MicroBitRadioLargeDatagram which offers the ability
+  * to broadcast binary messages larger than a single radio frame to other micro:bits in the vicinity.
+  *
+  * @param r The underlying radio module used to send and receive data.
+  */
+MicroBitRadioLargeDatagram::MicroBitRadioLargeDatagram(MicroBitRadio &r) : radio(r)
+{
+    this->messageId = 0;
+    this->reassembly = NULL;
+}
+
+/**
+  * Allocates the reassembly slots. This is called by MicroBitRadio::enable(), so that no memory
+  * is used unless the radio is.
+  *
+  * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if the memory could not be allocated.
+  */
+int MicroBitRadioLargeDatagram::enable()
+{
+    // Like the radio's receive buffers, this is never freed.
+    if (reassembly == NULL)
+        reassembly = new MicroBitRadioReassembly[MICROBIT_RADIO_FRAGMENT_SLOTS]();
+
+    return reassembly ? DEVICE_OK : DEVICE_NO_RESOURCES;
+}
+
+/**
+  * Finds the reassembly slot for the given datagram, allocating one if necessary.
+  * Incomplete datagrams that have timed out, or that have been superseded by a newer datagram
+  * from the same sender, are released as a side effect.
+  *
+  * @param header The header of a fragment of the datagram.
+  *
+  * @return The slot to use, or NULL if the datagram cannot be accepted.
+  */
+MicroBitRadioReassembly* MicroBitRadioLargeDatagram::getReassembly(MicroBitRadioFragmentHeader *header)
+{
+    uint32_t now = (uint32_t) system_timer_current_time();
+    MicroBitRadioReassembly *slot = NULL;
+
+    if (reassembly == NULL)
+        return NULL;
+
+    for (int i = 0; i < MICROBIT_RADIO_FRAGMENT_SLOTS; i++)
+    {
+        MicroBitRadioReassembly *r = &reassembly[i];
+
+        if (r->data.length() == 0)
+        {
+            if (slot == NULL)
+                slot = r;
+
+            continue;
+        }
+
+        // Fragments of a complete datagram are late retransmissions, which the caller discards as duplicates.
+        if (r->source == header->source && r->messageId == header->messageId)
+            return r->data.length() == header->length ? r : NULL;
+
+        // Complete datagrams are held until they are collected by recv().
+        if (r->remaining == 0)
+            continue;
+
+        if (r->source == header->source)
+        {
+            // A sender only transmits one datagram at a time, so any earlier datagram from it is now incomplete forever.
+            r->data = ManagedBuffer();
+        }
+        else if (now - r->lastActivity > MICROBIT_RADIO_FRAGMENT_TIMEOUT)
+        {
+            r->data = ManagedBuffer();
+        }
+
+        if (r->data.length() == 0 && slot == NULL)
+            slot = r;
+    }
+
+    if (slot == NULL)
+        return NULL;
+
+    slot->data = ManagedBuffer(header->length);
+
+    if (slot->data.length() != header->length)
+    {
+        slot->data = ManagedBuffer();
+        return NULL;
+    }
+
+    slot->source = header->source;
+    slot->messageId = header->messageId;
+    slot->remaining = header->count;
+    slot->lastActivity = now;
+    memset(slot->received, 0, sizeof(slot->received));
+
+    return slot;
+}
+
+/**
+  * Retrieves the next complete datagram, if one is available.
+  *
+  * @return the data received, or an empty ManagedBuffer if no data is available.
+  */
+ManagedBuffer MicroBitRadioLargeDatagram::recv()
+{
+    MicroBitRadioReassembly *oldest = NULL;
+
+    if (reassembly == NULL)
+        return ManagedBuffer();
+
+    // Return datagrams in the order in which they were completed.
+    for (int i = 0; i < MICROBIT_RADIO_FRAGMENT_SLOTS; i++)
+    {
+        MicroBitRadioReassembly *r = &reassembly[i];
+
+        if (r->data.length() != 0 && r->remaining == 0 && (oldest == NULL || (int32_t)(r->lastActivity - oldest->lastActivity) < 0))
+            oldest = r;
+    }
+
+    if (oldest == NULL)
+        return ManagedBuffer();
+
+    ManagedBuffer b = oldest->data;
+    oldest->data = ManagedBuffer();
+
+    return b;
+}
+
+/**
+  * Transmits the given buffer onto the broadcast radio, split into as many frames as necessary.
+  *
+  * This is a synchronous call that will wait until the transmission of all the frames
+  * has completed before returning.
+  *
+  * @param buffer The datagram contents to transmit.
+  *
+  * @param len The number of bytes to transmit.
+  *
+  * @return DEVICE_OK on success, or DEVICE_INVALID_PARAMETER if the buffer is invalid,
+  *         or the number of bytes to transmit is greater than `MICROBIT_RADIO_FRAGMENT_MAX_SIZE`.
+  */
+int MicroBitRadioLargeDatagram::send(uint8_t *buffer, int len)
+{
+    if (buffer == NULL || len <= 0 || len > MICROBIT_RADIO_FRAGMENT_MAX_SIZE)
+        return DEVICE_INVALID_PARAMETER;
+
+    MicroBitRadioFragmentHeader header;
+    FrameBuffer buf;
+
+    header.source = microbit_serial_number();
+    header.length = len;
+    header.messageId = messageId++;
+    header.count = (len + MICROBIT_RADIO_FRAGMENT_DATA_SIZE - 1) / MICROBIT_RADIO_FRAGMENT_DATA_SIZE;
+
+    buf.version = 1;
+    buf.group = 0;
+    buf.protocol = MICROBIT_RADIO_PROTOCOL_FRAGMENT;
+
+    for (int i = 0; i < header.count; i++)
+    {
+        header.index = i;
+        header.offset = i * MICROBIT_RADIO_FRAGMENT_DATA_SIZE;
+
+        int l = min(MICROBIT_RADIO_FRAGMENT_DATA_SIZE, len - header.offset);
+
+        buf.length = MICROBIT_RADIO_FRAGMENT_HEADER_SIZE + l + MICROBIT_RADIO_HEADER_SIZE - 1;
+        memcpy(buf.payload, &header, MICROBIT_RADIO_FRAGMENT_HEADER_SIZE);
+        memcpy(buf.payload + MICROBIT_RADIO_FRAGMENT_HEADER_SIZE, buffer + header.offset, l);
+
+        int result = radio.send(&buf);
+
+        if (result != DEVICE_OK)
+            return result;
+    }
+
+    return DEVICE_OK;
+}
+
+/**
+  * Transmits the given buffer onto the broadcast radio, split into as many frames as necessary.
+  *
+  * @param data The datagram contents to transmit.
+  *
+  * @return DEVICE_OK on success, or DEVICE_INVALID_PARAMETER if the buffer is invalid,
+  *         or the number of bytes to transmit is greater than `MICROBIT_RADIO_FRAGMENT_MAX_SIZE`.
+  */
+int MicroBitRadioLargeDatagram::send(ManagedBuffer data)
+{
+    return send(data.getBytes(), data.length());
+}
+
+/**
+  * Transmits the given buffer onto the broadcast radio, split into as many frames as necessary.
+  *
+  * @param data The datagram contents to transmit.
+  *
+  * @return DEVICE_OK on success, or DEVICE_INVALID_PARAMETER if the buffer is invalid,
+  *         or the number of bytes to transmit is greater than `MICROBIT_RADIO_FRAGMENT_MAX_SIZE`.
+  */
+int MicroBitRadioLargeDatagram::send(PacketBuffer data)
+{
+    return send(data.getBytes(), data.length());
+}
+
+/**
+  * Protocol handler callback. This is called when the radio receives a packet marked as a fragment.
+  *
+  * This function adds the fragment to its datagram, and queues the datagram for user reception once complete.
+  */
+void MicroBitRadioLargeDatagram::packetReceived()
+{
+    FrameBuffer *p = radio.recv();
+    MicroBitRadioFragmentHeader header;
+
+    int l = p->length - (MICROBIT_RADIO_HEADER_SIZE - 1) - MICROBIT_RADIO_FRAGMENT_HEADER_SIZE;
+    memcpy(&header, p->payload, MICROBIT_RADIO_FRAGMENT_HEADER_SIZE);
+
+    // Discard anything malformed, or larger than we are prepared to reassemble.
+    if (l < 0 || header.length == 0 || header.length > MICROBIT_RADIO_FRAGMENT_MAX_SIZE || header.index >= header.count || header.offset + l > header.length)
+    {
+        delete p;
+        return;
+    }
+
+    MicroBitRadioReassembly *r = getReassembly(&header);
+
+    if (r == NULL)
+    {
+        radio.stats.rxDropped++;
+        delete p;
+        return;
+    }
+
+    // Duplicate fragments, including those of datagrams already complete, are simply ignored.
+    if (r->received[header.index / 8] & (1 << (header.index % 8)))
+    {
+        delete p;
+        return;
+    }
+
+    r->received[header.index / 8] |= (1 << (header.index % 8));
+    memcpy(r->data.getBytes() + header.offset, p->payload + MICROBIT_RADIO_FRAGMENT_HEADER_SIZE, l);
+    r->remaining--;
+
+    r->lastActivity = (uint32_t) system_timer_current_time();
+    delete p;
+
+    if (r->remaining == 0)
+        Event(DEVICE_ID_RADIO, MICROBIT_RADIO_EVT_LARGE_DATAGRAM);
+}
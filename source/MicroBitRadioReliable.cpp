@@ -0,0 +1,476 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "MicroBitRadio.h"
+#include "MicroBitDevice.h"
+#include "CodalFiber.h"
+#include "Timer.h"
+
+using namespace codal;
+
+/**
+  * Provides reliable, acknowledged delivery of datagrams between pairs of micro:bits, built upon the MicroBitRadio.
+  *
+  * Each datagram is addressed to a single micro:bit, identified by its serial number, and carries a sequence number.
+  * The receiver acknowledges every datagram immediately, and the sender retransmits it if no acknowledgement arrives
+  * within a timeout adapted to the measured round trip time. Receivers keep a window of recently seen sequence numbers
+  * so that retransmissions are never delivered twice.
+  *
+  * @note This API does not contain any form of encryption, authentication or authorisation. Its purpose is solely for use as a
+  * teaching aid to demonstrate how simple communications operates, and to provide a sandpit through which learning can take place.
+  * For serious applications, BLE should be considered a substantially more secure alternative.
+  */
+
+/**
+  * Constructor.
+  *
+  * Creates an instance of a MicroBitRadioReliable which offers acknowledged delivery of
+  * datagrams to other micro:bits in the vicinity.
+  *
+  * @param r The underlying radio module used to send and receive data.
+  */
+MicroBitRadioReliable::MicroBitRadioReliable(MicroBitRadio &r) : radio(r)
+{
+    this->rxQueue = NULL;
+    this->rxQueueTail = NULL;
+    this->queueDepth = 0;
+    this->txBusy = false;
+    this->txAcked = false;
+    this->txDestination = 0;
+    this->txSequence = 0;
+    this->peers = NULL;
+}
+
+/**
+  * Allocates the state held for our peers. This is called by MicroBitRadio::enable(), so that no memory
+  * is used unless the radio is.
+  *
+  * @return DEVICE_OK on success, or DEVICE_NO_RESOURCES if the memory could not be allocated.
+  */
+int MicroBitRadioReliable::enable()
+{
+    // Like the radio's receive buffers, this is never freed.
+    if (peers == NULL)
+        peers = new MicroBitRadioPeer[MICROBIT_RADIO_RELIABLE_PEERS]();
+
+    return peers ? DEVICE_OK : DEVICE_NO_RESOURCES;
+}
+
+/**
+  * Finds the state held for the given peer.
+  *
+  * @param address The serial number of the peer.
+  *
+  * @param create If true and the peer is unknown, the least recently used entry is recycled for it.
+  *
+  * @return The peer, or NULL if it is unknown and either create is false or no entry can be recycled.
+  */
+MicroBitRadioPeer* MicroBitRadioReliable::getPeer(uint32_t address, bool create)
+{
+    MicroBitRadioPeer *oldest = NULL;
+
+    if (peers == NULL)
+        return NULL;
+
+    for (int i = 0; i < MICROBIT_RADIO_RELIABLE_PEERS; i++)
+    {
+        MicroBitRadioPeer *peer = &peers[i];
+
+        if (peer->flags & MICROBIT_RADIO_PEER_VALID)
+        {
+            if (peer->address == address)
+                return peer;
+
+            // Never recycle the peer we are waiting on an acknowledgement from.
+            if (txBusy && peer->address == txDestination)
+                continue;
+        }
+
+        if (oldest == NULL || !(peer->flags & MICROBIT_RADIO_PEER_VALID) ||
+            ((oldest->flags & MICROBIT_RADIO_PEER_VALID) && (int32_t)(peer->lastActivity - oldest->lastActivity) < 0))
+            oldest = peer;
+    }
+
+    if (!create || oldest == NULL)
+        return NULL;
+
+    memset(oldest, 0, sizeof(MicroBitRadioPeer));
+    oldest->address = address;
+    oldest->flags = MICROBIT_RADIO_PEER_VALID;
+    oldest->lastActivity = (uint32_t) system_timer_current_time();
+    oldest->stats.rto = MICROBIT_RADIO_RELIABLE_INITIAL_RTO * 1000;
+
+    // Start from a random sequence number, so a receiver is unlikely to mistake our datagrams
+    // for duplicates of those we sent before a reset.
+    oldest->txSequence = microbit_random(0x10000);
+
+    return oldest;
+}
+
+/**
+  * Updates the round trip time estimate and retransmission timeout of a peer with a new measurement.
+  *
+  * @param peer The peer the measurement was taken for.
+  *
+  * @param rtt The measured round trip time, in microseconds.
+  */
+void MicroBitRadioReliable::updateRTT(MicroBitRadioPeer *peer, uint32_t rtt)
+{
+    // Smooth the round trip time and its variation as per RFC 6298.
+    if (peer->flags & MICROBIT_RADIO_PEER_RTT_VALID)
+    {
+        uint32_t delta = peer->stats.rtt > rtt ? peer->stats.rtt - rtt : rtt - peer->stats.rtt;
+
+        peer->rttVariance = (3 * peer->rttVariance + delta) / 4;
+        peer->stats.rtt = (7 * peer->stats.rtt + rtt) / 8;
+    }
+    else
+    {
+        peer->rttVariance = rtt / 2;
+        peer->stats.rtt = rtt;
+        peer->flags |= MICROBIT_RADIO_PEER_RTT_VALID;
+    }
+
+    // We wait for acknowledgements with a 1ms granularity, so allow at least that much variation.
+    uint32_t rto = peer->stats.rtt + (peer->rttVariance > 250 ? 4 * peer->rttVariance : 1000);
+
+    if (rto < MICROBIT_RADIO_RELIABLE_MIN_RTO * 1000)
+        rto = MICROBIT_RADIO_RELIABLE_MIN_RTO * 1000;
+
+    if (rto > MICROBIT_RADIO_RELIABLE_MAX_RTO * 1000)
+        rto = MICROBIT_RADIO_RELIABLE_MAX_RTO * 1000;
+
+    peer->stats.rto = rto;
+}
+
+/**
+  * Determines whether a datagram has been seen before, recording it in the peer's duplicate detection window.
+  *
+  * @param peer The peer the datagram was received from.
+  *
+  * @param sequence The sequence number of the datagram.
+  *
+  * @return true if the datagram is a duplicate, false otherwise.
+  */
+bool MicroBitRadioReliable::isDuplicate(MicroBitRadioPeer *peer, uint16_t sequence)
+{
+    int16_t offset = (int16_t)(sequence - peer->rxSequence);
+
+    // A newer datagram. Slide the window forward.
+    if (!(peer->flags & MICROBIT_RADIO_PEER_RX_VALID) || offset > 0 || offset <= -MICROBIT_RADIO_RELIABLE_WINDOW)
+    {
+        // A datagram far older than the window indicates the sender has been reset, so restart the window from it.
+        if (!(peer->flags & MICROBIT_RADIO_PEER_RX_VALID) || offset <= -MICROBIT_RADIO_RELIABLE_WINDOW || offset >= MICROBIT_RADIO_RELIABLE_WINDOW)
+            peer->rxWindow = 1;
+        else
+            peer->rxWindow = (peer->rxWindow << offset) | 1;
+
+        peer->rxSequence = sequence;
+        peer->flags |= MICROBIT_RADIO_PEER_RX_VALID;
+
+        return false;
+    }
+
+    // An older (or the same) datagram, within the window.
+    uint32_t bit = 1UL << (-offset);
+
+    if (peer->rxWindow & bit)
+        return true;
+
+    peer->rxWindow |= bit;
+    return false;
+}
+
+/**
+  * Transmits a single reliable protocol frame.
+  */
+int MicroBitRadioReliable::sendFrame(uint8_t type, uint32_t destination, uint16_t sequence, uint8_t *buffer, int len)
+{
+    MicroBitRadioReliableHeader header;
+    FrameBuffer buf;
+
+    header.type = type;
+    header.source = microbit_serial_number();
+    header.destination = destination;
+    header.sequence = sequence;
+
+    buf.length = MICROBIT_RADIO_RELIABLE_HEADER_SIZE + len + MICROBIT_RADIO_HEADER_SIZE - 1;
+    buf.version = 1;
+    buf.group = 0;
+    buf.protocol = MICROBIT_RADIO_PROTOCOL_RELIABLE;
+    memcpy(buf.payload, &header, MICROBIT_RADIO_RELIABLE_HEADER_SIZE);
+
+    if (len > 0)
+        memcpy(buf.payload + MICROBIT_RADIO_RELIABLE_HEADER_SIZE, buffer, len);
+
+    return radio.send(&buf);
+}
+
+/**
+  * Retrieves the next datagram received, if one is available.
+  *
+  * @param source If provided, the serial number of the sending micro:bit is stored here.
+  *
+  * @return the data received, or an empty PacketBuffer if no data is available.
+  */
+PacketBuffer MicroBitRadioReliable::recv(uint32_t *source)
+{
+    FrameBuffer *p = rxQueue;
+
+    if (p == NULL)
+        return PacketBuffer::EmptyPacket;
+
+    rxQueue = p->next;
+    queueDepth--;
+
+    if (rxQueue == NULL)
+        rxQueueTail = NULL;
+
+    if (source)
+    {
+        MicroBitRadioReliableHeader header;
+        memcpy(&header, p->payload, MICROBIT_RADIO_RELIABLE_HEADER_SIZE);
+        *source = header.source;
+    }
+
+    PacketBuffer packet(p->payload + MICROBIT_RADIO_RELIABLE_HEADER_SIZE, p->length - (MICROBIT_RADIO_HEADER_SIZE - 1) - MICROBIT_RADIO_RELIABLE_HEADER_SIZE, p->rssi);
+
+    delete p;
+    return packet;
+}
+
+/**
+  * Transmits the given buffer to the given micro:bit, and waits for it to be acknowledged.
+  *
+  * The datagram is retransmitted up to MICROBIT_RADIO_RELIABLE_RETRIES times if it is not acknowledged.
+  *
+  * @param destination The serial number of the micro:bit to send to.
+  *
+  * @param buffer The datagram contents to transmit.
+  *
+  * @param len The number of bytes to transmit.
+  *
+  * @return DEVICE_OK once the datagram has been acknowledged, DEVICE_INVALID_PARAMETER if the buffer is invalid
+  *         or longer than `MICROBIT_RADIO_RELIABLE_MAX_PAYLOAD`, DEVICE_BUSY if another reliable send is in progress,
+  *         DEVICE_NO_RESOURCES if the radio is not enabled, or DEVICE_NO_DATA if no acknowledgement was received.
+  */
+int MicroBitRadioReliable::send(uint32_t destination, uint8_t *buffer, int len)
+{
+    if (buffer == NULL || len < 0 || len > MICROBIT_RADIO_RELIABLE_MAX_PAYLOAD)
+        return DEVICE_INVALID_PARAMETER;
+
+    if (txBusy)
+        return DEVICE_BUSY;
+
+    MicroBitRadioPeer *peer = getPeer(destination, true);
+    int result = DEVICE_NO_DATA;
+
+    if (peer == NULL)
+        return DEVICE_NO_RESOURCES;
+
+    txBusy = true;
+    txAcked = false;
+    txDestination = destination;
+    txSequence = peer->txSequence++;
+
+    peer->lastActivity = (uint32_t) system_timer_current_time();
+    peer->stats.txPackets++;
+
+    for (int attempt = 0; attempt <= MICROBIT_RADIO_RELIABLE_RETRIES; attempt++)
+    {
+        if (attempt > 0)
+            peer->stats.txRetries++;
+
+        uint32_t start = (uint32_t) system_timer_current_time_us();
+
+        result = sendFrame(MICROBIT_RADIO_RELIABLE_TYPE_DATA, destination, txSequence, buffer, len);
+
+        if (result != DEVICE_OK)
+            break;
+
+        // The acknowledgement is processed by our protocol handler in the radio's idle callback, so sleep to let it run.
+        while (!txAcked && (uint32_t)system_timer_current_time_us() - start < peer->stats.rto)
+            fiber_sleep(1);
+
+        if (txAcked)
+        {
+            // Only measure the round trip time of datagrams that were not retransmitted, as it is unclear
+            // which transmission an acknowledgement of a retransmitted datagram belongs to.
+            if (attempt == 0)
+                updateRTT(peer, (uint32_t)system_timer_current_time_us() - start);
+
+            break;
+        }
+
+        // Back off exponentially, in case the channel is congested.
+        result = DEVICE_NO_DATA;
+        peer->stats.rto *= 2;
+
+        if (peer->stats.rto > MICROBIT_RADIO_RELIABLE_MAX_RTO * 1000)
+            peer->stats.rto = MICROBIT_RADIO_RELIABLE_MAX_RTO * 1000;
+    }
+
+    if (result == DEVICE_NO_DATA)
+        peer->stats.txLost++;
+
+    txBusy = false;
+
+    return result;
+}
+
+/**
+  * Transmits the given buffer to the given micro:bit, and waits for it to be acknowledged.
+  *
+  * @param destination The serial number of the micro:bit to send to.
+  *
+  * @param data The datagram contents to transmit.
+  *
+  * @return DEVICE_OK once the datagram has been acknowledged, DEVICE_INVALID_PARAMETER if the buffer is invalid
+  *         or longer than `MICROBIT_RADIO_RELIABLE_MAX_PAYLOAD`, DEVICE_BUSY if another reliable send is in progress,
+  *         DEVICE_NO_RESOURCES if the radio is not enabled, or DEVICE_NO_DATA if no acknowledgement was received.
+  */
+int MicroBitRadioReliable::send(uint32_t destination, PacketBuffer data)
+{
+    return send(destination, data.getBytes(), data.length());
+}
+
+/**
+  * Transmits the given string to the given micro:bit, and waits for it to be acknowledged.
+  *
+  * @param destination The serial number of the micro:bit to send to.
+  *
+  * @param data The datagram contents to transmit.
+  *
+  * @return DEVICE_OK once the datagram has been acknowledged, DEVICE_INVALID_PARAMETER if the buffer is invalid
+  *         or longer than `MICROBIT_RADIO_RELIABLE_MAX_PAYLOAD`, DEVICE_BUSY if another reliable send is in progress,
+  *         DEVICE_NO_RESOURCES if the radio is not enabled, or DEVICE_NO_DATA if no acknowledgement was received.
+  */
+int MicroBitRadioReliable::send(uint32_t destination, ManagedString data)
+{
+    return send(destination, (uint8_t *)data.toCharArray(), data.length());
+}
+
+/**
+  * Retrieves the delivery statistics held for the given peer.
+  *
+  * @param address The serial number of the peer.
+  *
+  * @param stats The structure to fill in.
+  *
+  * @return DEVICE_OK on success, or DEVICE_INVALID_PARAMETER if no state is held for the given peer.
+  */
+int MicroBitRadioReliable::getStatistics(uint32_t address, MicroBitRadioPeerStatistics &stats)
+{
+    MicroBitRadioPeer *peer = getPeer(address, false);
+
+    if (peer == NULL)
+        return DEVICE_INVALID_PARAMETER;
+
+    stats = peer->stats;
+    return DEVICE_OK;
+}
+
+/**
+  * Protocol handler callback. This is called when the radio receives a packet marked as using the reliable protocol.
+  *
+  * Data frames addressed to this micro:bit are acknowledged and, unless duplicates, queued for user reception.
+  * Acknowledgements complete any send in progress.
+  */
+void MicroBitRadioReliable::packetReceived()
+{
+    FrameBuffer *p = radio.recv();
+    MicroBitRadioReliableHeader header;
+
+    int l = p->length - (MICROBIT_RADIO_HEADER_SIZE - 1) - MICROBIT_RADIO_RELIABLE_HEADER_SIZE;
+    memcpy(&header, p->payload, MICROBIT_RADIO_RELIABLE_HEADER_SIZE);
+
+    // Ignore anything malformed, or addressed to another micro:bit.
+    if (l < 0 || header.destination != microbit_serial_number())
+    {
+        delete p;
+        return;
+    }
+
+    if (header.type == MICROBIT_RADIO_RELIABLE_TYPE_ACK)
+    {
+        if (txBusy && header.source == txDestination && header.sequence == txSequence)
+            txAcked = true;
+
+        delete p;
+        return;
+    }
+
+    if (header.type != MICROBIT_RADIO_RELIABLE_TYPE_DATA)
+    {
+        delete p;
+        return;
+    }
+
+    // If we have nowhere to queue the datagram, don't acknowledge it. The sender will try again later.
+    if (queueDepth >= MICROBIT_RADIO_MAXIMUM_RX_BUFFERS)
+    {
+        radio.stats.rxDropped++;
+        delete p;
+        return;
+    }
+
+    // If every peer entry is in use and none can be recycled, treat the datagram as though we had nowhere to queue it.
+    MicroBitRadioPeer *peer = getPeer(header.source, true);
+
+    if (peer == NULL)
+    {
+        radio.stats.rxDropped++;
+        delete p;
+        return;
+    }
+
+    peer->lastActivity = (uint32_t) system_timer_current_time();
+
+    // Acknowledge immediately, to keep the sender's turnaround short. Duplicates are acknowledged too,
+    // as they indicate that our previous acknowledgement was lost.
+    sendFrame(MICROBIT_RADIO_RELIABLE_TYPE_ACK, header.source, header.sequence, NULL, 0);
+
+    if (isDuplicate(peer, header.sequence))
+    {
+        peer->stats.rxDuplicates++;
+        delete p;
+        return;
+    }
+
+    peer->stats.rxPackets++;
+
+    // We add to the tail of the queue to preserve causal ordering.
+    p->next = NULL;
+
+    if (rxQueueTail == NULL)
+        rxQueue = p;
+    else
+        rxQueueTail->next = p;
+
+    rxQueueTail = p;
+    queueDepth++;
+
+    Event(DEVICE_ID_RADIO, MICROBIT_RADIO_EVT_RELIABLE);
+}
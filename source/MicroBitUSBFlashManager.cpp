@@ -50,10 +50,14 @@ CREATE_KEY_VALUE_TABLE(usbFlashPropertyLength, usbFlashPropertyLengthData);
 MicroBitUSBFlashManager::MicroBitUSBFlashManager(MicroBitI2C &i2c, MicroBitIO &ioPins, MicroBitPowerManager &powerManager, uint16_t id) : i2cBus(i2c), io(ioPins), power(powerManager)
 {
     this->id = id;
-    this->maxWriteLength = 64;
+    this->maxWriteLength = MICROBIT_USB_FLASH_MAX_WRITE_LENGTH;
+    this->maxReadLength = MICROBIT_USB_FLASH_MIN_READ_LENGTH;
 
     // Be pessimistic about the interface chip in use, until we obtain version information.
     status = (MICROBIT_USB_FLASH_SINGLE_PAGE_ERASE_ONLY | MICROBIT_USB_FLASH_USE_NULL_TRANSACTION);
+
+    this->transactionStart = 0;
+    resetLatencyStatistics();
 }
 
 /**
@@ -221,14 +225,14 @@ MicroBitUSBFlashGeometry MicroBitUSBFlashManager::getGeometry()
             {
                 case 1:
                     // Apply workarounds for V2.00 KL27 release, and V2.2 NRF528xx rev1 release.
-                    maxWriteLength = 64;
+                    maxWriteLength = MICROBIT_USB_FLASH_MAX_WRITE_LENGTH;
                     status |= (MICROBIT_USB_FLASH_SINGLE_PAGE_ERASE_ONLY | MICROBIT_USB_FLASH_USE_NULL_TRANSACTION);
                     break;
 
                 case 2:
                 default:
                     // Apply/disable workarounds for KL27/NRF528xx rev2 release.
-                    maxWriteLength = 64;
+                    maxWriteLength = MICROBIT_USB_FLASH_MAX_WRITE_LENGTH;
                     status &= ~MICROBIT_USB_FLASH_USE_NULL_TRANSACTION;
                     status |= MICROBIT_USB_FLASH_BUSY_FLAG_SUPPORTED;
                     status |= MICROBIT_USB_FLASH_SINGLE_PAGE_ERASE_ONLY;
@@ -237,6 +241,8 @@ MicroBitUSBFlashGeometry MicroBitUSBFlashManager::getGeometry()
             // If we have a V2.2 NRF52 based DAPLink revision, apply an additional 100ms delay following a FLASH_ERASE command.
             if (v.board == 0x9905 || v.board == 0x9906)
                 status |= MICROBIT_USB_FLASH_100MS_AFTER_ERASE;
+
+            negotiateReadLength();
         }
 
         // Ensure we don't cache invalid state.
@@ -288,29 +294,11 @@ int MicroBitUSBFlashManager::eraseConfig()
 ManagedBuffer 
 MicroBitUSBFlashManager::read(uint32_t address, uint32_t length)
 {
-    ManagedBuffer request(8);
-    ManagedBuffer response;
-
-    // Convert length parameter from 32-bit count to a byte count.
-    length = length * sizeof(uint32_t);
-
-    uint32_t *p = (uint32_t *) &request[0];
-    *p++ = htonl((uint32_t) address | (MICROBIT_USB_FLASH_READ_CMD << 24));
-    *p++ = htonl(length);
+    ManagedBuffer response(length * sizeof(uint32_t));
 
-    response = transact(request, length + 8);
+    if (response.length() == 0 || readDirect(&response[0], address, response.length()) != DEVICE_OK)
+        return ManagedBuffer();
 
-    // If we have a valid repsonse, strip off the KL27 I2C Header
-    if (response.length() > 8)
-    {
-        response.shift(8);
-        response.truncate(response.length() - 8);
-    }
-    else
-    {
-        response = ManagedBuffer();
-    }
-    
     return response;
 }
 
@@ -324,15 +312,162 @@ MicroBitUSBFlashManager::read(uint32_t address, uint32_t length)
 int 
 MicroBitUSBFlashManager::read(uint32_t* dest, uint32_t address, uint32_t length)
 {
-    ManagedBuffer b = read(address, length);
+    return readDirect((uint8_t *) dest, address, length * sizeof(uint32_t));
+}
+
+/**
+ * Reads data from consecutive locations in the USB file storage area into a list of buffers.
+ * Data is transferred directly into the given buffers wherever possible.
+ * 
+ * @param address the logical address of the memory to read.
+ * @param iov the buffers to read into, filled in order. The length of each MUST be 32-bit aligned.
+ * @param count the number of buffers in iov.
+ * 
+ * @return DEVICE_OK on success, DEVICE_INVALID_PARAMETER if a buffer is not 32-bit aligned, or DEVICE_NO_DATA on failure.
+ */
+int MicroBitUSBFlashManager::readv(uint32_t address, MicroBitUSBFlashIOVector *iov, int count)
+{
+    for (int i = 0; i < count; i++)
+        if (iov[i].length % sizeof(uint32_t) != 0)
+            return DEVICE_INVALID_PARAMETER;
+
+    for (int i = 0; i < count; i++)
+    {
+        int r = readDirect(iov[i].buffer, address, iov[i].length);
+
+        if (r != DEVICE_OK)
+            return r;
+
+        address += iov[i].length;
+    }
+
+    return DEVICE_OK;
+}
+
+/**
+ * Reads data from the USB file storage area into the given memory, in transfers of up to maxReadLength bytes.
+ * 
+ * Each response from the interface chip carries a header ahead of its data. Responses are received directly into
+ * the destination: the header of the first response lands in space a later transfer will fill, and that of each later
+ * response overlays the tail of the previous transfer, which is saved and restored. Small reads are received via the stack
+ * instead, while larger reads that would fit in a single transfer are split in two so that they too can be received in place.
+ * 
+ * @param dest the memory to read into.
+ * @param address the logical address of the memory to read.
+ * @param length the number of bytes to read. MUST be 32-bit aligned.
+ * 
+ * @return DEVICE_OK on success, or DEVICE_NO_DATA on failure.
+ */
+int MicroBitUSBFlashManager::readDirect(uint8_t *dest, uint32_t address, uint32_t length)
+{
+    uint8_t saved[MICROBIT_USB_FLASH_HEADER_LENGTH];
+    uint32_t offset;
+    uint32_t chunk;
+
+    // Ensure we know the largest transfer supported.
+    getGeometry();
+
+    if (length == 0)
+        return DEVICE_OK;
+
+    if (length <= MICROBIT_USB_FLASH_MIN_READ_LENGTH)
+    {
+        uint8_t b[MICROBIT_USB_FLASH_MIN_READ_LENGTH + MICROBIT_USB_FLASH_HEADER_LENGTH];
 
-    if (b.length() == 0)
+        if (readChunk(b, address, length) != DEVICE_OK)
+            return DEVICE_NO_DATA;
+
+        memcpy(dest, b + MICROBIT_USB_FLASH_HEADER_LENGTH, length);
+        return DEVICE_OK;
+    }
+
+    // Size the first transfer so that every later one has at least a header's worth of data before it.
+    // A read that would fit in a single transfer is split, leaving MICROBIT_USB_FLASH_MIN_READ_LENGTH bytes for the second.
+    if (length <= maxReadLength)
+        chunk = length - MICROBIT_USB_FLASH_MIN_READ_LENGTH;
+    else
+        chunk = length % maxReadLength;
+
+    if (chunk == 0)
+        chunk = maxReadLength;
+
+    if (chunk < MICROBIT_USB_FLASH_HEADER_LENGTH)
+        chunk += MICROBIT_USB_FLASH_HEADER_LENGTH;
+
+    if (readChunk(dest, address, chunk) != DEVICE_OK)
         return DEVICE_NO_DATA;
-    
-    memcpy(dest, &b[0], length * sizeof(uint32_t));
+
+    memmove(dest, dest + MICROBIT_USB_FLASH_HEADER_LENGTH, chunk);
+    offset = chunk;
+
+    while (offset < length)
+    {
+        uint8_t *p = dest + offset - MICROBIT_USB_FLASH_HEADER_LENGTH;
+        chunk = min(length - offset, maxReadLength);
+
+        memcpy(saved, p, MICROBIT_USB_FLASH_HEADER_LENGTH);
+        int r = readChunk(p, address + offset, chunk);
+        memcpy(p, saved, MICROBIT_USB_FLASH_HEADER_LENGTH);
+
+        if (r != DEVICE_OK)
+            return DEVICE_NO_DATA;
+
+        offset += chunk;
+    }
+
     return DEVICE_OK;
 }
 
+/**
+ * Performs a single READ transaction with the interface chip.
+ * 
+ * @param response the memory to receive the response into. MUST have space for length + MICROBIT_USB_FLASH_HEADER_LENGTH bytes.
+ * @param address the logical address of the memory to read.
+ * @param length the number of bytes to read.
+ * 
+ * @return DEVICE_OK on success, or DEVICE_I2C_ERROR on failure.
+ */
+int MicroBitUSBFlashManager::readChunk(uint8_t *response, uint32_t address, uint32_t length)
+{
+    uint32_t request[2];
+
+    request[0] = htonl(address | (MICROBIT_USB_FLASH_READ_CMD << 24));
+    request[1] = htonl(length);
+
+    return transact((uint8_t *) request, sizeof(request), response, length + MICROBIT_USB_FLASH_HEADER_LENGTH);
+}
+
+/**
+ * Determines the largest READ transfer supported by the interface chip, by probing it with progressively smaller requests.
+ */
+void MicroBitUSBFlashManager::negotiateReadLength()
+{
+    uint32_t request[2];
+
+    maxReadLength = min(MICROBIT_USB_FLASH_MAX_READ_LENGTH, geometry.blockSize * geometry.blockCount);
+
+    while (maxReadLength > MICROBIT_USB_FLASH_MIN_READ_LENGTH)
+    {
+        ManagedBuffer b(maxReadLength + MICROBIT_USB_FLASH_HEADER_LENGTH);
+
+        request[0] = htonl(MICROBIT_USB_FLASH_READ_CMD << 24);
+        request[1] = htonl(maxReadLength);
+
+        // Only a single attempt is made at each size, so an unsupported length fails quickly.
+        // The response must echo the whole header, as firmware may truncate a request it cannot satisfy.
+        bool supported = beginTransact((uint8_t *) request, sizeof(request)) == DEVICE_OK && _receive(MICROBIT_USB_FLASH_READ_CMD, &b[0], b.length()) == DEVICE_OK;
+        supported = supported && memcmp(&b[0], request, MICROBIT_USB_FLASH_HEADER_LENGTH) == 0;
+        endTransact();
+
+        if (supported)
+            break;
+
+        maxReadLength = maxReadLength / 2;
+    }
+
+    DMESG("USB_FLASH: MAX READ LENGTH: %d", maxReadLength);
+}
+
 /**
  * Writes data to the specified location in the USB file staorage area.
  * 
@@ -344,41 +479,108 @@ MicroBitUSBFlashManager::read(uint32_t* dest, uint32_t address, uint32_t length)
  */
 int MicroBitUSBFlashManager::write(uint32_t address, uint32_t *data, uint32_t length)
 {
-    // Convert length parameter from 32-bit count to a byte count.
-    length = length * sizeof(uint32_t);
+    MicroBitUSBFlashIOVector v;
 
-    ManagedBuffer response;
+    v.buffer = (uint8_t *) data;
+    v.length = length * sizeof(uint32_t);
 
-    ManagedBuffer request(min(maxWriteLength, length) + 8);
-    request.fill(0xFF);
+    return writev(address, &v, 1);
+}
 
-    uint32_t p = address;
-    uint32_t end = p + length;
+/**
+ * Writes data gathered from a list of buffers to consecutive locations in the USB file storage area.
+ * 
+ * @param address the location to write to. Must be 32 bit aligned.
+ * @param iov the buffers to write, in order. Their total length MUST be 32-bit aligned.
+ * @param count the number of buffers in iov.
+ * 
+ * @return DEVICE_OK on success, DEVICE_INVALID_PARAMETER if the data is not 32-bit aligned, or DEVICE_I2C_ERROR on failure.
+ */
+int MicroBitUSBFlashManager::writev(uint32_t address, MicroBitUSBFlashIOVector *iov, int count)
+{
+    // Double buffer our requests, so that the next segment can be prepared while the
+    // interface chip is busy programming the current one.
+    uint8_t requests[2][MICROBIT_USB_FLASH_MAX_WRITE_LENGTH + MICROBIT_USB_FLASH_HEADER_LENGTH];
+    uint32_t segmentLength[2];
+    uint8_t response[MICROBIT_USB_FLASH_HEADER_LENGTH + 1];
+
+    uint32_t length = 0;
     uint32_t bytesWritten = 0;
-    uint32_t segmentLength;
+    uint32_t offset = 0;
+    int index = 0;
+    int current = 0;
+    int sent;
+
+    for (int i = 0; i < count; i++)
+        length += iov[i].length;
+
+    if (length % sizeof(uint32_t) != 0)
+        return DEVICE_INVALID_PARAMETER;
 
-    while (p < end)
+    if (length == 0)
+        return DEVICE_OK;
+
+    segmentLength[current] = prepareWrite(requests[current], address, iov, index, offset, length);
+    sent = beginTransact(requests[current], segmentLength[current] + MICROBIT_USB_FLASH_HEADER_LENGTH);
+
+    while (true)
     {
-        segmentLength = min(maxWriteLength, length-bytesWritten);
-        
-        uint32_t *ptr = (uint32_t *) &request[0];
-        *ptr++ = htonl( p | (MICROBIT_USB_FLASH_WRITE_CMD << 24));
-        *ptr++ = htonl(segmentLength);
-        memcpy(ptr, data + (bytesWritten/4), segmentLength);
+        bytesWritten += segmentLength[current];
 
-        request.truncate(segmentLength + 8);
-        response = transact(request, 9);
+        if (bytesWritten < length)
+            segmentLength[current ^ 1] = prepareWrite(requests[current ^ 1], address + bytesWritten, iov, index, offset, length - bytesWritten);
 
-        if (response.length() == 0)
+        if (completeTransact(requests[current], segmentLength[current] + MICROBIT_USB_FLASH_HEADER_LENGTH, response, sizeof(response), sent) != DEVICE_OK)
             return DEVICE_I2C_ERROR;
 
-        bytesWritten += segmentLength;
-        p+= segmentLength;
+        if (bytesWritten >= length)
+            break;
+
+        current ^= 1;
+        sent = beginTransact(requests[current], segmentLength[current] + MICROBIT_USB_FLASH_HEADER_LENGTH);
     }
 
     return DEVICE_OK;
 }
 
+/**
+ * Encodes a WRITE request for the next segment of data, gathering it from the given buffers.
+ * @param request The memory to encode into. Must have space for maxWriteLength + MICROBIT_USB_FLASH_HEADER_LENGTH bytes.
+ * @param address The logical address to write to.
+ * @param iov The buffers holding the data to write.
+ * @param index The buffer holding the next byte to write. Updated on return.
+ * @param offset The offset of the next byte to write in that buffer. Updated on return.
+ * @param remaining The number of bytes left to write.
+ * @return the number of bytes of data encoded into the request.
+ */
+uint32_t MicroBitUSBFlashManager::prepareWrite(uint8_t *request, uint32_t address, MicroBitUSBFlashIOVector *iov, int &index, uint32_t &offset, uint32_t remaining)
+{
+    uint32_t length = min((uint32_t) maxWriteLength, remaining);
+    uint32_t *header = (uint32_t *) request;
+    uint8_t *p = request + MICROBIT_USB_FLASH_HEADER_LENGTH;
+    uint32_t copied = 0;
+
+    header[0] = htonl( address | (MICROBIT_USB_FLASH_WRITE_CMD << 24));
+    header[1] = htonl(length);
+
+    while (copied < length)
+    {
+        uint32_t n = min(iov[index].length - offset, length - copied);
+
+        memcpy(p + copied, iov[index].buffer + offset, n);
+        copied += n;
+        offset += n;
+
+        if (offset == iov[index].length)
+        {
+            index++;
+            offset = 0;
+        }
+    }
+
+    return length;
+}
+
 /**
  * Writes data to the specified location in the USB file staorage area.
  * 
@@ -554,97 +756,327 @@ MicroBitUSBFlashManager::getFlashSize()
  */
 ManagedBuffer MicroBitUSBFlashManager::transact(ManagedBuffer request, int responseLength)
 {
+    ManagedBuffer b(max(responseLength, 3));
+
+    if (transact(&request[0], request.length(), &b[0], b.length()) != DEVICE_OK)
+        return ManagedBuffer();
+
+    b.truncate(responseLength);
+    return b;
+}
+
+/**
+ * Performs a flash storage transaction with the interface chip, receiving the response into the given memory.
+ * @param request The data to write to the interface chip as a request operation.
+ * @param requestLength The length of the request, in bytes.
+ * @param response The memory to receive the response into.
+ * @param responseLength The length of the expected reponse packet. Must be at least 3 bytes.
+ * @return DEVICE_OK on success, or DEVICE_I2C_ERROR on failure.
+ */
+int MicroBitUSBFlashManager::transact(uint8_t *request, int requestLength, uint8_t *response, int responseLength)
+{
+    return completeTransact(request, requestLength, response, responseLength, beginTransact(request, requestLength));
+}
+
+/**
+ * Begins a flash storage transaction with the interface chip, returning as soon as the request is sent.
+ * The transaction must be completed through a call to completeTransact().
+ * @param request The data to write to the interface chip as a request operation.
+ * @param requestLength The length of the request, in bytes.
+ * @return DEVICE_OK if the request was sent, or DEVICE_I2C_ERROR otherwise.
+ */
+int MicroBitUSBFlashManager::beginTransact(uint8_t *request, int requestLength)
+{
+    transactionStart = system_timer_current_time_us();
+
     power.nop();
 
     if (status & MICROBIT_USB_FLASH_USE_NULL_TRANSACTION)
     {
-        ManagedBuffer nop_request(1);
-        nop_request[0] = request[0] == MICROBIT_USB_FLASH_VISIBILITY_CMD ? MICROBIT_USB_FLASH_DISK_SIZE_CMD : MICROBIT_USB_FLASH_VISIBILITY_CMD;
-        _transact(nop_request, usbFlashPropertyLength.get(MICROBIT_USB_FLASH_VISIBILITY_CMD));
+        uint8_t nopRequest = request[0] == MICROBIT_USB_FLASH_VISIBILITY_CMD ? MICROBIT_USB_FLASH_DISK_SIZE_CMD : MICROBIT_USB_FLASH_VISIBILITY_CMD;
+        uint8_t nopResponse[3];
+
+        _transact(&nopRequest, 1, nopResponse, max(usbFlashPropertyLength.get(MICROBIT_USB_FLASH_VISIBILITY_CMD), (int) sizeof(nopResponse)));
     }
 
-    return _transact(request, responseLength);
+    return _send(request, requestLength);
+}
+
+/**
+ * Completes a flash storage transaction started by beginTransact(), retransmitting the request if necessary.
+ * @param request The request given to beginTransact().
+ * @param requestLength The length of the request, in bytes.
+ * @param response The memory to receive the response into.
+ * @param responseLength The length of the expected reponse packet. Must be at least 3 bytes.
+ * @param sent The value returned by beginTransact().
+ * @return DEVICE_OK on success, or DEVICE_I2C_ERROR on failure.
+ */
+int MicroBitUSBFlashManager::completeTransact(uint8_t *request, int requestLength, uint8_t *response, int responseLength, int sent)
+{
+    int result = DEVICE_I2C_ERROR;
+
+    if (sent == DEVICE_OK)
+        result = _receive(request[0], response, responseLength);
+    else
+        fiber_sleep(1);
+
+    if (result != DEVICE_OK)
+        result = _transact(request, requestLength, response, responseLength);
+    else
+        endTransact();
+
+    recordLatency(request[0], result == DEVICE_OK);
+
+    return result;
 }
 
 /**
  * Performs a flash storage transaction with the interface chip.
- * @param packet The data to write to the interface chip as a request operation.
- * @param responseLength The length of the expected reponse packet.
- * @return a buffer containing the response to the request, or a zero length buffer on failure.
+ * @param request The data to write to the interface chip as a request operation.
+ * @param requestLength The length of the request, in bytes.
+ * @param response The memory to receive the response into.
+ * @param responseLength The length of the expected reponse packet. Must be at least 3 bytes.
+ * @return DEVICE_OK on success, or DEVICE_I2C_ERROR on failure.
  */
-ManagedBuffer MicroBitUSBFlashManager::_transact(ManagedBuffer request, int responseLength)
+int MicroBitUSBFlashManager::_transact(uint8_t *request, int requestLength, uint8_t *response, int responseLength)
 {
     int tx_attempts = 0;
-    int rx_attempts = 0;
-
-    ManagedBuffer b(max(responseLength, 3));
 
     while(tx_attempts < MICROBIT_USB_FLASH_MAX_TX_RETRIES)
     {
-        rx_attempts = 0;
         tx_attempts++;
 
-        power.awaitingPacket(true);
-
-        if (i2cBus.write(MICROBIT_USB_FLASH_I2C_ADDRESS, &request[0], request.length(), false) != DEVICE_OK)
+        if (_send(request, requestLength) != DEVICE_OK)
         {
-            DMESG("TRANSACT: [I2C WRITE ERROR]");
             fiber_sleep(1);
             continue;
         }
 
-        // if we have an erase request, ensure sufficient time is left to process it before checking for a response.
-        // (DAPLink workaround)
-        if (request[0] == MICROBIT_USB_FLASH_ERASE_CMD)
-            fiber_sleep(status & MICROBIT_USB_FLASH_100MS_AFTER_ERASE ? 100 : 20);
-        else
+        if (_receive(request[0], response, responseLength) == DEVICE_OK)
+        {
+            endTransact();
+            return DEVICE_OK;
+        }
+    }
+
+    DMESG("USB_FLASH: Transaction Failed.");
+    endTransact();
+    return DEVICE_I2C_ERROR;
+}
+
+/**
+ * Writes a request to the interface chip, without waiting for a response.
+ * @param request The data to write to the interface chip as a request operation.
+ * @param length The length of the request, in bytes.
+ * @return DEVICE_OK on success, or DEVICE_I2C_ERROR if the request could not be sent.
+ */
+int MicroBitUSBFlashManager::_send(uint8_t *request, int length)
+{
+    power.awaitingPacket(true);
+
+    // Register for edge events on the interrupt line, so we can sleep until a response is ready
+    // rather than polling for it. The line is shared with other sensors, so events are only enabled
+    // for the duration of a transaction.
+    if (!(status & MICROBIT_USB_FLASH_IRQ_LISTENING) && EventModel::defaultEventBus)
+    {
+        EventModel::defaultEventBus->listen(io.irq1.id, DEVICE_PIN_EVT_FALL, this, &MicroBitUSBFlashManager::onInterrupt, MESSAGE_BUS_LISTENER_IMMEDIATE);
+        status |= MICROBIT_USB_FLASH_IRQ_LISTENING;
+    }
+
+    if (!(status & MICROBIT_USB_FLASH_AWAITING_RESPONSE))
+    {
+        io.irq1.eventOn(DEVICE_PIN_EVENT_ON_EDGE);
+        status |= MICROBIT_USB_FLASH_AWAITING_RESPONSE;
+    }
+
+    // If another device is already holding the interrupt line active, no edge will mark our response.
+    if (io.irq1.isActive())
+        status |= MICROBIT_USB_FLASH_IRQ_SHARED;
+    else
+        status &= ~MICROBIT_USB_FLASH_IRQ_SHARED;
+
+    if (i2cBus.write(MICROBIT_USB_FLASH_I2C_ADDRESS, request, length, false) != DEVICE_OK)
+    {
+        DMESG("TRANSACT: [I2C WRITE ERROR]");
+        return DEVICE_I2C_ERROR;
+    }
+
+    return DEVICE_OK;
+}
+
+/**
+ * Awaits and reads the response to a request previously written with _send().
+ * @param command The command byte of the request that was sent.
+ * @param response The memory to receive the response into.
+ * @param responseLength The length of the expected reponse packet. Must be at least 3 bytes.
+ * @return DEVICE_OK if a valid response was received, or DEVICE_I2C_ERROR otherwise.
+ */
+int MicroBitUSBFlashManager::_receive(uint8_t command, uint8_t *response, int responseLength)
+{
+    CODAL_TIMESTAMP timeout = MICROBIT_USB_FLASH_RESPONSE_TIMEOUT;
+
+    // if we have an erase request, ensure sufficient time is left to process it before checking for a response.
+    // (DAPLink workaround). If the interrupt line is free, the edge raised by the response is trusted instead.
+    int eraseTime = command == MICROBIT_USB_FLASH_ERASE_CMD ? (status & MICROBIT_USB_FLASH_100MS_AFTER_ERASE ? 100 : 20) : 0;
+
+    if (status & MICROBIT_USB_FLASH_IRQ_SHARED)
+        fiber_sleep(max(eraseTime, 1));
+    else
+        timeout += eraseTime;
+
+    CODAL_TIMESTAMP deadline = system_timer_current_time() + timeout;
+
+    while(awaitInterrupt(deadline))
+    {
+        memset(response, 0, responseLength);
+        int r = i2cBus.read(MICROBIT_USB_FLASH_I2C_ADDRESS, response, responseLength, false);
+
+        if (r != MICROBIT_OK)
+        {
+            DMESG("TRANSACT: [I2C READ ERROR: %d]",r);
+            break;
+        }
+
+        // We have a valid response, and we're done.
+        if (response[0] == command)
+            return DEVICE_OK;
+
+        // We have a negative response. If it's not a FAIL case, treat this as "NOT READY"
+        // reset RX timeout, as the peripheral is active on our transaction.
+        // some revisions report busy status explicitly, others do not and we must infer...
+        bool busy = (status & MICROBIT_USB_FLASH_BUSY_FLAG_SUPPORTED) ? response[0] == 0x20 && response[1] == 0x39 : response[0] == 0x00 || (response[0] == 0x20 && (response[1] == command || response[1] == 0x00));
+
+        if (!busy)
+            break;
+
+        deadline = system_timer_current_time() + MICROBIT_USB_FLASH_RESPONSE_TIMEOUT;
+
+        // If the line remains active there is no edge to wait for, so poll instead.
+        if (io.irq1.isActive())
             fiber_sleep(1);
+    }
+
+    return DEVICE_I2C_ERROR;
+}
 
-        while(rx_attempts < MICROBIT_USB_FLASH_MAX_RX_RETRIES)
+/**
+ * Blocks the calling fiber until the interrupt line from the interface chip is active, or the given deadline passes.
+ * @param deadline The system time (in milliseconds) at which to give up.
+ * @return true if the interrupt line is active, false on timeout.
+ */
+bool MicroBitUSBFlashManager::awaitInterrupt(CODAL_TIMESTAMP deadline)
+{
+    while(!io.irq1.isActive())
+    {
+        CODAL_TIMESTAMP now = system_timer_current_time();
+
+        if (now >= deadline)
+            return false;
+
+        if ((status & MICROBIT_USB_FLASH_IRQ_LISTENING) && fiber_scheduler_running())
         {
-            rx_attempts++;
+            system_timer_event_after(deadline - now, id, MICROBIT_USB_FLASH_EVT_TIMEOUT);
 
-            if(io.irq1.isActive())
-            {
-                b.fill(0);
-                int r = i2cBus.read(MICROBIT_USB_FLASH_I2C_ADDRESS, &b[0], b.length(), false);
-
-                if (r == MICROBIT_OK)
-                {
-                    if (b[0] == request[0])
-                    {
-                        // We have a valid response. Consume it, and we're done.
-                        power.awaitingPacket(false);
-                        b.truncate(responseLength);
-                        return b;
-                    }
-                    else
-                    {
-                        // We have a negative response. If it's not a FAIL case, treat this as "NOT READY"
-                        // reset RX timeout, as the peripheral is active on our transaction.
-                        // some revisions report busy status explicitly, others do not and we must infer...
-                        bool busy = (status & MICROBIT_USB_FLASH_BUSY_FLAG_SUPPORTED) ? b[0] == 0x20 && b[1] == 0x39 : b[0] == 0x00 || (b[0] == 0x20 && (b[1] == request[0] || b[1] == 0x00));
-
-                        if (busy)
-                            rx_attempts = 0;
-                        else
-                            break;
-                    }
-                }
-                else
-                {
-                    DMESG("TRANSACT: [I2C READ ERROR: %d]",r);
-                    break;
-                }
-            }
+            // Begin waiting before testing the line again, so an edge arriving in between still wakes us.
+            fiber_wake_on_event(id, DEVICE_EVT_ANY);
+
+            if (io.irq1.isActive())
+                Event(id, MICROBIT_USB_FLASH_EVT_RESPONSE);
 
+            schedule();
+            system_timer_cancel_event(id, MICROBIT_USB_FLASH_EVT_TIMEOUT);
+        }
+        else
+        {
             fiber_sleep(1);
         }
     }
 
-    DMESG("USB_FLASH: Transaction Failed.");
+    return true;
+}
+
+/**
+ * Releases the interrupt line and power manager once a transaction has finished.
+ */
+void MicroBitUSBFlashManager::endTransact()
+{
+    if (status & MICROBIT_USB_FLASH_AWAITING_RESPONSE)
+    {
+        io.irq1.eventOn(DEVICE_PIN_EVENT_NONE);
+        status &= ~MICROBIT_USB_FLASH_AWAITING_RESPONSE;
+    }
+
     power.awaitingPacket(false);
-    return ManagedBuffer();
+}
+
+/**
+ * Interrupt line event handler. Wakes any fiber awaiting a response from the interface chip.
+ */
+void MicroBitUSBFlashManager::onInterrupt(Event)
+{
+    if (status & MICROBIT_USB_FLASH_AWAITING_RESPONSE)
+        Event(id, MICROBIT_USB_FLASH_EVT_RESPONSE);
+}
+
+/**
+ * Records the latency of a completed transaction.
+ * @param command The command of the completed transaction.
+ * @param success true if a valid response was received, false otherwise.
+ */
+void MicroBitUSBFlashManager::recordLatency(uint8_t command, bool success)
+{
+    int index = command == MICROBIT_USB_FLASH_READ_CMD ? MICROBIT_USB_FLASH_LATENCY_READ :
+                command == MICROBIT_USB_FLASH_WRITE_CMD ? MICROBIT_USB_FLASH_LATENCY_WRITE :
+                command == MICROBIT_USB_FLASH_ERASE_CMD ? MICROBIT_USB_FLASH_LATENCY_ERASE : MICROBIT_USB_FLASH_LATENCY_OTHER;
+
+    MicroBitUSBFlashLatency &l = latency[index];
+    uint32_t t = (uint32_t) (system_timer_current_time_us() - transactionStart);
+    uint32_t ms = t / 1000;
+    int bucket = 0;
+
+    while (ms && bucket < MICROBIT_USB_FLASH_LATENCY_BUCKETS - 1)
+    {
+        ms >>= 1;
+        bucket++;
+    }
+
+    l.count++;
+    l.totalTime += t;
+    l.maxTime = max(l.maxTime, t);
+    l.histogram[bucket]++;
+
+    if (!success)
+        l.failures++;
+}
+
+/**
+ * Provides latency statistics for transactions with the interface chip.
+ * 
+ * @param command The command to report on. MICROBIT_USB_FLASH_READ_CMD, MICROBIT_USB_FLASH_WRITE_CMD and
+ * MICROBIT_USB_FLASH_ERASE_CMD are tracked individually. All other commands are reported together.
+ * 
+ * @return the number, duration and latency histogram of transactions of the given type.
+ */
+MicroBitUSBFlashLatency MicroBitUSBFlashManager::getLatencyStatistics(int command)
+{
+    if (command == MICROBIT_USB_FLASH_READ_CMD)
+        return latency[MICROBIT_USB_FLASH_LATENCY_READ];
+
+    if (command == MICROBIT_USB_FLASH_WRITE_CMD)
+        return latency[MICROBIT_USB_FLASH_LATENCY_WRITE];
+
+    if (command == MICROBIT_USB_FLASH_ERASE_CMD)
+        return latency[MICROBIT_USB_FLASH_LATENCY_ERASE];
+
+    return latency[MICROBIT_USB_FLASH_LATENCY_OTHER];
+}
+
+/**
+ * Resets all transaction latency statistics to zero.
+ */
+void MicroBitUSBFlashManager::resetLatencyStatistics()
+{
+    memset(latency, 0, sizeof(latency));
 }
 
 /**
@@ -27,9 +27,276 @@ DEALINGS IN THE SOFTWARE.
 #include "ErrorNo.h"
 #include "Timer.h"
 #include "CodalDmesg.h"
+#include "codal_target_hal.h"
+
+#if CONFIG_MIXER_CYCLE_COUNT
+#include "nrf.h"
+#endif
 
 using namespace codal;
 
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+#define MIXER_DSP 1
+
+// Cortex-M4 DSP extension multiply instructions. These multiply a 32 bit value by a signed 16 bit halfword
+// and return the top 32 bits of the 48 bit product (optionally accumulating) in a single cycle.
+static inline int32_t mixer_smulwb(int32_t a, int32_t b) { int32_t r; __asm__ ("smulwb %0, %1, %2" : "=r" (r) : "r" (a), "r" (b)); return r; }
+static inline int32_t mixer_smlawb(int32_t a, int32_t b, int32_t c) { int32_t r; __asm__ ("smlawb %0, %1, %2, %3" : "=r" (r) : "r" (a), "r" (b), "r" (c)); return r; }
+static inline int32_t mixer_smlawt(int32_t a, int32_t b, int32_t c) { int32_t r; __asm__ ("smlawt %0, %1, %2, %3" : "=r" (r) : "r" (a), "r" (b), "r" (c)); return r; }
+
+// Dual signed 16 bit multiply, with both products added to a 32 bit accumulator.
+static inline int32_t mixer_smlad(uint32_t a, uint32_t b, int32_t c) { int32_t r; __asm__ ("smlad %0, %1, %2, %3" : "=r" (r) : "r" (a), "r" (b), "r" (c)); return r; }
+#endif
+
+// Polyphase resampling filter coefficients (Q15), one row of MIXER_RESAMPLE_TAPS per phase.
+// Kaiser windowed sinc (beta 5.0) with a cutoff of 0.9x the input Nyquist frequency, each row normalised to unity gain.
+// Generated offline, and centred between taps 3 and 4 - so the filter adds a delay of four input samples.
+static const int16_t mixerPolyphase[1 << MIXER_RESAMPLE_PHASE_BITS][MIXER_RESAMPLE_TAPS] __attribute__((aligned(4))) = {
+    {    646,  -1688,   2786,  29371,   2786,  -1688,    646,    -91 },
+    {    574,  -1425,   1940,  29339,   3680,  -1955,    718,   -103 },
+    {    503,  -1168,   1142,  29224,   4617,  -2223,    789,   -116 },
+    {    433,   -918,    394,  29025,   5593,  -2489,    858,   -128 },
+    {    366,   -677,   -303,  28741,   6607,  -2751,    925,   -140 },
+    {    301,   -446,   -947,  28379,   7653,  -3007,    987,   -152 },
+    {    238,   -227,  -1537,  27936,   8727,  -3252,   1045,   -162 },
+    {    180,    -22,  -2072,  27418,   9824,  -3485,   1097,   -172 },
+    {    125,    169,  -2552,  26824,  10941,  -3701,   1142,   -180 },
+    {     75,    345,  -2976,  26160,  12071,  -3899,   1179,   -187 },
+    {     28,    506,  -3346,  25429,  13209,  -4074,   1207,   -191 },
+    {    -13,    650,  -3662,  24635,  14349,  -4223,   1225,   -193 },
+    {    -51,    778,  -3925,  23784,  15487,  -4344,   1231,   -192 },
+    {    -83,    889,  -4136,  22877,  16616,  -4433,   1225,   -187 },
+    {   -111,    984,  -4297,  21923,  17730,  -4487,   1206,   -180 },
+    {   -135,   1063,  -4411,  20927,  18823,  -4503,   1173,   -169 },
+    {   -154,   1126,  -4479,  19891,  19891,  -4479,   1126,   -154 },
+    {   -169,   1173,  -4503,  18823,  20927,  -4411,   1063,   -135 },
+    {   -180,   1206,  -4487,  17730,  21923,  -4297,    984,   -111 },
+    {   -187,   1225,  -4433,  16616,  22877,  -4136,    889,    -83 },
+    {   -192,   1231,  -4344,  15487,  23784,  -3925,    778,    -51 },
+    {   -193,   1225,  -4223,  14349,  24635,  -3662,    650,    -13 },
+    {   -191,   1207,  -4074,  13209,  25429,  -3346,    506,     28 },
+    {   -187,   1179,  -3899,  12071,  26160,  -2976,    345,     75 },
+    {   -180,   1142,  -3701,  10941,  26824,  -2552,    169,    125 },
+    {   -172,   1097,  -3485,   9824,  27418,  -2072,    -22,    180 },
+    {   -162,   1045,  -3252,   8727,  27936,  -1537,   -227,    238 },
+    {   -152,    987,  -3007,   7653,  28379,   -947,   -446,    301 },
+    {   -140,    925,  -2751,   6607,  28741,   -303,   -677,    366 },
+    {   -128,    858,  -2489,   5593,  29025,    394,   -918,    433 },
+    {   -116,    789,  -2223,   4617,  29224,   1142,  -1168,    503 },
+    {   -103,    718,  -1955,   3680,  29339,   1940,  -1425,    574 }
+};
+
+/**
+ * Scale a sample by a fused 16.16 fixed point gain.
+ * Samples that fit in a signed halfword use a single SMULWB instruction where the DSP extension is available.
+ */
+template <typename T>
+static inline int32_t mixerScale(int32_t sample, int32_t gain)
+{
+#ifdef MIXER_DSP
+    // Unsigned 16 bit samples may not fit in a signed halfword.
+    if (!(sizeof(T) == 2 && (T)-1 > 0))
+        return mixer_smulwb(gain, sample);
+#endif
+    return (int32_t)(((int64_t)gain * sample) >> 16);
+}
+
+/**
+ * Mix samples of type T into a fixed point accumulator, stepping through the input with a 16.16 fixed point phase.
+ * The bias is the channel's offset, already scaled into accumulator units.
+ * This is instantiated for each input format, so the inner loop carries no per-sample function call.
+ */
+template <typename T>
+static void mixerMix(int32_t *out, int len, const uint8_t *in, uint32_t &phase, uint32_t step, int32_t bias, int32_t gain)
+{
+    const T *samples = (const T *)in;
+    uint32_t p = phase;
+
+    while (len--)
+    {
+        *out++ += mixerScale<T>(samples[p >> 16], gain) + bias;
+        p += step;
+    }
+
+    phase = p;
+}
+
+/**
+ * Determine the value that centres samples of type T on zero.
+ */
+template <typename T>
+static inline int32_t mixerCentre()
+{
+    return (T)-1 > 0 ? 1 << (sizeof(T) * 8 - 1) : 0;
+}
+
+/**
+ * Read an input sample of type T, centred on zero. Negative indexes are read from the previous buffer's history.
+ */
+template <typename T>
+static inline int32_t mixerTap(const T *samples, const int16_t *history, int index)
+{
+    return index < 0 ? history[MIXER_RESAMPLE_TAPS - 1 + index] : samples[index] - mixerCentre<T>();
+}
+
+/**
+ * Mix samples of type T into a fixed point accumulator, linearly interpolating between adjacent input samples.
+ * Samples are interpolated between index-1 and index, so no lookahead into the next buffer is needed.
+ */
+template <typename T>
+static void mixerMixLinear(int32_t *out, int len, const uint8_t *in, const int16_t *history, uint32_t &phase, uint32_t step, int32_t bias, int32_t gain)
+{
+    const T *samples = (const T *)in;
+    uint32_t p = phase;
+
+    while (len--)
+    {
+        int index = p >> 16;
+        int32_t s0 = mixerTap<T>(samples, history, index - 1);
+        int32_t s1 = mixerTap<T>(samples, history, index);
+        int32_t s = s0 + (((s1 - s0) * (int32_t)((p & 0xFFFF) >> 1)) >> 15);
+
+        *out++ += mixerScale<int16_t>(s, gain) + bias;
+        p += step;
+    }
+
+    phase = p;
+}
+
+/**
+ * Mix samples of type T into a fixed point accumulator, using the polyphase FIR filter to interpolate.
+ * Signed 16 bit inputs compute each pair of taps with a single SMLAD instruction where the DSP extension is available.
+ */
+template <typename T>
+static void mixerMixPolyphase(int32_t *out, int len, const uint8_t *in, const int16_t *history, uint32_t &phase, uint32_t step, int32_t bias, int32_t gain)
+{
+    const T *samples = (const T *)in;
+    uint32_t p = phase;
+
+    while (len--)
+    {
+        int index = (p >> 16) - (MIXER_RESAMPLE_TAPS - 1);
+        const int16_t *c = mixerPolyphase[(p & 0xFFFF) >> (16 - MIXER_RESAMPLE_PHASE_BITS)];
+        int32_t acc = 0;
+
+        if (index < 0)
+        {
+            for (int k = 0; k < MIXER_RESAMPLE_TAPS; k++)
+                acc += c[k] * mixerTap<T>(samples, history, index + k);
+        }
+#ifdef MIXER_DSP
+        else if (sizeof(T) == 2 && (T)-1 < 0)
+        {
+            const int16_t *x = (const int16_t *)samples + index;
+            uint32_t xs, cs;
+
+            for (int k = 0; k < MIXER_RESAMPLE_TAPS; k += 2)
+            {
+                memcpy(&xs, x + k, sizeof(xs));
+                memcpy(&cs, c + k, sizeof(cs));
+                acc = mixer_smlad(xs, cs, acc);
+            }
+        }
+#endif
+        else
+        {
+            const T *x = samples + index;
+
+            for (int k = 0; k < MIXER_RESAMPLE_TAPS; k++)
+                acc += c[k] * (x[k] - mixerCentre<T>());
+        }
+
+        // The filter may overshoot on full scale transients.
+        int32_t s = acc >> 15;
+
+        if (s > 32767)
+            s = 32767;
+
+        if (s < -32768)
+            s = -32768;
+
+        *out++ += mixerScale<int16_t>(s, gain) + bias;
+        p += step;
+    }
+
+    phase = p;
+}
+
+/**
+ * Mix samples of type T into a fixed point accumulator, using the given resampling quality.
+ */
+template <typename T>
+static void mixerResample(int quality, int32_t *out, int len, const uint8_t *in, const int16_t *history, uint32_t &phase, uint32_t step, int32_t bias, int32_t gain)
+{
+    if (quality == MIXER_RESAMPLE_LINEAR)
+        mixerMixLinear<T>(out, len, in, history, phase, step, bias, gain);
+
+    else if (quality == MIXER_RESAMPLE_POLYPHASE)
+        mixerMixPolyphase<T>(out, len, in, history, phase, step, bias, gain);
+
+    else
+        mixerMix<T>(out, len, in, phase, step, bias, gain);
+}
+
+#ifdef MIXER_DSP
+/**
+ * Mix signed 16 bit samples at the output sample rate into a fixed point accumulator - the most common case.
+ * Samples are loaded in pairs, and each is scaled and accumulated with a single SMLAWB/SMLAWT instruction.
+ */
+static void mixerMixPairs(int32_t *out, int len, const uint8_t *in, uint32_t &phase, int32_t gain)
+{
+    const int16_t *samples = (const int16_t *)in + (phase >> 16);
+    uint32_t pair;
+
+    phase += len << 16;
+
+    while (len >= 2)
+    {
+        memcpy(&pair, samples, sizeof(pair));
+        out[0] = mixer_smlawb(gain, pair, out[0]);
+        out[1] = mixer_smlawt(gain, pair, out[1]);
+
+        samples += 2;
+        out += 2;
+        len -= 2;
+    }
+
+    if (len)
+        *out = mixer_smlawb(gain, *samples, *out);
+}
+#endif
+
+/**
+ * Scale, offset, clamp and pack fixed point accumulator samples into an output buffer of type T.
+ */
+template <typename T>
+static void mixerPack(uint8_t *w, const int32_t *r, int len, int32_t scale, int32_t offset, int32_t lo, int32_t hi, uint32_t orMask)
+{
+    T *out = (T *)w;
+
+    while (len--)
+    {
+        int32_t sample = (int32_t)(((int64_t)*r++ * scale) >> 24) + offset;
+
+        if (sample < lo)
+            sample = lo;
+
+        if (sample > hi)
+            sample = hi;
+
+        *out++ = (T)(sample | orMask);
+    }
+}
+
+/**
+ * Determine the 16.16 fixed point phase increment of a channel.
+ */
+static inline uint32_t mixerStep(float skip)
+{
+    uint32_t step = (uint32_t)(skip * 65536.0f);
+    return step ? step : 1;
+}
+
 
 /**
  * Constructor.
@@ -51,6 +318,15 @@ Mixer2::Mixer2(float sampleRate, int sampleRange, int format)
     this->silent = true;
     this->silenceStartTime = 0;
     this->silenceEndTime = 0;
+    this->fixedPoint = CONFIG_MIXER_FIXED_POINT;
+    this->pullCycles = 0;
+    this->pool = AudioBufferPool::get(CONFIG_MIXER_BUFFER_SIZE);
+
+#if CONFIG_MIXER_CYCLE_COUNT
+    // Enable the DWT cycle counter.
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
 
     // Attempt to configure output format to requested value
     this->setFormat(format);
@@ -99,6 +375,11 @@ MixerChannel *Mixer2::addChannel(DataSource &stream, float sampleRate, int sampl
     c->in = NULL;
     c->end = NULL;
     c->position = 0;
+    c->phase = 0;
+    c->quality = CONFIG_MIXER_DEFAULT_RESAMPLE_QUALITY;
+    memset(c->history, 0, sizeof(c->history));
+    c->idleBuffers = 0;
+    c->asleep = false;
 
     configureChannel(c);
 
@@ -122,16 +403,16 @@ ManagedBuffer Mixer2::pull()
     // Take a local timestamp, in case we need to compute a time when a pice of audio will be played out of the speaker
     CODAL_TIMESTAMP pullTime = system_timer_current_time_us();
 
-    // If we have no channels, just return an empty buffer.
+    // If we have no channels, just return silence. This is cached, so costs no allocation.
     if (!channels)
     {
         downStream->pullRequest();
-        return ManagedBuffer(CONFIG_MIXER_BUFFER_SIZE);
+        return getSilenceBuffer();
     }
 
-    // Clear the accumulator buffer
-    for (int i=0; i<CONFIG_MIXER_BUFFER_SIZE/bytesPerSampleOut; i++)
-        mix[i] = 0.0f;
+#if CONFIG_MIXER_CYCLE_COUNT
+    uint32_t startCycles = DWT->CYCCNT;
+#endif
 
     MixerChannel *next;
     bool silence = true;
@@ -139,6 +420,10 @@ ManagedBuffer Mixer2::pull()
     for (MixerChannel *ch = channels; ch; ch = next) {
         next = ch->next; // save next in case the current channel gets deleted
 
+        // Sleeping channels cost nothing until they are re-armed by a pullRequest().
+        if (ch->asleep)
+            continue;
+
         // Attempt to discover the stream format if it is not already defined.
         if (ch->format == DATASTREAM_FORMAT_UNKNOWN)
         {
@@ -149,43 +434,81 @@ ManagedBuffer Mixer2::pull()
                 continue;
         }
 
-        float *out = &mix[0];
-        float *end = &mix[CONFIG_MIXER_BUFFER_SIZE/bytesPerSampleOut];
+        int done = 0;
+        int samples = CONFIG_MIXER_BUFFER_SIZE/bytesPerSampleOut;
         int inputFormat = ch->format;
 
         // Check if we need to recalculate skip after a channel rate change
         if( ch->skip == 0.0f )
             ch->skip = ch->rate / outputRate;
 
-        while (out < end)
+        // The fixed point kernel only handles 8 and 16 bit inputs. Wider formats use the reference kernel.
+        bool fixed = fixedPoint && ch->bytesPerSample <= 2;
+        uint32_t step = mixerStep(ch->skip);
+
+        while (done < samples)
         {
             // precalculate the maximum number of samples the we can process with the current buffer allocations.
             // choose the minimum between the available samples in the input buffer and the space in the output buffer.
-            int outLen = (int) (end - out);
-            int inLen = ((ch->buffer.length() / ch->bytesPerSample) - ch->position) / ch->skip;
+            int inputSamples = ch->buffer.length() / ch->bytesPerSample;
+            int outLen = samples - done;
+            int inLen;
+
+            if (fixed)
+            {
+                // Generate every output sample whose phase lies within the buffer, carrying any remainder into the next.
+                uint32_t limit = (uint32_t)inputSamples << 16;
+                inLen = ch->phase < limit ? (limit - ch->phase + step - 1) / step : 0;
+            }
+            else
+            {
+                inLen = (inputSamples - ch->position) / ch->skip;
+            }
+
             int len =  min(outLen, inLen);
 
             if (len)
-                silence = false;
+            {
+                // Clear the accumulator on first use, so silent buffers never touch it. All zero bits is zero in both float and fixed point.
+                if (silence)
+                    memset(mix, 0, sizeof(mix[0]) * (CONFIG_MIXER_BUFFER_SIZE/bytesPerSampleOut));
 
-            uint8_t *d = ch->in;
+                silence = false;
+            }
 
-            while(len)
+            if (fixed)
             {
-                d = ch->in + (int)(ch->position * ch->bytesPerSample);
-
-                float v = StreamNormalizer::readSample[inputFormat](d);
-                v += ch->offset;
-                v *= ch->gain;    
-                v *= ch->volume;    
-                *out += v;
+                if (len)
+                    mixChannelFixed(ch, &mixFixed[done], len);
+            }
+            else
+            {
+                float *out = &mix[done];
+                uint8_t *d;
+
+                for (int i = 0; i < len; i++)
+                {
+                    d = ch->in + (int)ch->position * ch->bytesPerSample;
+
+                    float v = StreamNormalizer::readSample[inputFormat](d);
+                    v += ch->offset;
+                    v *= ch->gain;    
+                    v *= ch->volume;    
+
+                    // Wide formats mixed by the reference kernel may still need to accumulate in fixed point.
+                    if (fixedPoint)
+                        mixFixed[done + i] += (int32_t)(v * (1 << MIXER_FIXED_FRACTION_BITS));
+                    else
+                        *out += v;
  
-                ch->position += ch->skip;
+                    ch->position += ch->skip;
 
-                out++;
-                len--;
+                    out++;
+                }
             }
 
+            done += len;
+
             // Check if we've completed an input buffer. If so, pull down another if available.
             // if no buffer is available, then move on to the next channel.
             if (inLen < outLen)
@@ -194,23 +517,42 @@ ManagedBuffer Mixer2::pull()
                     break;
 
                 ch->pullRequests--;
+
+                if (fixed && inputSamples)
+                    saveHistory(ch, false);
+
                 ch->buffer = ch->stream->pull();
                 ch->in = &ch->buffer[0];
                 ch->position = 0;
+                ch->phase -= min(ch->phase, (uint32_t)inputSamples << 16);
                 ch->end = ch->in + ch->buffer.length();
 
+                // If the stream is (re)starting, there is no previous buffer to interpolate from, so hold its first sample.
+                if (fixed && inputSamples == 0 && ch->buffer.length())
+                    saveHistory(ch, true);
+
                 if (ch->buffer.length() == 0)
                     break;
             }                
         }
-    }       
 
-    // If we have silence, set output level to predefined value.
-    if (silence && silenceLevel != 0.0f)
-    {
-        for (int i=0; i<CONFIG_MIXER_BUFFER_SIZE/bytesPerSampleOut; i++)
-            mix[i] = silenceLevel;
-    }
+        // Put channels that have had nothing to say for a while to sleep.
+        if (done)
+            ch->idleBuffers = 0;
+        else if (ch->idleBuffers < 0xFFFF)
+            ch->idleBuffers++;
+
+#if CONFIG_MIXER_CHANNEL_SLEEP_BUFFERS > 0
+        if (ch->idleBuffers >= CONFIG_MIXER_CHANNEL_SLEEP_BUFFERS)
+        {
+            // A channel with outstanding pull requests may still have data to give, so must remain awake.
+            target_disable_irq();
+            if (ch->pullRequests == 0)
+                ch->asleep = true;
+            target_enable_irq();
+        }
+#endif
+    }       
 
     if (this->silent != silence)
     {
@@ -230,8 +572,30 @@ ManagedBuffer Mixer2::pull()
         }
     }
 
-    // Scale and pack to our output format
-    ManagedBuffer output = ManagedBuffer(CONFIG_MIXER_BUFFER_SIZE);
+    // Silence is the same every time, so return the cached copy rather than packing a new buffer.
+    if (silence)
+    {
+#if CONFIG_MIXER_CYCLE_COUNT
+        pullCycles = DWT->CYCCNT - startCycles;
+#endif
+        downStream->pullRequest();
+        return getSilenceBuffer();
+    }
+
+    // Scale and pack to our output format. Every byte is written, so a recycled buffer can be used.
+    ManagedBuffer output = pool ? pool->allocate() : ManagedBuffer(CONFIG_MIXER_BUFFER_SIZE);
+
+    if (fixedPoint)
+    {
+        packFixed(output);
+
+#if CONFIG_MIXER_CYCLE_COUNT
+        pullCycles = DWT->CYCCNT - startCycles;
+#endif
+        downStream->pullRequest();
+        return output;
+    }
+
     uint8_t *w = &output[0];
     float *r = mix;
 
@@ -264,14 +628,273 @@ ManagedBuffer Mixer2::pull()
         r++;
     }
 
+#if CONFIG_MIXER_CYCLE_COUNT
+    pullCycles = DWT->CYCCNT - startCycles;
+#endif
+
     // Return the buffer and we're done.
     downStream->pullRequest();
     return output;
 }
 
+/**
+ * Mix a section of a channel's current input buffer into the fixed point accumulator.
+ *
+ * @param ch The channel to mix.
+ * @param out The first accumulator sample to mix into.
+ * @param len The number of output samples to generate.
+ */
+void Mixer2::mixChannelFixed(MixerChannel *ch, int32_t *out, int len)
+{
+    // Fuse the normalising gain and channel volume into a single multiplier, saturating rather than overflowing.
+    float g = ch->gain * ch->volume * (float)(1 << (16 + MIXER_FIXED_FRACTION_BITS));
+    int32_t gain = g >= 2147483520.0f ? 0x7FFFFF80 : g <= -2147483520.0f ? -0x7FFFFF80 : (int32_t)g;
+    uint32_t step = mixerStep(ch->skip);
+
+    // No interpolation is needed if the channel is already at the output sample rate.
+    int quality = step == 0x10000 ? MIXER_RESAMPLE_NEAREST : ch->quality;
+
+    // Interpolating kernels centre unsigned samples on zero before filtering, so fold that into the offset.
+    float offset = ch->offset;
+
+    if (quality != MIXER_RESAMPLE_NEAREST && ch->format == DATASTREAM_FORMAT_8BIT_UNSIGNED)
+        offset += 128.0f;
+
+    if (quality != MIXER_RESAMPLE_NEAREST && ch->format == DATASTREAM_FORMAT_16BIT_UNSIGNED)
+        offset += 32768.0f;
+
+    int32_t bias = (int32_t)(offset * g / 65536.0f);
+
+    switch (ch->format)
+    {
+        case DATASTREAM_FORMAT_8BIT_UNSIGNED:
+            mixerResample<uint8_t>(quality, out, len, ch->in, ch->history, ch->phase, step, bias, gain);
+            break;
+
+        case DATASTREAM_FORMAT_8BIT_SIGNED:
+            mixerResample<int8_t>(quality, out, len, ch->in, ch->history, ch->phase, step, bias, gain);
+            break;
+
+        case DATASTREAM_FORMAT_16BIT_UNSIGNED:
+            mixerResample<uint16_t>(quality, out, len, ch->in, ch->history, ch->phase, step, bias, gain);
+            break;
+
+        case DATASTREAM_FORMAT_16BIT_SIGNED:
+#ifdef MIXER_DSP
+            if (step == 0x10000)
+            {
+                mixerMixPairs(out, len, ch->in, ch->phase, gain);
+                break;
+            }
+#endif
+            mixerResample<int16_t>(quality, out, len, ch->in, ch->history, ch->phase, step, bias, gain);
+            break;
+    }
+}
+
+/**
+ * Read a single 8 or 16 bit input sample, centred on zero.
+ */
+static int16_t mixerReadCentred(int format, const uint8_t *d)
+{
+    switch (format)
+    {
+        case DATASTREAM_FORMAT_8BIT_UNSIGNED:
+            return *d - 128;
+
+        case DATASTREAM_FORMAT_8BIT_SIGNED:
+            return (int8_t) *d;
+
+        case DATASTREAM_FORMAT_16BIT_UNSIGNED:
+            return *(const uint16_t *)d - 32768;
+
+        case DATASTREAM_FORMAT_16BIT_SIGNED:
+            return *(const int16_t *)d;
+    }
+
+    return 0;
+}
+
+/**
+ * Update the interpolation history of a channel from its current input buffer.
+ *
+ * @param ch The channel to update.
+ * @param prime If true, fill the history with the first sample of the buffer (used when a stream starts).
+ * Otherwise, record the final samples of the buffer before it is replaced, so that interpolation continues
+ * seamlessly into the next buffer.
+ */
+void Mixer2::saveHistory(MixerChannel *ch, bool prime)
+{
+    const int keep = MIXER_RESAMPLE_TAPS - 1;
+
+    if (prime)
+    {
+        int16_t first = mixerReadCentred(ch->format, ch->in);
+
+        for (int i = 0; i < keep; i++)
+            ch->history[i] = first;
+
+        return;
+    }
+
+    int samples = ch->buffer.length() / ch->bytesPerSample;
+    int count = min(samples, keep);
+
+    // Age the existing history by the number of samples we're about to add, for buffers shorter than the filter.
+    memmove(&ch->history[0], &ch->history[count], (keep - count) * sizeof(int16_t));
+
+    for (int i = 0; i < count; i++)
+        ch->history[keep - count + i] = mixerReadCentred(ch->format, ch->in + (samples - count + i) * ch->bytesPerSample);
+}
+
+/**
+ * Provide a buffer of silence in the current output format, creating and caching it if necessary.
+ * The cached buffer is shared by successive calls, and is discarded whenever the output configuration changes.
+ *
+ * @return A buffer containing the silence level, packed for output.
+ */
+ManagedBuffer Mixer2::getSilenceBuffer()
+{
+    if (silenceBuffer.length() == 0)
+    {
+        int32_t level = (int32_t)(silenceLevel * (1 << MIXER_FIXED_FRACTION_BITS));
+
+        for (int i=0; i<CONFIG_MIXER_BUFFER_SIZE/bytesPerSampleOut; i++)
+            mixFixed[i] = level;
+
+        silenceBuffer = ManagedBuffer(CONFIG_MIXER_BUFFER_SIZE);
+        packFixed(silenceBuffer);
+    }
+
+    return silenceBuffer;
+}
+
+/**
+ * Scale, clamp and pack the fixed point accumulator into an output buffer.
+ *
+ * @param output The buffer to fill.
+ */
+void Mixer2::packFixed(ManagedBuffer &output)
+{
+    bool isUnsigned = (outputFormat == DATASTREAM_FORMAT_16BIT_UNSIGNED || outputFormat == DATASTREAM_FORMAT_8BIT_UNSIGNED);
+    int len = output.length() / bytesPerSampleOut;
+    int32_t range = (int32_t) outputRange;
+
+    // Fold the master volume, output range and accumulator precision into a single 8.24 fixed point multiplier.
+    int32_t scale = (int32_t)(volume * outputRange / CONFIG_MIXER_INTERNAL_RANGE * (1 << (24 - MIXER_FIXED_FRACTION_BITS)));
+    int32_t offset = isUnsigned ? range/2 : 0;
+    int32_t lo = isUnsigned ? 0 : -range/2;
+    int32_t hi = isUnsigned ? range : range/2;
+
+    switch (outputFormat)
+    {
+        case DATASTREAM_FORMAT_8BIT_UNSIGNED:
+            mixerPack<uint8_t>(&output[0], mixFixed, len, scale, offset, lo, hi, orMask);
+            break;
+
+        case DATASTREAM_FORMAT_8BIT_SIGNED:
+            mixerPack<int8_t>(&output[0], mixFixed, len, scale, offset, lo, hi, orMask);
+            break;
+
+        case DATASTREAM_FORMAT_16BIT_UNSIGNED:
+            mixerPack<uint16_t>(&output[0], mixFixed, len, scale, offset, lo, hi, orMask);
+            break;
+
+        case DATASTREAM_FORMAT_16BIT_SIGNED:
+            mixerPack<int16_t>(&output[0], mixFixed, len, scale, offset, lo, hi, orMask);
+            break;
+    }
+}
+
+/**
+ * Selects the mixing kernel used by this Mixer.
+ *
+ * @param enable true to use the fixed point kernel, false to use the floating point kernel.
+ * @return DEVICE_OK on success.
+ */
+int Mixer2::setFixedPoint(bool enable)
+{
+    // Carry each channel's position within its current buffer across to the other kernel.
+    for (MixerChannel *c = channels; c; c = c->next)
+    {
+        if (c->bytesPerSample > 2)
+            continue;
+
+        if (enable && !fixedPoint)
+            c->phase = (uint32_t)(c->position * 65536.0f);
+
+        if (!enable && fixedPoint)
+            c->position = c->phase / 65536.0f;
+    }
+
+    fixedPoint = enable;
+    return DEVICE_OK;
+}
+
+/**
+ * Determines if this Mixer is using its fixed point mixing kernel.
+ * @return true if the fixed point kernel is in use, false if the floating point kernel is in use.
+ */
+bool Mixer2::isFixedPoint()
+{
+    return fixedPoint;
+}
+
+/**
+ * Determines the number of CPU cycles taken by the most recent call to pull().
+ * Only available when CONFIG_MIXER_CYCLE_COUNT is enabled.
+ *
+ * @return the number of CPU cycles, or zero if cycle counting is disabled.
+ */
+uint32_t Mixer2::getPullCycles()
+{
+    return pullCycles;
+}
+
+/**
+ * Determines if every channel of this Mixer is idle, having provided no data for at least
+ * CONFIG_MIXER_CHANNEL_SLEEP_BUFFERS consecutive output buffers.
+ *
+ * @return true if the mixer is idle, false otherwise. Always false if CONFIG_MIXER_CHANNEL_SLEEP_BUFFERS is zero.
+ */
+bool Mixer2::isIdle()
+{
+#if CONFIG_MIXER_CHANNEL_SLEEP_BUFFERS > 0
+    for (MixerChannel *c = channels; c; c = c->next)
+        if (c->idleBuffers < CONFIG_MIXER_CHANNEL_SLEEP_BUFFERS)
+            return false;
+
+    return true;
+#else
+    // Channels never sleep, so the mixer is never considered idle.
+    return false;
+#endif
+}
+
+/**
+ * Wakes every channel of this Mixer, so that each is polled for data again.
+ * Typically used when the downstream component resumes after being stopped.
+ */
+void Mixer2::wake()
+{
+    for (MixerChannel *c = channels; c; c = c->next)
+    {
+        c->idleBuffers = 0;
+        c->asleep = false;
+    }
+}
+
 int MixerChannel::pullRequest()
 {
     pullRequests++;
+
+    // Re-arm this channel if it has been put to sleep.
+    if (asleep)
+    {
+        asleep = false;
+        idleBuffers = 0;
+    }
+
     return DEVICE_OK;
 }
 
@@ -297,6 +920,7 @@ int Mixer2::setFormat(int format)
     {
         this->outputFormat = format;
         this->bytesPerSampleOut = DATASTREAM_FORMAT_BYTES_PER_SAMPLE(format);
+        this->silenceBuffer = ManagedBuffer();
 
         return DEVICE_OK;
     }
@@ -317,6 +941,7 @@ Mixer2::setVolume(int volume)
         return DEVICE_INVALID_PARAMETER;
 
     this->volume = (float)volume / 1023.f;
+    this->silenceBuffer = ManagedBuffer();
     return DEVICE_OK;
 }
 
@@ -338,6 +963,7 @@ Mixer2::getVolume()
 int Mixer2::setSampleRange(uint16_t sampleRange)
 {
     this->outputRange = (float)sampleRange;
+    this->silenceBuffer = ManagedBuffer();
     return DEVICE_OK;
 }
 
@@ -386,6 +1012,7 @@ float Mixer2::getSampleRate()
 int Mixer2::setOrMask(uint32_t mask)
 {
     orMask = mask;
+    silenceBuffer = ManagedBuffer();
     return DEVICE_OK;
 }
 
@@ -402,6 +1029,7 @@ int Mixer2::setSilenceLevel(float level)
         return DEVICE_INVALID_PARAMETER;
 
     silenceLevel = level - 512.0f;
+    silenceBuffer = ManagedBuffer();
     return DEVICE_OK;
 }
 
@@ -39,11 +39,11 @@ SoundEmojiSynthesizer::SoundEmojiSynthesizer(uint16_t id, int sampleRate) : Coda
 {
     this->downStream = NULL;
     this->bufferSize = EMOJI_SYNTHESIZER_BUFFER_SIZE;
-    this->position = 0.0f;
     this->effect = NULL;
     this->partialBuffer = NULL;
     this->playbackCompleteIn = 0;
     this->buffer2 = ManagedBuffer(bufferSize);
+    this->pool = AudioBufferPool::get(bufferSize);
 
     this->samplesToWrite = 0;
     this->samplesWritten = 0;
@@ -95,6 +95,7 @@ int SoundEmojiSynthesizer::setBufferSize(int size)
         return DEVICE_INVALID_PARAMETER;
 
     this->bufferSize = size;
+    this->pool = AudioBufferPool::get(size);
     return DEVICE_OK;
 }
 
@@ -180,6 +181,7 @@ bool SoundEmojiSynthesizer::nextSoundEffect()
     }
 
     // We have a valid buffer. Set up our synthesizer to the requested parameters.
+    oscillator.load(effect->tone);
     samplesToWrite = determineSampleCount(effect->duration);
     frequency = effect->frequency;
     volume = effect->volume;
@@ -276,7 +278,8 @@ ManagedBuffer SoundEmojiSynthesizer::fillOutputBuffer()
             }
             else
             {
-                buffer = ManagedBuffer(bufferSize);
+                // Every sample up to bufferEnd is written below, so a recycled buffer can be used.
+                buffer = pool ? pool->allocate() : ManagedBuffer(bufferSize);
                 sample = (uint16_t *) &buffer[0];
             }
 
@@ -286,10 +289,13 @@ ManagedBuffer SoundEmojiSynthesizer::fillOutputBuffer()
         // Generate some samples with the current effect parameters.
         while(samplesWritten < samplesToWrite)
         {
-            float skip = ((EMOJI_SYNTHESIZER_TONE_WIDTH_F * frequency) / sampleRate);
+            // Effects only update the frequency and volume between steps, so the oscillator is configured once per step.
             float gain = (sampleRange * volume) / 1024.0f;
             float offset = 512.0f - (512.0f * gain);
 
+            oscillator.setFrequency(frequency, sampleRate);
+            oscillator.setLevel(gain, offset, orMask);
+
             int effectStepEnd[EMOJI_SYNTHESIZER_TONE_EFFECTS];
 
             for (int i = 0; i < EMOJI_SYNTHESIZER_TONE_EFFECTS; i++)
@@ -310,20 +316,13 @@ ManagedBuffer SoundEmojiSynthesizer::fillOutputBuffer()
                 if (sample == bufferEnd)
                     return buffer;
 
-                // Synthesize a sample
-                float s = effect->tone.tonePrint(effect->tone.parameter, (int) position);
-
-                // Apply volume scaling and OR mask (if specified).
-                *sample = ((uint16_t) ((s * gain) + offset)) | orMask;
+                // Synthesize as many samples as we can, up to the end of this step or the buffer.
+                int n = min(stepEndPosition - samplesWritten, (int) (bufferEnd - sample));
+                oscillator.renderBlock(sample, n);
 
                 // Move on our pointers.
-                sample++;
-                samplesWritten++;
-                position += skip;
-
-                // Keep our toneprint pointer in range
-                while(position > EMOJI_SYNTHESIZER_TONE_WIDTH_F)
-                    position -= EMOJI_SYNTHESIZER_TONE_WIDTH_F;
+                sample += n;
+                samplesWritten += n;
             }
 
             // Invoke the effect function for any effects that are due.
@@ -0,0 +1,167 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "WavetableOscillator.h"
+#include "Synthesizer.h"
+
+using namespace codal;
+
+// The built in TonePrints that are rendered from a wavetable, in the order of WavetableOscillator::tables.
+static const TonePrintFunction wavetableTonePrints[EMOJI_SYNTHESIZER_WAVETABLES] = {
+    Synthesizer::SineTone,
+    Synthesizer::SawtoothTone,
+    Synthesizer::TriangleTone,
+    Synthesizer::SquareWaveTone
+};
+
+uint16_t WavetableOscillator::tables[EMOJI_SYNTHESIZER_WAVETABLES][EMOJI_SYNTHESIZER_WAVETABLE_SIZE + 1];
+bool WavetableOscillator::tablesReady = false;
+
+/**
+ * Sample one cycle of each built in TonePrint into the shared wavetables.
+ */
+void WavetableOscillator::buildTables()
+{
+    for (int t = 0; t < EMOJI_SYNTHESIZER_WAVETABLES; t++)
+    {
+        // TonePrints are defined over EMOJI_SYNTHESIZER_TONE_WIDTH positions. Sample them at the resolution of our tables.
+        // The built in TonePrints take no parameter.
+        for (int i = 0; i < EMOJI_SYNTHESIZER_WAVETABLE_SIZE; i++)
+            tables[t][i] = wavetableTonePrints[t](NULL, (i * EMOJI_SYNTHESIZER_TONE_WIDTH) / EMOJI_SYNTHESIZER_WAVETABLE_SIZE);
+
+        // Repeat the first sample at the end, so the last entry can be interpolated without wrapping.
+        tables[t][EMOJI_SYNTHESIZER_WAVETABLE_SIZE] = tables[t][0];
+    }
+
+    tablesReady = true;
+}
+
+/**
+ * Constructor.
+ * Creates an oscillator generating silence, until a TonePrint is loaded.
+ */
+WavetableOscillator::WavetableOscillator()
+{
+    // Sample the wavetables up front, as TonePrints are loaded from the audio pipeline.
+    if (!tablesReady)
+        buildTables();
+
+    table = tables[0];
+    tone.tonePrint = wavetableTonePrints[0];
+    tone.parameter = NULL;
+    phase = 0;
+    step = 0;
+    gain = 0;
+    offset = 0;
+    orMask = 0;
+}
+
+/**
+ * Select the TonePrint to render.
+ * The phase of the oscillator is retained, so waveforms can be changed without discontinuity.
+ *
+ * @param tone The TonePrint to render.
+ */
+void WavetableOscillator::load(TonePrint &tone)
+{
+    this->tone = tone;
+    this->table = NULL;
+
+    for (int t = 0; t < EMOJI_SYNTHESIZER_WAVETABLES; t++)
+        if (tone.tonePrint == wavetableTonePrints[t])
+            this->table = tables[t];
+}
+
+/**
+ * Define the frequency to generate.
+ *
+ * @param frequency The frequency to generate, in Hz.
+ * @param sampleRate The sample rate of the output, in samples per second.
+ */
+void WavetableOscillator::setFrequency(float frequency, float sampleRate)
+{
+    // Frequencies at or above the sample rate wrap, just as the TonePrint position previously did.
+    float cycles = frequency / sampleRate;
+    cycles -= (int) cycles;
+
+    if (cycles < 0)
+        cycles += 1.0f;
+
+    // Rounding may yield a full cycle, which correctly wraps to zero.
+    step = (uint32_t) (int64_t) (cycles * 4294967296.0f);
+}
+
+/**
+ * Define the scaling applied to each sample. Each output sample is computed as (tone * gain) + offset, OR'd with the given mask.
+ *
+ * @param gain The gain to apply to TonePrint samples.
+ * @param offset The offset to apply after scaling.
+ * @param orMask A bitmask that is logically OR'd with each output sample.
+ */
+void WavetableOscillator::setLevel(float gain, float offset, uint16_t orMask)
+{
+    this->gain = (int32_t) (gain * 65536.0f);
+    this->offset = (int32_t) (offset * 65536.0f);
+    this->orMask = orMask;
+}
+
+/**
+ * Render a block of samples.
+ *
+ * @param out The buffer to write samples into.
+ * @param n The number of samples to write.
+ */
+void WavetableOscillator::renderBlock(uint16_t *out, int n)
+{
+    uint32_t p = phase;
+
+    if (table)
+    {
+        // Interpolated samples carry a further 16 fractional bits, so the offset is scaled to match.
+        int64_t o = (int64_t) offset << 16;
+
+        while (n--)
+        {
+            // Interpolate between adjacent table entries, using the next 16 bits of the phase as a 0.16 fraction.
+            const uint16_t *t = &table[p >> (32 - CONFIG_EMOJI_SYNTHESIZER_WAVETABLE_BITS)];
+            int32_t fraction = (p >> (16 - CONFIG_EMOJI_SYNTHESIZER_WAVETABLE_BITS)) & 0xFFFF;
+            int32_t s = ((int32_t) t[0] << 16) + ((int32_t) t[1] - (int32_t) t[0]) * fraction;
+
+            *out++ = ((uint16_t) (((int64_t) s * gain + o) >> 32)) | orMask;
+            p += step;
+        }
+    }
+    else
+    {
+        // TonePrints without a wavetable, such as noise, are rendered sample by sample at their full resolution.
+        while (n--)
+        {
+            *out++ = ((uint16_t) (((int64_t) tone.tonePrint(tone.parameter, p >> (32 - EMOJI_SYNTHESIZER_TONE_WIDTH_BITS)) * gain + offset) >> 16)) | orMask;
+            p += step;
+        }
+    }
+
+    phase = p;
+}
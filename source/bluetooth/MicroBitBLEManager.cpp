@@ -689,6 +689,16 @@ bool MicroBitBLEManager::getConnected()
     return ble_conn_state_peripheral_conn_count() > 0;
 }
 
+/**
+ * Determine the ATT MTU negotiated with the given connection
+ * @param connection The connection handle
+ * @return the effective ATT MTU, in bytes. Notifications may carry up to this size less 3 bytes.
+ */
+uint16_t MicroBitBLEManager::getMTU(uint16_t connection)
+{
+    return nrf_ble_gatt_eff_mtu_get( &m_gatt, connection);
+}
+
 
 #if CONFIG_ENABLED(MICROBIT_BLE_EDDYSTONE_URL)
 /**
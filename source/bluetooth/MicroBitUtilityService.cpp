@@ -52,7 +52,7 @@ typedef enum replyState_t
 
 //TODO How to choose service and characteristic IDs?
 const uint16_t MicroBitUtilityService::serviceUUID               = 0x0001;
-const uint16_t MicroBitUtilityService::charUUID[ mbbs_cIdxCOUNT] = { 0x0002 };
+const uint16_t MicroBitUtilityService::charUUID[ mbbs_cIdxCOUNT] = { 0x0002, 0x0003 };
 
 
 MicroBitUtilityService *MicroBitUtilityService::shared = NULL;
@@ -73,6 +73,7 @@ class codal::MicroBitUtilityWorkspace
     uint8_t   replyLength;
     uint8_t   jobLow;
     bool      lock;
+    uint32_t  streamed;
 
     /**
      * Constructor.
@@ -93,6 +94,7 @@ class codal::MicroBitUtilityWorkspace
         replyState = replyStateClear;
         replyLength = 0;
         jobLow = 0;
+        streamed = 0;
     }
 
     /**
@@ -172,10 +174,11 @@ MicroBitUtilityService *MicroBitUtilityService::createShared( BLEDevice &_ble, E
  * @param _log An instance of a MicroBitLog to interface with.
  */
 MicroBitUtilityService::MicroBitUtilityService( BLEDevice &_ble, EventModel &_messageBus, MicroBitStorage &_storage, MicroBitLog &_log) :
-    messageBus(_messageBus), storage(_storage), log(_log), workspace(NULL)
+    messageBus(_messageBus), storage(_storage), log(_log), streamChunk(0), workspace(NULL)
 {
     // Initialise data
     memclr( characteristicValue, sizeof( characteristicValue));
+    memclr( streamValue, sizeof( streamValue));
 
     // Register the base UUID and create the service.
     RegisterBaseUUID( bs_base_uuid);
@@ -185,6 +188,11 @@ MicroBitUtilityService::MicroBitUtilityService( BLEDevice &_ble, EventModel &_me
                          characteristicValue,
                          0, sizeof(characteristicValue),
                          microbit_propWRITE | microbit_propWRITE_WITHOUT | microbit_propNOTIFY);
+
+    CreateCharacteristic( mbbs_cIdxSTREAM, charUUID[ mbbs_cIdxSTREAM],
+                         streamValue,
+                         0, sizeof(streamValue),
+                         microbit_propNOTIFY);
     
     if ( getConnected())
         listen(true);
@@ -307,6 +315,9 @@ int MicroBitUtilityService::processRequest()
             case requestTypeLogRead:
                 result = processLogRead();
                 break;
+            case requestTypeLogStream:
+                result = processLogStream();
+                break;
             default:
                 break;
         }
@@ -379,4 +390,77 @@ int MicroBitUtilityService::processLogRead()
     return DEVICE_OK;
 }
 
+
+/**
+ * Process request typeLogStream
+ * @return DEVICE_OK if finished
+ */
+int MicroBitUtilityService::processLogStream()
+{
+    requestLogStream_t *request = (requestLogStream_t *) &workspace->request;
+
+    if ( workspace->replyState == replyStateClear)
+    {
+        if ( request->format > requestLogCSV)
+        {
+            workspace->setReplyError( DEVICE_INVALID_PARAMETER);
+        }
+        else if ( !notifyChrValueEnabled( mbbs_cIdxSTREAM))
+        {
+            workspace->setReplyError( DEVICE_INVALID_STATE);
+        }
+        else
+        {
+            // Send the largest chunks the connection allows
+            uint16_t mtu = MicroBitBLEManager::getInstance()->getMTU( getConnectionHandle());
+            streamChunk = mtu > 3 ? mtu - 3 : 0;
+            if ( streamChunk > sizeof( streamValue))
+                streamChunk = sizeof( streamValue);
+
+            uint32_t start = request->index;
+            int result = log.exportData( *this, request->index, (DataFormat) request->format);
+            workspace->streamed += request->index - start;
+
+            if ( result == DEVICE_BUSY)
+            {
+                // The BLE stack has no more space. Give it time to transmit, then resume.
+                fiber_sleep( MicroBitUtilityService_SLEEP);
+                return result;
+            }
+
+            if ( result)
+                workspace->setReplyError( result);
+            else
+                workspace->setReply( workspace->streamed);
+        }
+    }
+
+    return sendReply( &workspace->reply, offsetof(reply_t, data) + workspace->replyLength);
+}
+
+
+/**
+ * Callback. Invoked by MicroBitLog::exportData() with the next region of log data to stream.
+ * Sends the data as notifications of the stream characteristic, as far as the BLE stack will accept them.
+ * @param data Data to send
+ * @param len Length of the data
+ * @return The number of bytes sent
+ */
+int MicroBitUtilityService::writeData( const uint8_t *data, uint32_t len)
+{
+    uint32_t sent = 0;
+
+    while ( sent < len && streamChunk)
+    {
+        uint16_t block = min( len - sent, streamChunk);
+
+        if ( !notifyChrValue( mbbs_cIdxSTREAM, data + sent, block))
+            break;
+
+        sent += block;
+    }
+
+    return sent;
+}
+
 #endif
@@ -0,0 +1,54 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host build replacement for codal-core's CodalConfig.h, providing just enough of the
+  * configuration environment to compile device sources natively.
+  */
+
+#ifndef CODAL_CONFIG_H
+#define CODAL_CONFIG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CONFIG_ENABLED(X)       (X == 1)
+#define CONFIG_DISABLED(X)      (X != 1)
+
+typedef uint64_t CODAL_TIMESTAMP;
+
+#ifndef min
+#define min(a,b)                ((a)<(b)?(a):(b))
+#endif
+
+#ifndef max
+#define max(a,b)                ((a)>(b)?(a):(b))
+#endif
+
+#define __DMB()                 __sync_synchronize()
+
+#endif
@@ -0,0 +1,49 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host build replacement for codal-core's CodalFiber.h. There is no scheduler, so locks are never contended,
+  * fibers run to completion as soon as they are created, and sleeping simply waits.
+  */
+
+#ifndef CODAL_FIBER_H
+#define CODAL_FIBER_H
+
+#include "CodalConfig.h"
+
+namespace codal
+{
+    class FiberLock
+    {
+        public:
+        void wait() {}
+        void notify() {}
+    };
+
+    void create_fiber(void (*entry_fn)(void *), void *param);
+    void fiber_sleep(unsigned long t);
+}
+
+#endif
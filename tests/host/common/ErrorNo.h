@@ -0,0 +1,43 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host build replacement for codal-core's ErrorNo.h. The codes match codal-core.
+  */
+
+#ifndef ERROR_NO_H
+#define ERROR_NO_H
+
+#define DEVICE_OK                   0
+#define DEVICE_INVALID_PARAMETER    -1001
+#define DEVICE_NOT_SUPPORTED        -1002
+#define DEVICE_NO_RESOURCES         -1005
+#define DEVICE_BUSY                 -1006
+#define DEVICE_CANCELLED            -1007
+#define DEVICE_NO_DATA              -1012
+#define DEVICE_NOT_IMPLEMENTED      -1013
+#define DEVICE_INVALID_STATE        -1015
+
+#endif
@@ -0,0 +1,56 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host implementations of the codal-core system timer functions, running from the host's monotonic clock.
+  */
+
+#include <time.h>
+#include "Timer.h"
+#include "ErrorNo.h"
+
+using namespace codal;
+
+CODAL_TIMESTAMP codal::system_timer_current_time_us()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (CODAL_TIMESTAMP)t.tv_sec * 1000000 + t.tv_nsec / 1000;
+}
+
+CODAL_TIMESTAMP codal::system_timer_current_time()
+{
+    return system_timer_current_time_us() / 1000;
+}
+
+int codal::system_timer_wait_us(uint32_t period)
+{
+    CODAL_TIMESTAMP start = system_timer_current_time_us();
+
+    while (system_timer_current_time_us() - start < period);
+
+    return DEVICE_OK;
+}
@@ -0,0 +1,112 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host build replacement for codal-core's ManagedBuffer.h: a reference counted, heap allocated byte array.
+  * As on the device, the count is held in steps of two, so a single reference is represented by a count of 3.
+  */
+
+#ifndef MANAGED_BUFFER_H
+#define MANAGED_BUFFER_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace codal
+{
+    struct BufferData
+    {
+        uint16_t    refCount;
+        uint16_t    length;
+        uint8_t     payload[0];
+    };
+
+    class ManagedBuffer
+    {
+        BufferData *ptr;
+
+        void init(const uint8_t *data, int length)
+        {
+            ptr = NULL;
+
+            if (length <= 0)
+                return;
+
+            ptr = (BufferData *) malloc(sizeof(BufferData) + length);
+            ptr->refCount = 3;
+            ptr->length = length;
+
+            if (data)
+                memcpy(ptr->payload, data, length);
+            else
+                memset(ptr->payload, 0, length);
+        }
+
+        // Kept out of line: once inlined, GCC cannot see that the count protects other holders
+        // of the buffer and reports spurious -Wuse-after-free warnings.
+        __attribute__((noinline)) void release()
+        {
+            BufferData *p = ptr;
+            ptr = NULL;
+
+            if (p)
+            {
+                p->refCount -= 2;
+
+                if (p->refCount == 1)
+                    free(p);
+            }
+        }
+
+        public:
+        ManagedBuffer() : ptr(NULL) {}
+        ManagedBuffer(int length) { init(NULL, length); }
+        ManagedBuffer(const uint8_t *data, int length) { init(data, length); }
+        ManagedBuffer(const ManagedBuffer &b) : ptr(b.ptr) { if (ptr) ptr->refCount += 2; }
+        ~ManagedBuffer() { release(); }
+
+        ManagedBuffer& operator=(const ManagedBuffer &b)
+        {
+            // Take our reference before releasing the current one, in case both are the same buffer.
+            BufferData *p = b.ptr;
+
+            if (p)
+                p->refCount += 2;
+
+            release();
+            ptr = p;
+
+            return *this;
+        }
+
+        int length() const { return ptr ? ptr->length : 0; }
+        uint8_t *getBytes() const { return ptr ? ptr->payload : NULL; }
+        BufferData *getBufferData() const { return ptr; }
+        uint8_t& operator[](int i) { return ptr->payload[i]; }
+    };
+}
+
+#endif
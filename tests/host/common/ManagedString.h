@@ -0,0 +1,81 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host build replacement for codal-core's ManagedString.h: an immutable string, held in a ManagedBuffer with its
+  * terminating NUL. As on the device, even the empty string has a buffer.
+  */
+
+#ifndef MANAGED_STRING_H
+#define MANAGED_STRING_H
+
+#include <stdio.h>
+#include "ManagedBuffer.h"
+
+namespace codal
+{
+    class ManagedString
+    {
+        ManagedBuffer   data;
+
+        void init(const char *str, int length)
+        {
+            if (length < 0)
+                length = 0;
+
+            data = ManagedBuffer(length + 1);
+            memcpy(data.getBytes(), str, length);
+        }
+
+        public:
+        static ManagedString EmptyString;
+
+        ManagedString() { init("", 0); }
+        ManagedString(const char *str) { init(str, strlen(str)); }
+        ManagedString(const char *str, const int16_t length) { init(str, length); }
+        ManagedString(const char value) { init(&value, 1); }
+        ManagedString(const int value) { char s[12]; init(s, snprintf(s, sizeof(s), "%d", value)); }
+
+        int length() const { return data.length() - 1; }
+        const char *toCharArray() const { return (const char *)data.getBytes(); }
+        char charAt(int16_t index) const { return index >= 0 && index < length() ? toCharArray()[index] : 0; }
+
+        bool operator==(const ManagedString &x) const { return length() == x.length() && memcmp(toCharArray(), x.toCharArray(), length()) == 0; }
+        bool operator!=(const ManagedString &x) const { return !(*this == x); }
+
+        friend ManagedString operator+(const ManagedString &a, const ManagedString &b)
+        {
+            ManagedString r;
+
+            r.data = ManagedBuffer(a.length() + b.length() + 1);
+            memcpy(r.data.getBytes(), a.toCharArray(), a.length());
+            memcpy(r.data.getBytes() + a.length(), b.toCharArray(), b.length());
+
+            return r;
+        }
+    };
+}
+
+#endif
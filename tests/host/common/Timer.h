@@ -0,0 +1,46 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host build replacements for the codal-core system timer functions.
+  * HostTimer.cpp runs the timer from the host's monotonic clock. Harnesses that need a repeatable clock provide
+  * their own implementation instead.
+  */
+
+#ifndef CODAL_TIMER_H
+#define CODAL_TIMER_H
+
+#include "CodalConfig.h"
+
+namespace codal
+{
+    CODAL_TIMESTAMP system_timer_current_time();
+    CODAL_TIMESTAMP system_timer_current_time_us();
+    int system_timer_wait_us(uint32_t period);
+    int system_timer_event_after(CODAL_TIMESTAMP period, uint16_t id, uint16_t value);
+    int system_timer_cancel_event(uint16_t id, uint16_t value);
+}
+
+#endif
@@ -0,0 +1,58 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host implementations of the codal-core functions MicroBitLog depends upon.
+  * The system timer is under the control of the test, so that timestamps are repeatable.
+  */
+
+#include "MicroBitLog.h"
+
+using namespace codal;
+
+CODAL_TIMESTAMP hostTime = 0;
+
+EventModel* EventModel::defaultEventBus = NULL;
+ManagedString ManagedString::EmptyString;
+
+CODAL_TIMESTAMP codal::system_timer_current_time()
+{
+    return hostTime;
+}
+
+int codal::system_timer_event_after(CODAL_TIMESTAMP period, uint16_t id, uint16_t value)
+{
+    return DEVICE_OK;
+}
+
+int codal::system_timer_cancel_event(uint16_t id, uint16_t value)
+{
+    return DEVICE_OK;
+}
+
+void codal::create_fiber(void (*entry_fn)(void *), void *param)
+{
+    entry_fn(param);
+}
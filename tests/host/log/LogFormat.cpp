@@ -0,0 +1,385 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host test of the MicroBitLog binary storage format.
+  *
+  * Each case logs the same rows to a text log and a binary log, each held in a simulated interface chip flash, and
+  * checks that every API reading the logs returns identical data. The data of the binary log is also checked to be safe
+  * to hold in the HTML comment of MY_DATA.HTM, and the space taken by each log reported.
+  *
+  * Finally, both logs are filled with accelerometer rows, to compare the number of rows each can hold.
+  *
+  * If a directory is given, the MY_DATA.HTM of each log is written there, to check the page renders them identically.
+  */
+
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include "MicroBitLog.h"
+
+using namespace codal;
+
+// The size of the simulated flash. This matches the storage the interface chip provides on the micro:bit V2.
+#define FLASH_SIZE          0x1F000
+
+// The sizes of the chunks in which the logs are read back, exercising both sequential and random access.
+static const uint32_t readSizes[] = { 1, 7, 100, 333, 4096 };
+
+extern CODAL_TIMESTAMP hostTime;
+
+struct Value
+{
+    const char *key;
+    std::string value;
+};
+
+/**
+ * A text log and a binary log, to which every operation is applied in turn.
+ */
+class LogPair
+{
+    public:
+    MicroBitUSBFlashManager     *flash[2];
+    MicroBitLog                 *log[2];
+    MicroBitPowerManager        power;
+    NRF52Serial                 serial;
+    TimeStampFormat             timeStamp;
+
+    LogPair(TimeStampFormat timeStamp) : timeStamp(timeStamp)
+    {
+        hostTime = 0;
+
+        for (int i = 0; i < 2; i++)
+        {
+            flash[i] = new MicroBitUSBFlashManager(FLASH_SIZE);
+            log[i] = NULL;
+        }
+
+        reboot();
+    }
+
+    /**
+     * Creates new MicroBitLog instances on the existing flash, as though the micro:bit had been reset.
+     */
+    void reboot()
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            delete log[i];
+            log[i] = new MicroBitLog(*flash[i], power, serial);
+            log[i]->setStorageFormat(i ? LogFormat::Binary : LogFormat::Text);
+            log[i]->setTimeStamp(timeStamp);
+        }
+    }
+
+    int row(std::initializer_list<Value> values)
+    {
+        int r = DEVICE_OK;
+
+        for (int i = 0; i < 2; i++)
+        {
+            log[i]->beginRow();
+
+            for (const Value &v : values)
+                log[i]->logData(v.key, v.value.c_str());
+
+            r = log[i]->endRow();
+        }
+
+        return r;
+    }
+
+    void text(const char *s)
+    {
+        for (int i = 0; i < 2; i++)
+            log[i]->logString(s);
+    }
+};
+
+/**
+ * Converts a number to text, as MakeCode and MicroPython programs typically log it.
+ */
+static std::string str(int n)
+{
+    return std::to_string(n);
+}
+
+static std::string str(float f)
+{
+    char s[16];
+    snprintf(s, sizeof(s), "%.2f", f);
+    return s;
+}
+
+/**
+ * Readings from the accelerometer, logged every 20ms or so with a timestamp in seconds.
+ */
+static int accelerometer(LogPair &p, int i)
+{
+    hostTime += 20 + i % 3;
+
+    return p.row({ { "x", str((int) (600 * sin(i * 0.05)) + i % 7) }, { "y", str((int) (300 * cos(i * 0.02)) - i % 5) }, { "z", str(-1000 + i % 40) } });
+}
+
+static void accelerometerCase(LogPair &p)
+{
+    for (int i = 0; i < 2000; i++)
+        accelerometer(p, i);
+}
+
+/**
+ * Temperature, light level and compass heading, logged every second with a timestamp in milliseconds.
+ */
+static void sensorsCase(LogPair &p)
+{
+    for (int i = 0; i < 1000; i++)
+    {
+        hostTime += 1000;
+        p.row({ { "temperature", str(21 + (i / 100) % 4) }, { "light", str((i * 37) % 256) }, { "heading", str((i * 7) % 360) } });
+    }
+}
+
+/**
+ * Values of every type, columns added partway through, and rows too wide to be repeated.
+ */
+static void mixedCase(LogPair &p)
+{
+    static const char *values[] = { "", "hello", "two words", "caf\xc3\xa9", "-", "1.5", "-0.25", "3.14159", "007", "1.", "-0", "0",
+        "12345678901234567", "2251799813685247", "-2251799813685248", "1e5", "0.000000001", "99999999.99999999", "a-->b", "-1-" };
+    const int count = sizeof(values) / sizeof(values[0]);
+
+    p.text("A line of text\n");
+
+    for (int i = 0; i < 300; i++)
+    {
+        hostTime += 12345;
+
+        if (i < 100)
+            p.row({ { "a", values[i % count] }, { "b", values[(i * 7) % count] }, { "c", str(i) } });
+        else if (i < 200)
+            p.row({ { "a", values[i % count] }, { "d", str(i * 0.5f) }, { "c", str(-i) } });
+        else
+            p.row({ { "c", str(i) }, { "e", "x" }, { "f", "1" }, { "g", "2" }, { "h", "3" }, { "i", "4" }, { "j", "5" }, { "k", "6" },
+                { "l", "7" }, { "m", "8" }, { "n", "9" }, { "o", "10" }, { "p", "11" }, { "q", "12" }, { "r", "13" }, { "s", "" }, { "t", values[i % count] } });
+
+        if (i % 50 == 0)
+            p.text("Another line of text\n");
+    }
+}
+
+/**
+ * Rows logged across resets of the micro:bit, which restart the timer.
+ */
+static void rebootCase(LogPair &p)
+{
+    for (int i = 0; i < 1500; i++)
+    {
+        if (i % 500 == 499)
+        {
+            p.reboot();
+            hostTime = 0;
+        }
+
+        accelerometer(p, i);
+    }
+}
+
+struct TestCase
+{
+    const char          *name;
+    TimeStampFormat     timeStamp;
+    void                (*generate)(LogPair &p);
+};
+
+static const TestCase cases[] = {
+    { "accelerometer", TimeStampFormat::Seconds, accelerometerCase },
+    { "sensors", TimeStampFormat::Milliseconds, sensorsCase },
+    { "mixed", TimeStampFormat::Minutes, mixedCase },
+    { "reboot", TimeStampFormat::Seconds, rebootCase },
+};
+
+/**
+ * Determines the extent of the data held in a log's flash.
+ */
+static void dataRegion(MicroBitUSBFlashManager &flash, uint32_t &start, uint32_t &end)
+{
+    const MicroBitLogMetaData *meta = (const MicroBitLogMetaData *) &flash.memory[2048];
+
+    start = strtoul(meta->dataStart, NULL, 16);
+    end = start;
+
+    while (flash.memory[end] != 0xFF)
+        end++;
+}
+
+/**
+ * Reads the whole of the given data format from both logs, in chunks of the given size.
+ *
+ * @return true if the logs are identical.
+ */
+static bool compareData(LogPair &p, DataFormat format, uint32_t chunk)
+{
+    std::string data[2];
+
+    for (int i = 0; i < 2; i++)
+    {
+        uint32_t length = p.log[i]->getDataLength(format);
+        data[i].resize(length);
+
+        for (uint32_t index = 0; index < length; index += chunk)
+            if (p.log[i]->readData(&data[i][index], index, min(chunk, length - index), format, length) != DEVICE_OK)
+                return false;
+    }
+
+    return data[0] == data[1];
+}
+
+/**
+ * Checks the data of a binary log can be held in the HTML comment of MY_DATA.HTM, without changing or ending it.
+ *
+ * @return true if the data is safe.
+ */
+static bool checkRecords(MicroBitUSBFlashManager &flash)
+{
+    uint32_t start, end;
+    dataRegion(flash, start, end);
+
+    std::string data((const char *) &flash.memory[start], end - start);
+    size_t viewerEnd = data.find("</script><!--\n");
+
+    // The log must begin with the VIEWER record, which is the only place a comment may end.
+    if (data.compare(0, 11, "--><script>") != 0 || viewerEnd == std::string::npos)
+        return false;
+
+    data = data.substr(viewerEnd + 14);
+
+    return data.find('\0') == std::string::npos && data.find('\r') == std::string::npos && data.find("-->") == std::string::npos &&
+        data.find("--!>") == std::string::npos;
+}
+
+/**
+ * Writes the MY_DATA.HTM file of a log, as the interface chip would present it.
+ */
+static void writeFile(const char *dir, const char *name, const char *format, MicroBitUSBFlashManager &flash)
+{
+    std::string path = std::string(dir) + "/" + name + "-" + format + ".htm";
+    FILE *f = fopen(path.c_str(), "wb");
+
+    if (f)
+    {
+        fwrite(flash.memory.data(), 1, flash.memory.size(), f);
+        fclose(f);
+    }
+}
+
+/**
+ * Fills a log with accelerometer rows.
+ *
+ * @param dir The directory to write the log's MY_DATA.HTM into, or NULL.
+ * @return the number of rows the log holds.
+ */
+static int capacity(LogFormat format, const char *dir)
+{
+    MicroBitUSBFlashManager flash(FLASH_SIZE);
+    MicroBitPowerManager power;
+    NRF52Serial serial;
+    MicroBitLog log(flash, power, serial);
+    int rows = 0;
+
+    hostTime = 0;
+    log.setStorageFormat(format);
+    log.setTimeStamp(TimeStampFormat::Seconds);
+
+    for (int i = 0; ; i++)
+    {
+        hostTime += 20 + i % 3;
+
+        log.beginRow();
+        log.logData("x", str((int) (600 * sin(i * 0.05)) + i % 7).c_str());
+        log.logData("y", str((int) (300 * cos(i * 0.02)) - i % 5).c_str());
+        log.logData("z", str(-1000 + i % 40).c_str());
+
+        if (log.endRow() != DEVICE_OK)
+            break;
+
+        rows++;
+    }
+
+    if (dir)
+        writeFile(dir, "full", format == LogFormat::Binary ? "binary" : "text", flash);
+
+    return log.getNumberOfRows() - 1 == (uint32_t) rows ? rows : -1;
+}
+
+int main(int argc, char **argv)
+{
+    int failures = 0;
+
+    printf("%-16s %6s %12s %12s %8s\n", "case", "rows", "text bytes", "binary bytes", "ratio");
+
+    for (const TestCase &c : cases)
+    {
+        LogPair p(c.timeStamp);
+        c.generate(p);
+
+        bool pass = checkRecords(*p.flash[1]) && p.log[0]->getNumberOfRows() == p.log[1]->getNumberOfRows();
+
+        for (uint32_t size : readSizes)
+            pass = pass && compareData(p, DataFormat::CSV, size) && compareData(p, DataFormat::HTML, size);
+
+        uint32_t rows = p.log[0]->getNumberOfRows();
+
+        for (uint32_t r = 0; r < rows; r += 37)
+            pass = pass && p.log[0]->getRows(r, 5) == p.log[1]->getRows(r, 5);
+
+        uint32_t start, end[2];
+        for (int i = 0; i < 2; i++)
+            dataRegion(*p.flash[i], start, end[i]);
+
+        printf("%-16s %6d %12d %12d %8.2f %s\n", c.name, rows, end[0] - start, end[1] - start, (float) (end[0] - start) / (end[1] - start), pass ? "" : "FAIL");
+
+        if (argc > 1)
+        {
+            writeFile(argv[1], c.name, "text", *p.flash[0]);
+            writeFile(argv[1], c.name, "binary", *p.flash[1]);
+        }
+
+        if (!pass)
+            failures++;
+    }
+
+    int text = capacity(LogFormat::Text, argc > 1 ? argv[1] : NULL);
+    int binary = capacity(LogFormat::Binary, argc > 1 ? argv[1] : NULL);
+
+    printf("capacity: %d rows of accelerometer data as text, %d as binary (%.2fx)\n", text, binary, (float) binary / text);
+
+    if (text <= 0 || binary <= 0)
+        failures++;
+
+    printf("%d of %d cases failed\n", failures, (int)(sizeof(cases) / sizeof(cases[0])) + 1);
+
+    return failures ? 1 : 0;
+}
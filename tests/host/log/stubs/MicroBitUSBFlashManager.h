@@ -0,0 +1,138 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host build replacement for MicroBitUSBFlashManager.h, and the codal-core types MicroBitLog depends upon.
+  *
+  * The interface chip's flash is simulated in RAM. As with NOR flash, writes can only clear bits, and pages
+  * must be erased to set them again.
+  */
+
+#ifndef MICROBIT_USB_FLASH_MANAGER_H
+#define MICROBIT_USB_FLASH_MANAGER_H
+
+#include <vector>
+#include <string>
+#include "CodalCompat.h"
+#include "CodalFiber.h"
+#include "Timer.h"
+#include "ErrorNo.h"
+#include "NVMController.h"
+#include "ManagedString.h"
+
+#define MICROBIT_ID_LOG                             41
+#define MICROBIT_POWER_MANAGER_EVT_POWER_OFF        1
+#define MICROBIT_POWER_MANAGER_EVT_DEEP_SLEEP       2
+#define MESSAGE_BUS_LISTENER_IMMEDIATE              0x0080
+
+#ifndef MICROBIT_LOG_MODE
+#define MICROBIT_LOG_MODE                           0
+#endif
+
+namespace codal
+{
+    class Event
+    {
+        public:
+        uint16_t        source;
+        uint16_t        value;
+
+        Event(uint16_t source = 0, uint16_t value = 0) : source(source), value(value) {}
+    };
+
+    // There is no message bus, so MicroBitLog never listens for events.
+    class EventModel
+    {
+        public:
+        static EventModel *defaultEventBus;
+
+        template <typename T>
+        int listen(int id, int value, T *object, void (T::*method)(Event), uint16_t flags = 0) { return DEVICE_OK; }
+    };
+
+    struct MicroBitVersion
+    {
+        int     board;
+        int     daplink;
+        int     i2c;
+    };
+
+    class MicroBitPowerManager
+    {
+        public:
+        uint16_t    id = 0;
+
+        MicroBitVersion getVersion() { MicroBitVersion v = { 0, 256, 0 }; return v; }
+        void powerDownDisable() {}
+        void powerDownEnable() {}
+    };
+
+    typedef struct
+    {
+        ManagedString       fileName;
+        int                 fileSize;
+        bool                visible;
+    } MicroBitUSBFlashConfig;
+
+    class MicroBitUSBFlashManager : public NVMController
+    {
+        MicroBitUSBFlashConfig  config;
+
+        public:
+        std::vector<uint8_t>    memory;
+
+        MicroBitUSBFlashManager(uint32_t size) : memory(size, 0xFF) { config.fileSize = 0; config.visible = false; }
+
+        MicroBitUSBFlashConfig getConfiguration() { return config; }
+        int setConfiguration(MicroBitUSBFlashConfig config, bool persist = false) { this->config = config; return DEVICE_OK; }
+        int remount() { return DEVICE_OK; }
+
+        virtual uint32_t getFlashStart() override { return 0; }
+        virtual uint32_t getFlashEnd() override { return memory.size(); }
+        virtual uint32_t getPageSize() override { return 4096; }
+
+        virtual int read(uint32_t* dest, uint32_t address, uint32_t length) override
+        {
+            memcpy(dest, &memory[address], length * 4);
+            return DEVICE_OK;
+        }
+
+        virtual int write(uint32_t address, uint32_t* data, uint32_t length) override
+        {
+            for (uint32_t i = 0; i < length * 4; i++)
+                memory[address + i] &= ((uint8_t *) data)[i];
+
+            return DEVICE_OK;
+        }
+
+        virtual int erase(uint32_t page) override
+        {
+            memset(&memory[page - page % getPageSize()], 0xFF, getPageSize());
+            return DEVICE_OK;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,50 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host build replacement for codal-core's NVMController.h.
+  */
+
+#ifndef NVM_CONTROLLER_H
+#define NVM_CONTROLLER_H
+
+#include <stdint.h>
+
+namespace codal
+{
+    class NVMController
+    {
+        public:
+        virtual uint32_t getFlashStart() = 0;
+        virtual uint32_t getFlashEnd() = 0;
+        virtual uint32_t getPageSize() = 0;
+        virtual int read(uint32_t* dest, uint32_t address, uint32_t length) = 0;
+        virtual int write(uint32_t address, uint32_t* data, uint32_t length) = 0;
+        virtual int erase(uint32_t page) = 0;
+        virtual ~NVMController() {}
+    };
+}
+
+#endif
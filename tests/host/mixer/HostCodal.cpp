@@ -0,0 +1,49 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host implementations of the codal-core functions the audio mixer depends upon.
+  */
+
+#include "StreamNormalizer.h"
+
+using namespace codal;
+
+static int readSample8u(uint8_t *p) { return *p; }
+static int readSample8s(uint8_t *p) { return (int8_t) *p; }
+static int readSample16u(uint8_t *p) { return *(uint16_t *)p; }
+static int readSample16s(uint8_t *p) { return *(int16_t *)p; }
+
+static void writeSample8u(uint8_t *p, int v) { *p = (uint8_t) v; }
+static void writeSample8s(uint8_t *p, int v) { *(int8_t *)p = (int8_t) v; }
+static void writeSample16u(uint8_t *p, int v) { *(uint16_t *)p = (uint16_t) v; }
+static void writeSample16s(uint8_t *p, int v) { *(int16_t *)p = (int16_t) v; }
+
+SampleReadFn StreamNormalizer::readSample[9] = {NULL, readSample8u, readSample8s, readSample16u, readSample16s, NULL, NULL, NULL, NULL};
+SampleWriteFn StreamNormalizer::writeSample[9] = {NULL, writeSample8u, writeSample8s, writeSample16u, writeSample16s, NULL, NULL, NULL, NULL};
+
+Event::Event(uint16_t source, uint16_t value)
+{
+}
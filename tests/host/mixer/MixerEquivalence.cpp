@@ -0,0 +1,324 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host equivalence test and benchmark of the Mixer2 mixing kernels.
+  *
+  * Two Mixer2 instances are fed identical input streams, one using the floating point reference kernel and the other
+  * the fixed point kernel, and their output compared sample by sample. Each case covers a combination of input formats,
+  * channel sample rates, channel and master volumes and output formats, and fails if any output sample differs by more
+  * than MAX_ERROR quantization levels. Output ranges finer than the resolution of the fixed point accumulator are allowed
+  * a further level of error for each accumulator step they span.
+  *
+  * The reference kernel always resamples by nearest neighbour, so the fixed point kernel is compared using
+  * MIXER_RESAMPLE_NEAREST. Channel rates are chosen so that the resampling step is exactly representable by both.
+  *
+  * The time taken by each kernel to produce an output buffer is also reported. This is measured on the host with the
+  * portable C kernels, so is only meaningful relative to each other; on the device, use CONFIG_MIXER_CYCLE_COUNT and
+  * Mixer2::getPullCycles().
+  */
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "Mixer2.h"
+
+using namespace codal;
+
+// The largest difference permitted between the output of the two kernels, in output quantization levels.
+#define MAX_ERROR           1
+
+// The number of output buffers compared in each case, and generated by each kernel when benchmarking.
+#define TEST_BUFFERS        32
+#define BENCHMARK_BUFFERS   20000
+
+// The number of samples in each buffer generated by a TestTone, and the number of buffers it cycles through.
+#define TONE_SAMPLES        256
+#define TONE_BUFFERS        8
+
+/**
+ * A DataSource providing a deterministic two tone signal in any 8 or 16 bit format.
+ * The signal is generated up front, so that benchmarks measure only the mixer.
+ */
+class TestTone : public DataSource
+{
+    ManagedBuffer   buffers[TONE_BUFFERS];
+    int             format;
+    float           rate;
+    int             next;
+
+    public:
+    TestTone(int format, float rate, float frequency, float amplitude) : format(format), rate(rate), next(0)
+    {
+        for (int i = 0; i < TONE_BUFFERS; i++)
+            buffers[i] = generate(i * TONE_SAMPLES, frequency, amplitude);
+    }
+
+    ManagedBuffer generate(uint32_t t, float frequency, float amplitude)
+    {
+        ManagedBuffer b(TONE_SAMPLES * DATASTREAM_FORMAT_BYTES_PER_SAMPLE(format));
+
+        for (int i = 0; i < TONE_SAMPLES; i++, t++)
+        {
+            double x = 2.0 * M_PI * t / rate;
+            double s = amplitude * (0.8 * sin(frequency * x) + 0.2 * sin(7.1 * frequency * x));
+
+            switch (format)
+            {
+                case DATASTREAM_FORMAT_8BIT_UNSIGNED:
+                    b[i] = (uint8_t) lround(128 + 127 * s);
+                    break;
+
+                case DATASTREAM_FORMAT_8BIT_SIGNED:
+                    b[i] = (uint8_t)(int8_t) lround(127 * s);
+                    break;
+
+                case DATASTREAM_FORMAT_16BIT_UNSIGNED:
+                    ((uint16_t *)&b[0])[i] = (uint16_t) lround(32768 + 32767 * s);
+                    break;
+
+                case DATASTREAM_FORMAT_16BIT_SIGNED:
+                    ((int16_t *)&b[0])[i] = (int16_t) lround(32767 * s);
+                    break;
+            }
+        }
+
+        return b;
+    }
+
+    virtual ManagedBuffer pull()
+    {
+        ManagedBuffer b = buffers[next];
+        next = (next + 1) % TONE_BUFFERS;
+
+        return b;
+    }
+
+    virtual int getFormat() { return format; }
+    virtual float getSampleRate() { return rate; }
+};
+
+/**
+ * A DataSink that accepts every buffer offered to it.
+ */
+class TestSink : public DataSink
+{
+    public:
+    virtual int pullRequest() { return DEVICE_OK; }
+};
+
+struct ChannelConfig
+{
+    int         format;
+    float       rate;
+    float       frequency;
+    float       amplitude;
+    float       volume;
+};
+
+struct TestCase
+{
+    const char      *name;
+    int             outputFormat;
+    int             outputRange;
+    int             masterVolume;
+    int             channelCount;
+    ChannelConfig   channels[3];
+};
+
+static const TestCase cases[] = {
+    { "8 bit unsigned",             DATASTREAM_FORMAT_16BIT_UNSIGNED, 1023, 1023, 1, { { DATASTREAM_FORMAT_8BIT_UNSIGNED,  44100, 440, 1.0f, 1.0f } } },
+    { "8 bit signed",               DATASTREAM_FORMAT_16BIT_UNSIGNED, 1023, 1023, 1, { { DATASTREAM_FORMAT_8BIT_SIGNED,    44100, 440, 1.0f, 1.0f } } },
+    { "16 bit unsigned",            DATASTREAM_FORMAT_16BIT_UNSIGNED, 1023, 1023, 1, { { DATASTREAM_FORMAT_16BIT_UNSIGNED, 44100, 440, 1.0f, 1.0f } } },
+    { "16 bit signed",              DATASTREAM_FORMAT_16BIT_UNSIGNED, 1023, 1023, 1, { { DATASTREAM_FORMAT_16BIT_SIGNED,   44100, 440, 1.0f, 1.0f } } },
+    { "16 bit signed, 22050Hz",     DATASTREAM_FORMAT_16BIT_UNSIGNED, 1023, 1023, 1, { { DATASTREAM_FORMAT_16BIT_SIGNED,   22050, 440, 1.0f, 1.0f } } },
+    { "8 bit unsigned, 11025Hz",    DATASTREAM_FORMAT_16BIT_UNSIGNED, 1023, 1023, 1, { { DATASTREAM_FORMAT_8BIT_UNSIGNED,  11025, 440, 1.0f, 1.0f } } },
+    { "16 bit signed, 88200Hz",     DATASTREAM_FORMAT_16BIT_UNSIGNED, 1023, 1023, 1, { { DATASTREAM_FORMAT_16BIT_SIGNED,   88200, 440, 1.0f, 1.0f } } },
+    { "channel and master volume",  DATASTREAM_FORMAT_16BIT_UNSIGNED, 1023,  300, 1, { { DATASTREAM_FORMAT_16BIT_SIGNED,   44100, 440, 1.0f, 0.37f } } },
+    { "16 bit signed output",       DATASTREAM_FORMAT_16BIT_SIGNED,  65535, 1023, 1, { { DATASTREAM_FORMAT_16BIT_SIGNED,   44100, 440, 1.0f, 1.0f } } },
+    { "8 bit unsigned output",      DATASTREAM_FORMAT_8BIT_UNSIGNED,   255, 1023, 1, { { DATASTREAM_FORMAT_16BIT_UNSIGNED, 44100, 440, 1.0f, 1.0f } } },
+    { "three channels",             DATASTREAM_FORMAT_16BIT_UNSIGNED, 1023, 1023, 3, {
+                                        { DATASTREAM_FORMAT_8BIT_UNSIGNED,  44100, 262, 0.5f, 0.6f },
+                                        { DATASTREAM_FORMAT_16BIT_SIGNED,   22050, 330, 0.5f, 0.3f },
+                                        { DATASTREAM_FORMAT_16BIT_UNSIGNED, 44100, 392, 0.5f, 0.5f } } },
+    { "three channels, clipping",   DATASTREAM_FORMAT_16BIT_UNSIGNED, 1023, 1023, 3, {
+                                        { DATASTREAM_FORMAT_8BIT_SIGNED,    44100, 262, 1.0f, 1.0f },
+                                        { DATASTREAM_FORMAT_16BIT_SIGNED,   11025, 330, 1.0f, 1.0f },
+                                        { DATASTREAM_FORMAT_16BIT_UNSIGNED, 44100, 392, 1.0f, 1.0f } } },
+};
+
+/**
+ * A Mixer2 fed by the channels of a TestCase, using the requested kernel.
+ */
+class TestMixer
+{
+    TestTone        *tones[3];
+    MixerChannel    *channels[3];
+    int             channelCount;
+    Mixer2          *mixer;
+    TestSink        sink;
+
+    public:
+    TestMixer(const TestCase &c, bool fixedPoint) : channelCount(c.channelCount)
+    {
+        mixer = new Mixer2(44100, c.outputRange, c.outputFormat);
+        mixer->connect(sink);
+        mixer->setVolume(c.masterVolume);
+        mixer->setFixedPoint(fixedPoint);
+
+        for (int i = 0; i < channelCount; i++)
+        {
+            const ChannelConfig &cc = c.channels[i];
+            int range = DATASTREAM_FORMAT_BYTES_PER_SAMPLE(cc.format) == 1 ? 255 : 65535;
+
+            tones[i] = new TestTone(cc.format, cc.rate, cc.frequency, cc.amplitude);
+            channels[i] = mixer->addChannel(*tones[i], cc.rate, range);
+            channels[i]->setVolume(cc.volume);
+            channels[i]->setResampleQuality(MIXER_RESAMPLE_NEAREST);
+        }
+    }
+
+    ~TestMixer()
+    {
+        // The mixer disconnects from its inputs when destroyed, so must go first.
+        delete mixer;
+
+        for (int i = 0; i < channelCount; i++)
+            delete tones[i];
+    }
+
+    ManagedBuffer pull()
+    {
+        // Each TestTone always has another buffer ready.
+        for (int i = 0; i < channelCount; i++)
+            channels[i]->pullRequest();
+
+        return mixer->pull();
+    }
+};
+
+static int readOutputSample(int format, ManagedBuffer &b, int i)
+{
+    switch (format)
+    {
+        case DATASTREAM_FORMAT_8BIT_UNSIGNED:
+            return b[i];
+
+        case DATASTREAM_FORMAT_8BIT_SIGNED:
+            return (int8_t) b[i];
+
+        case DATASTREAM_FORMAT_16BIT_UNSIGNED:
+            return ((uint16_t *)&b[0])[i];
+
+        case DATASTREAM_FORMAT_16BIT_SIGNED:
+            return ((int16_t *)&b[0])[i];
+    }
+
+    return 0;
+}
+
+/**
+ * Determine the largest difference permitted between the output of the two kernels for the given case.
+ */
+static int tolerance(const TestCase &c)
+{
+    return MAX_ERROR + c.outputRange / (CONFIG_MIXER_INTERNAL_RANGE << MIXER_FIXED_FRACTION_BITS);
+}
+
+/**
+ * Compare the output of the two kernels for the given case.
+ * @return the largest difference between any pair of output samples.
+ */
+static int compare(const TestCase &c)
+{
+    TestMixer reference(c, false);
+    TestMixer fixed(c, true);
+    int maxError = 0;
+
+    for (int n = 0; n < TEST_BUFFERS; n++)
+    {
+        ManagedBuffer a = reference.pull();
+        ManagedBuffer b = fixed.pull();
+        int samples = a.length() / DATASTREAM_FORMAT_BYTES_PER_SAMPLE(c.outputFormat);
+
+        if (a.length() != b.length())
+            return 0x7FFFFFFF;
+
+        for (int i = 0; i < samples; i++)
+        {
+            int e = abs(readOutputSample(c.outputFormat, a, i) - readOutputSample(c.outputFormat, b, i));
+
+            if (e > maxError)
+                maxError = e;
+        }
+    }
+
+    return maxError;
+}
+
+static double now()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+/**
+ * Determine the mean time taken by the given kernel to produce an output buffer for the given case.
+ * @return the time per output buffer, in microseconds.
+ */
+static double benchmark(const TestCase &c, bool fixedPoint)
+{
+    TestMixer m(c, fixedPoint);
+    double start = now();
+
+    for (int n = 0; n < BENCHMARK_BUFFERS; n++)
+        m.pull();
+
+    return (now() - start) * 1e6 / BENCHMARK_BUFFERS;
+}
+
+int main()
+{
+    int failures = 0;
+
+    printf("%-28s %10s %10s %14s %14s\n", "case", "max error", "tolerance", "float (us)", "fixed (us)");
+
+    for (unsigned int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        int e = compare(cases[i]);
+        bool pass = e <= tolerance(cases[i]);
+
+        printf("%-28s %10d %10d %14.2f %14.2f %s\n", cases[i].name, e, tolerance(cases[i]), benchmark(cases[i], false), benchmark(cases[i], true), pass ? "" : "FAIL");
+
+        if (!pass)
+            failures++;
+    }
+
+    printf("%d of %d cases failed\n", failures, (int)(sizeof(cases) / sizeof(cases[0])));
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host implementations of the codal-core and MicroBitDevice functions the radio stack depends upon.
+  */
+
+#include "MicroBitDevice.h"
+#include "CodalFiber.h"
+#include "Timer.h"
+#include "codal-core/inc/types/Event.h"
+
+using namespace codal;
+
+EventModel* EventModel::defaultEventBus = NULL;
+
+Event::Event(uint16_t source, uint16_t value, EventLaunchMode mode)
+{
+    this->source = source;
+    this->value = value;
+    this->timestamp = system_timer_current_time_us();
+
+    if (mode == CREATE_AND_FIRE)
+        fire();
+}
+
+Event::Event()
+{
+    this->source = 0;
+    this->value = 0;
+    this->timestamp = system_timer_current_time_us();
+}
+
+void Event::fire()
+{
+    if (EventModel::defaultEventBus)
+        EventModel::defaultEventBus->send(*this);
+}
+
+void codal::fiber_sleep(unsigned long t)
+{
+    system_timer_wait_us(t * 1000);
+}
+
+bool codal::ble_running()
+{
+    return false;
+}
+
+uint32_t codal::microbit_serial_number()
+{
+    return 0x12345678;
+}
+
+int codal::microbit_random(int max)
+{
+    return max > 0 ? rand() % max : 0;
+}
@@ -0,0 +1,245 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host benchmark of the MicroBitRadio stack.
+  *
+  * MicroBitRadio, MicroBitRadioDatagram and MicroBitRadioEvent are built natively against a simulated RADIO
+  * peripheral. For each datagram payload size up to MICROBIT_RADIO_MAX_PACKET_SIZE this reports:
+  *
+  * - The end to end latency from MicroBitRadioDatagram::send() being called to the MICROBIT_RADIO_EVT_DATAGRAM
+  *   event being handled by the application, with the frame looped back from the transmitter into the receiver.
+  *   The modelled on air time of the frame is reported alongside, as the host does not wait for it.
+  * - The packets/sec delivered to the application, the time spent in RADIO_IRQHandler, the receive queue high
+  *   water mark and the packets lost (rxOverruns and rxDropped) when bursts of frames arrive between idle callbacks.
+  * - The time from the ISR queuing each frame to its dispatch, as measured by MICROBIT_RADIO_INSTRUMENTATION.
+  *
+  * All times are measured on the host, so are only meaningful relative to each other.
+  */
+
+#include <stdio.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <time.h>
+#include "MicroBitRadio.h"
+#include "SimulatedRadio.h"
+
+using namespace codal;
+
+#define BENCHMARK_LATENCY_ITERATIONS    5000
+#define BENCHMARK_BURST_ROUNDS          2000
+#define BENCHMARK_STACK_SIZE            (256 * 1024)
+
+static MicroBitRadio *radio;
+static SimulatedRadio *simulator;
+
+static uint64_t sendTime;                   // Host time at which the datagram being timed was sent, or zero.
+static uint64_t latencyTotal;
+static uint64_t latencyMax;
+static uint32_t latencyCount;
+static uint32_t delivered;                  // Number of datagrams received by the application.
+static uint8_t  rxData[MICROBIT_RADIO_MAX_PACKET_SIZE];
+
+static uint8_t benchmarkStack[BENCHMARK_STACK_SIZE] __attribute__((aligned(16)));
+
+static uint64_t host_time_ns()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (uint64_t)t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+/**
+  * The application's MICROBIT_RADIO_EVT_DATAGRAM handler.
+  */
+static void onDatagram(Event)
+{
+    if (radio->datagram.recv(rxData, sizeof(rxData)) < 0)
+        return;
+
+    delivered++;
+
+    if (sendTime)
+    {
+        uint64_t latency = host_time_ns() - sendTime;
+
+        latencyTotal += latency;
+        latencyCount++;
+        if (latency > latencyMax)
+            latencyMax = latency;
+
+        sendTime = 0;
+    }
+}
+
+static void reset()
+{
+    radio->resetStatistics();
+    simulator->resetStatistics();
+
+    latencyTotal = 0;
+    latencyMax = 0;
+    latencyCount = 0;
+    delivered = 0;
+}
+
+/**
+  * Sends datagrams of the given size, looping each back into the receiver, and times their arrival at the application.
+  */
+static void benchmarkLatency(int size)
+{
+    uint8_t payload[MICROBIT_RADIO_MAX_PACKET_SIZE];
+    SimulatedRadio::Frame frame;
+
+    reset();
+
+    for (int i = 0; i < BENCHMARK_LATENCY_ITERATIONS; i++)
+    {
+        memset(payload, i, size);
+
+        sendTime = host_time_ns();
+        radio->datagram.send(payload, size);
+
+        if (simulator->transmitted(frame))
+            simulator->receive(frame.data);
+
+        // Stands in for the scheduler running the idle thread.
+        radio->idleCallback();
+    }
+
+    printf("%7d %8u %9.2f %9.2f %9.0f %9.0f %8u\n", size, simulator->airTime(size + MICROBIT_RADIO_HEADER_SIZE - 1),
+        latencyCount ? latencyTotal / 1000.0 / latencyCount : 0.0, latencyMax / 1000.0,
+        simulator->isrCount ? (double)simulator->isrTimeTotal / simulator->isrCount : 0.0, (double)simulator->isrTimeMax,
+        BENCHMARK_LATENCY_ITERATIONS - latencyCount);
+}
+
+/**
+  * Delivers bursts of datagrams of the given size to the receiver, running the idle callback only between bursts.
+  */
+static void benchmarkBurst(int size, int burst)
+{
+    uint8_t frame[MICROBIT_RADIO_MAX_PACKET_SIZE + MICROBIT_RADIO_HEADER_SIZE] = {0};
+
+    frame[0] = size + MICROBIT_RADIO_HEADER_SIZE - 1;
+    frame[1] = 1;
+    frame[2] = 0;
+    frame[3] = MICROBIT_RADIO_PROTOCOL_DATAGRAM;
+
+    reset();
+
+    uint64_t start = host_time_ns();
+
+    for (int i = 0; i < BENCHMARK_BURST_ROUNDS; i++)
+    {
+        for (int b = 0; b < burst; b++)
+            simulator->receive(frame);
+
+        radio->idleCallback();
+    }
+
+    double elapsed = (host_time_ns() - start) / 1e9;
+    MicroBitRadioStatistics &stats = radio->stats;
+
+    printf("%7d %6d %12.0f %9.0f %9.0f %5u %9u %8u %10.2f\n", size, burst, delivered / elapsed,
+        simulator->isrCount ? (double)simulator->isrTimeTotal / simulator->isrCount : 0.0, (double)simulator->isrTimeMax,
+        stats.rxHighWaterMark, stats.rxOverruns, stats.rxDropped,
+        stats.latencyCount ? (double)stats.latencyTotal / stats.latencyCount : 0.0);
+}
+
+static void *benchmark(void *)
+{
+    int marker;
+
+    if ((uintptr_t)&marker > 0xFFFFFFFF || (uintptr_t)radio > 0xFFFFFFFF)
+    {
+        fprintf(stderr, "benchmark memory is not addressable by the 32 bit RADIO PACKETPTR register\n");
+        exit(1);
+    }
+
+    int sizes[16];
+    int sizeCount = 0;
+
+    // The largest payload whose frame fits within MICROBIT_RADIO_MAX_PACKET_SIZE, as set in the RADIO's MAXLEN,
+    // is also measured, as larger frames are truncated by the RADIO and so lost.
+    int largest = MICROBIT_RADIO_MAX_PACKET_SIZE - (MICROBIT_RADIO_HEADER_SIZE - 1);
+
+    for (int size = 1; size < largest; size *= 2)
+        sizes[sizeCount++] = size;
+
+    sizes[sizeCount++] = largest;
+    sizes[sizeCount++] = MICROBIT_RADIO_MAX_PACKET_SIZE;
+
+    printf("MICROBIT_RADIO_MAX_PACKET_SIZE %d, MICROBIT_RADIO_RX_BUFFERS %d, MICROBIT_RADIO_MAXIMUM_RX_BUFFERS %d\n\n",
+        MICROBIT_RADIO_MAX_PACKET_SIZE, MICROBIT_RADIO_RX_BUFFERS, MICROBIT_RADIO_MAXIMUM_RX_BUFFERS);
+
+    printf("send() to MICROBIT_RADIO_EVT_DATAGRAM latency (%d datagrams each)\n", BENCHMARK_LATENCY_ITERATIONS);
+    printf("payload  air(us) avg(us)   max(us)   isr(ns) isrmax(ns)    lost\n");
+
+    for (int i = 0; i < sizeCount; i++)
+        benchmarkLatency(sizes[i]);
+
+    int bursts[] = {1, MICROBIT_RADIO_RX_BUFFERS / 2, MICROBIT_RADIO_RX_BUFFERS - 1, MICROBIT_RADIO_RX_BUFFERS, 2 * MICROBIT_RADIO_RX_BUFFERS};
+
+    printf("\nReceive bursts between idle callbacks (%d bursts each)\n", BENCHMARK_BURST_ROUNDS);
+    printf("payload  burst  packets/sec   isr(ns) isrmax(ns)  hwm  overruns  dropped  queue(us)\n");
+
+    for (int i = 0; i < sizeCount; i++)
+        for (unsigned b = 0; b < sizeof(bursts) / sizeof(bursts[0]); b++)
+            benchmarkBurst(sizes[i], bursts[b]);
+
+    return NULL;
+}
+
+int main()
+{
+    // The RADIO holds 32 bit buffer addresses. The benchmark is linked without PIE so that the heap and static
+    // data lie below 4GB, and is run on a statically allocated stack with all allocations from the main arena.
+    mallopt(M_ARENA_MAX, 1);
+
+    EventModel bus;
+    EventModel::defaultEventBus = &bus;
+
+    simulator = new SimulatedRadio();
+    radio = new MicroBitRadio();
+
+    bus.listen(DEVICE_ID_RADIO, MICROBIT_RADIO_EVT_DATAGRAM, onDatagram);
+
+    if (radio->enable() != DEVICE_OK)
+    {
+        fprintf(stderr, "radio failed to start\n");
+        return 1;
+    }
+
+    pthread_t thread;
+    pthread_attr_t attr;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, benchmarkStack, sizeof(benchmarkStack));
+    pthread_create(&thread, &attr, benchmark, NULL);
+    pthread_join(thread, NULL);
+
+    return 0;
+}
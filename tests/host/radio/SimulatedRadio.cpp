@@ -0,0 +1,248 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "SimulatedRadio.h"
+#include <time.h>
+#include <string.h>
+
+extern "C" void RADIO_IRQHandler(void);
+
+static NRF_RADIO_Type radioRegisters;
+static NRF_CLOCK_Type clockRegisters;
+
+NRF_RADIO_Type *NRF_RADIO = &radioRegisters;
+NRF_CLOCK_Type *NRF_CLOCK = &clockRegisters;
+
+SimulatedRadio *SimulatedRadio::instance = NULL;
+
+static uint64_t host_time_ns()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (uint64_t)t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+/**
+  * The RADIO only holds a 32 bit address for its DMA buffer. The benchmark is linked and run such that all
+  * of its memory is below 4GB, so this may be used directly as a host pointer.
+  */
+static uint8_t *packet_pointer()
+{
+    return (uint8_t *)(uintptr_t)NRF_RADIO->PACKETPTR;
+}
+
+SimulatedRadio::SimulatedRadio()
+{
+    state = DISABLED;
+    irqEnabled = false;
+    irqPending = false;
+    noiseFloor = 100;
+    txCount = 0;
+
+    resetStatistics();
+
+    instance = this;
+}
+
+void SimulatedRadio::resetStatistics()
+{
+    framesMissed = 0;
+    isrCount = 0;
+    isrTimeTotal = 0;
+    isrTimeMax = 0;
+}
+
+void SimulatedRadio::raiseInterrupt()
+{
+    irqPending = false;
+
+    uint64_t start = host_time_ns();
+    RADIO_IRQHandler();
+    uint64_t elapsed = host_time_ns() - start;
+
+    isrCount++;
+    isrTimeTotal += elapsed;
+    if (elapsed > isrTimeMax)
+        isrTimeMax = elapsed;
+}
+
+bool SimulatedRadio::receive(const uint8_t *frame, bool crcOk, int rssi)
+{
+    if (state != RX)
+    {
+        framesMissed++;
+        return false;
+    }
+
+    // The RADIO truncates frames longer than MAXLEN, and flags them as having failed their CRC check.
+    int maxLength = NRF_RADIO->PCNF1 & 0xFF;
+    int length = frame[0];
+
+    if (length > maxLength)
+    {
+        length = maxLength;
+        crcOk = false;
+    }
+
+    uint8_t *dma = packet_pointer();
+    dma[0] = frame[0];
+    memcpy(dma + 1, frame + 1, length);
+
+    NRF_RADIO->RXMATCH = 0;
+    NRF_RADIO->RSSISAMPLE = rssi;
+    NRF_RADIO->CRCSTATUS = crcOk ? 1 : 0;
+    NRF_RADIO->EVENTS_END = 1;
+    state = RX_IDLE;
+
+    if (irqEnabled)
+        raiseInterrupt();
+    else
+        irqPending = true;
+
+    return true;
+}
+
+bool SimulatedRadio::transmitted(Frame &frame)
+{
+    if (txCount == 0)
+        return false;
+
+    frame = txQueue[0];
+    txCount--;
+    memmove(&txQueue[0], &txQueue[1], txCount * sizeof(Frame));
+
+    return true;
+}
+
+uint32_t SimulatedRadio::airTime(int length)
+{
+    // Preamble, 5 byte address, 8 bit length field, payload and CRC.
+    int preamble = ((NRF_RADIO->PCNF0 >> RADIO_PCNF0_PLEN_Pos) & 0x03) == RADIO_PCNF0_PLEN_16bit ? 2 : 1;
+    int bits = (preamble + 5 + 1 + length + (NRF_RADIO->CRCCNF & 0x03)) * 8;
+    int mbps = (NRF_RADIO->MODE == RADIO_MODE_MODE_Nrf_2Mbit || NRF_RADIO->MODE == RADIO_MODE_MODE_Ble_2Mbit) ? 2 : 1;
+
+    return SIMULATED_RADIO_TX_RAMP_UP + bits / mbps;
+}
+
+void SimulatedRadio::task(SimulatedTask t)
+{
+    switch (t)
+    {
+        case SIM_TASK_TXEN:
+            state = TX_IDLE;
+            NRF_RADIO->EVENTS_READY = 1;
+            break;
+
+        case SIM_TASK_RXEN:
+            state = RX_IDLE;
+            NRF_RADIO->EVENTS_READY = 1;
+            break;
+
+        case SIM_TASK_START:
+            if (state == RX_IDLE)
+            {
+                state = RX;
+            }
+            else if (state == TX_IDLE)
+            {
+                // The frame is taken from memory now, but the END event is only raised once software next looks for it.
+                uint8_t *dma = packet_pointer();
+                int maxLength = NRF_RADIO->PCNF1 & 0xFF;
+                int length = dma[0] > maxLength ? maxLength : dma[0];
+
+                if (txCount < SIMULATED_RADIO_TX_QUEUE)
+                {
+                    txQueue[txCount].length = length + 1;
+                    memcpy(txQueue[txCount].data, dma, length + 1);
+                    txCount++;
+                }
+
+                state = TX;
+            }
+            break;
+
+        case SIM_TASK_DISABLE:
+            state = DISABLED;
+            NRF_RADIO->EVENTS_DISABLED = 1;
+            break;
+
+        case SIM_TASK_RSSISTART:
+            NRF_RADIO->RSSISAMPLE = noiseFloor;
+            NRF_RADIO->EVENTS_RSSIEND = 1;
+            break;
+
+        case SIM_TASK_HFCLKSTART:
+            NRF_CLOCK->EVENTS_HFCLKSTARTED = 1;
+            break;
+    }
+}
+
+void SimulatedRadio::poll()
+{
+    if (state == TX)
+    {
+        state = TX_IDLE;
+        NRF_RADIO->EVENTS_END = 1;
+        irqPending = true;
+    }
+}
+
+void simulated_event_poll()
+{
+    if (SimulatedRadio::instance)
+        SimulatedRadio::instance->poll();
+}
+
+void simulated_task(SimulatedTask t)
+{
+    if (SimulatedRadio::instance)
+        SimulatedRadio::instance->task(t);
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+    SimulatedRadio *radio = SimulatedRadio::instance;
+
+    radio->irqEnabled = true;
+
+    if (radio->irqPending)
+        radio->raiseInterrupt();
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq)
+{
+    SimulatedRadio::instance->irqEnabled = false;
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+    SimulatedRadio::instance->irqPending = false;
+}
+
+uint32_t NVIC_GetEnableIRQ(IRQn_Type irq)
+{
+    return SimulatedRadio::instance->irqEnabled ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef SIMULATED_RADIO_H
+#define SIMULATED_RADIO_H
+
+#include <stdint.h>
+#include "nrf.h"
+
+#define SIMULATED_RADIO_MAX_FRAME       256
+#define SIMULATED_RADIO_TX_QUEUE        4
+
+// Time taken by the RADIO to ramp up its transmitter in the default (non fast ramp up) mode, in microseconds.
+#define SIMULATED_RADIO_TX_RAMP_UP      130
+
+/**
+  * A simulation of the nRF52 RADIO peripheral, driven through the task and event registers declared in
+  * the host nrf.h, together with an injector that delivers frames to the receiver and raises RADIO_IRQn.
+  *
+  * Frames transmitted by the code under test are captured rather than sent, so that they can be inspected
+  * or looped back into the receiver. There is no preemption on the host: interrupts are raised only
+  * when a frame is injected, or when a pending interrupt is enabled.
+  */
+class SimulatedRadio
+{
+    public:
+
+    enum State
+    {
+        DISABLED,
+        RX_IDLE,
+        RX,
+        TX_IDLE,
+    TX
+    };
+
+    struct Frame
+    {
+        int         length;                                 // Number of bytes in data, including the length field.
+        uint8_t     data[SIMULATED_RADIO_MAX_FRAME];        // The frame as it appears on air: an 8 bit length field followed by its payload.
+    };
+
+    State       state;
+    bool        irqEnabled;
+    bool        irqPending;
+    int         noiseFloor;                                 // The RSSISAMPLE value returned whilst the channel is quiet (-dBm).
+
+    Frame       txQueue[SIMULATED_RADIO_TX_QUEUE];
+    int         txCount;
+
+    uint32_t    framesMissed;                               // Frames injected whilst the receiver was not listening.
+    uint32_t    isrCount;                                   // Number of times RADIO_IRQHandler was invoked.
+    uint64_t    isrTimeTotal;                               // Total host time spent in RADIO_IRQHandler, in nanoseconds.
+    uint64_t    isrTimeMax;                                 // Longest host time spent in a single call of RADIO_IRQHandler, in nanoseconds.
+
+    static SimulatedRadio *instance;
+
+    SimulatedRadio();
+
+    /**
+      * Clears the interrupt and frame counters.
+      */
+    void resetStatistics();
+
+    /**
+      * Delivers a frame to the receiver as though it had just been received from the air, and raises RADIO_IRQn.
+      *
+      * @param frame The frame, starting with its 8 bit length field.
+      *
+      * @param crcOk false to simulate a frame received with a CRC error.
+      *
+      * @param rssi The signal strength of the frame, in -dBm.
+      *
+      * @return true if the receiver was listening, or false if the frame was missed.
+      */
+    bool receive(const uint8_t *frame, bool crcOk = true, int rssi = 60);
+
+    /**
+      * Removes the oldest frame captured from the transmitter.
+      *
+      * @param frame Set to the frame transmitted.
+      *
+      * @return true on success, or false if nothing has been transmitted.
+      */
+    bool transmitted(Frame &frame);
+
+    /**
+      * Calculates the time the given frame would spend on air, including the transmitter ramp up,
+      * using the mode and packet format currently configured in the RADIO registers.
+      *
+      * @param length The value of the frame's length field.
+      *
+      * @return The time taken to transmit the frame, in microseconds.
+      */
+    uint32_t airTime(int length);
+
+    /**
+      * Performs a task written to one of the RADIO or CLOCK task registers.
+      */
+    void task(SimulatedTask t);
+
+    /**
+      * Completes any transmission in progress. Called whenever software reads an event register.
+      */
+    void poll();
+
+    /**
+      * Invokes RADIO_IRQHandler, recording the host time spent in it.
+      */
+    void raiseInterrupt();
+};
+
+#endif
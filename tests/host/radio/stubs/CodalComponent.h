@@ -0,0 +1,58 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host build replacement for codal-core's CodalComponent.h.
+  */
+
+#ifndef CODAL_COMPONENT_H
+#define CODAL_COMPONENT_H
+
+#include "CodalConfig.h"
+
+#define DEVICE_ID_ANY                       0
+#define DEVICE_ID_RADIO                     9
+#define DEVICE_ID_RADIO_DATA_READY          10
+
+#define DEVICE_COMPONENT_STATUS_SYSTEM_TICK 0x01
+#define DEVICE_COMPONENT_STATUS_IDLE_TICK   0x02
+
+namespace codal
+{
+    class CodalComponent
+    {
+        protected:
+        uint16_t id;
+        uint16_t status;
+
+        public:
+        virtual void periodicCallback() {}
+        virtual void idleCallback() {}
+        virtual int setSleep(bool doSleep) { return 0; }
+        virtual ~CodalComponent() {}
+    };
+}
+
+#endif
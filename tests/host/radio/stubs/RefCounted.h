@@ -0,0 +1,56 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host build replacement for codal-core's RefCounted.h. As on the device, the count is held in steps of two,
+  * so a single reference is represented by a count of 3 and the object is freed once the count returns to 1.
+  */
+
+#ifndef REF_COUNTED_H
+#define REF_COUNTED_H
+
+#include "CodalConfig.h"
+
+namespace codal
+{
+    struct RefCounted
+    {
+        uint16_t refCount;
+        uint16_t tag;
+
+        void init() { refCount = 3; }
+        void incr() { refCount += 2; }
+
+        void decr()
+        {
+            refCount -= 2;
+
+            if (refCount == 1)
+                free(this);
+        }
+    };
+}
+
+#endif
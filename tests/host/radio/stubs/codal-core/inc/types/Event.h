@@ -0,0 +1,153 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host build replacement for codal-core's Event.h and EventModel.h.
+  *
+  * Events are delivered synchronously to their listeners as soon as they are fired, as though every
+  * listener were registered with MESSAGE_BUS_LISTENER_IMMEDIATE.
+  */
+
+#ifndef CODAL_EVENT_H
+#define CODAL_EVENT_H
+
+#include "CodalConfig.h"
+#include "ErrorNo.h"
+#include "CodalComponent.h"
+
+#define DEVICE_EVT_ANY                      0
+#define MESSAGE_BUS_LISTENER_IMMEDIATE      0x0080
+
+namespace codal
+{
+    enum EventLaunchMode
+    {
+        CREATE_ONLY,
+        CREATE_AND_FIRE
+    };
+
+    class Event
+    {
+        public:
+        uint16_t        source;
+        uint16_t        value;
+        CODAL_TIMESTAMP timestamp;
+
+        Event(uint16_t source, uint16_t value, EventLaunchMode mode = CREATE_AND_FIRE);
+        Event();
+
+        void fire();
+    };
+
+    struct EventListener
+    {
+        uint16_t        id;
+        uint16_t        value;
+        void            *object;
+        EventListener   *next;
+
+        virtual void call(Event e) = 0;
+        virtual ~EventListener() {}
+    };
+
+    template <typename T>
+    struct MemberEventListener : EventListener
+    {
+        void (T::*method)(Event);
+
+        virtual void call(Event e) { (((T *)object)->*method)(e); }
+    };
+
+    struct FunctionEventListener : EventListener
+    {
+        void (*handler)(Event);
+
+        virtual void call(Event e) { handler(e); }
+    };
+
+    class EventModel
+    {
+        EventListener   *listeners;
+
+        void add(EventListener *l, uint16_t id, uint16_t value, void *object)
+        {
+            l->id = id;
+            l->value = value;
+            l->object = object;
+            l->next = listeners;
+            listeners = l;
+        }
+
+        public:
+        static EventModel *defaultEventBus;
+
+        EventModel() : listeners(NULL) {}
+
+        template <typename T>
+        int listen(int id, int value, T *object, void (T::*method)(Event), uint16_t flags = 0)
+        {
+            MemberEventListener<T> *l = new MemberEventListener<T>();
+            l->method = method;
+            add(l, id, value, object);
+            return DEVICE_OK;
+        }
+
+        int listen(int id, int value, void (*handler)(Event), uint16_t flags = 0)
+        {
+            FunctionEventListener *l = new FunctionEventListener();
+            l->handler = handler;
+            add(l, id, value, NULL);
+            return DEVICE_OK;
+        }
+
+        template <typename T>
+        int ignore(int id, int value, T *object, void (T::*method)(Event))
+        {
+            for (EventListener **l = &listeners; *l; l = &(*l)->next)
+            {
+                if ((*l)->id == id && (*l)->value == value && (*l)->object == object)
+                {
+                    EventListener *dead = *l;
+                    *l = dead->next;
+                    delete dead;
+                    return DEVICE_OK;
+                }
+            }
+
+            return DEVICE_INVALID_PARAMETER;
+        }
+
+        int send(Event e)
+        {
+            for (EventListener *l = listeners; l; l = l->next)
+                if ((l->id == DEVICE_ID_ANY || l->id == e.source) && (l->value == DEVICE_EVT_ANY || l->value == e.value))
+                    l->call(e);
+
+            return DEVICE_OK;
+        }
+    };
+}
+
+#endif
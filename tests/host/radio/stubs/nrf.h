@@ -0,0 +1,151 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host build replacement for the nRF52 device header, describing only the RADIO and CLOCK peripherals.
+  *
+  * Configuration registers are plain memory. Writing to a task register hands control to the simulated
+  * peripheral in SimulatedRadio.cpp, which updates the event registers as the hardware would. Reading an
+  * event register also gives the peripheral the chance to complete any operation in progress, so that
+  * software polling for an event sees it occur after it has been cleared.
+  */
+
+#ifndef NRF_H
+#define NRF_H
+
+#include <stdint.h>
+
+typedef enum
+{
+    RADIO_IRQn = 1
+} IRQn_Type;
+
+enum SimulatedTask
+{
+    SIM_TASK_TXEN,
+    SIM_TASK_RXEN,
+    SIM_TASK_START,
+    SIM_TASK_DISABLE,
+    SIM_TASK_RSSISTART,
+    SIM_TASK_HFCLKSTART
+};
+
+void simulated_task(SimulatedTask task);
+
+template <SimulatedTask T>
+struct SimulatedTaskRegister
+{
+    SimulatedTaskRegister& operator=(uint32_t v)
+    {
+        if (v)
+            simulated_task(T);
+
+        return *this;
+    }
+};
+
+void simulated_event_poll();
+
+struct SimulatedEventRegister
+{
+    volatile uint32_t value;
+
+    SimulatedEventRegister& operator=(uint32_t v)
+    {
+        value = v;
+        return *this;
+    }
+
+    operator uint32_t()
+    {
+        simulated_event_poll();
+        return value;
+    }
+};
+
+typedef struct
+{
+    SimulatedTaskRegister<SIM_TASK_TXEN>        TASKS_TXEN;
+    SimulatedTaskRegister<SIM_TASK_RXEN>        TASKS_RXEN;
+    SimulatedTaskRegister<SIM_TASK_START>       TASKS_START;
+    SimulatedTaskRegister<SIM_TASK_DISABLE>     TASKS_DISABLE;
+    SimulatedTaskRegister<SIM_TASK_RSSISTART>   TASKS_RSSISTART;
+
+    SimulatedEventRegister  EVENTS_READY;
+    SimulatedEventRegister  EVENTS_END;
+    SimulatedEventRegister  EVENTS_DISABLED;
+    SimulatedEventRegister  EVENTS_RSSIEND;
+
+    volatile uint32_t   SHORTS;
+    volatile uint32_t   INTENSET;
+    volatile uint32_t   CRCSTATUS;
+    volatile uint32_t   RXMATCH;
+    volatile uint32_t   PACKETPTR;
+    volatile uint32_t   FREQUENCY;
+    volatile uint32_t   TXPOWER;
+    volatile uint32_t   MODE;
+    volatile uint32_t   PCNF0;
+    volatile uint32_t   PCNF1;
+    volatile uint32_t   BASE0;
+    volatile uint32_t   BASE1;
+    volatile uint32_t   PREFIX0;
+    volatile uint32_t   PREFIX1;
+    volatile uint32_t   TXADDRESS;
+    volatile uint32_t   RXADDRESSES;
+    volatile uint32_t   CRCCNF;
+    volatile uint32_t   CRCPOLY;
+    volatile uint32_t   CRCINIT;
+    volatile uint32_t   RSSISAMPLE;
+    volatile uint32_t   DATAWHITEIV;
+} NRF_RADIO_Type;
+
+typedef struct
+{
+    SimulatedTaskRegister<SIM_TASK_HFCLKSTART>  TASKS_HFCLKSTART;
+
+    volatile uint32_t   EVENTS_HFCLKSTARTED;
+} NRF_CLOCK_Type;
+
+extern NRF_RADIO_Type *NRF_RADIO;
+extern NRF_CLOCK_Type *NRF_CLOCK;
+
+#define RADIO_MODE_MODE_Nrf_1Mbit               0
+#define RADIO_MODE_MODE_Nrf_2Mbit               1
+#define RADIO_MODE_MODE_Ble_1Mbit               3
+#define RADIO_MODE_MODE_Ble_2Mbit               4
+
+#define RADIO_PCNF0_LFLEN_Pos                   0
+#define RADIO_PCNF0_PLEN_Pos                    24
+#define RADIO_PCNF0_PLEN_8bit                   0
+#define RADIO_PCNF0_PLEN_16bit                  1
+
+#define RADIO_SHORTS_ADDRESS_RSSISTART_Msk      (1UL << 4)
+
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+void NVIC_ClearPendingIRQ(IRQn_Type irq);
+uint32_t NVIC_GetEnableIRQ(IRQn_Type irq);
+
+#endif
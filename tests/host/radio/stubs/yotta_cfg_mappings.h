@@ -0,0 +1 @@
+// Host build replacement for yotta_cfg_mappings.h. No yotta configuration is mapped.
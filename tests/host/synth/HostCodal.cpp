@@ -0,0 +1,61 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host implementations of the codal-core TonePrint functions. Each generates a waveform of the same shape and range
+  * (0..1023 over 1024 positions) as its codal-core counterpart.
+  */
+
+#include <math.h>
+#include "Synthesizer.h"
+
+using namespace codal;
+
+uint16_t Synthesizer::SineTone(void *arg, int position)
+{
+    return (uint16_t) lround(511.5 - 511.5 * cos(2.0 * M_PI * position / 1024.0));
+}
+
+uint16_t Synthesizer::SawtoothTone(void *arg, int position)
+{
+    return position;
+}
+
+uint16_t Synthesizer::TriangleTone(void *arg, int position)
+{
+    return position < 512 ? position * 2 : (1023 - position) * 2;
+}
+
+uint16_t Synthesizer::SquareWaveTone(void *arg, int position)
+{
+    return position < 512 ? 1023 : 0;
+}
+
+uint16_t Synthesizer::NoiseTone(void *arg, int position)
+{
+    // Deterministic noise, that differs at every position.
+    uint32_t x = (uint32_t) position * 2654435761u;
+    return (x >> 13) & 1023;
+}
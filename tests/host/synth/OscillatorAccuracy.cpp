@@ -0,0 +1,210 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 Lancaster University.
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+  * Host accuracy test of the WavetableOscillator used by SoundEmojiSynthesizer.
+  *
+  * Each TonePrint is rendered by a WavetableOscillator over a range of frequencies and volumes, in blocks of varying
+  * size, and compared sample by sample against a double precision reference driven by the same phase:
+  *
+  * - TonePrints with a wavetable are compared against the TonePrint itself, linearly interpolated at its full
+  *   resolution of EMOJI_SYNTHESIZER_TONE_WIDTH positions. The oscillator deliberately smooths discontinuities
+  *   (such as the edges of a square wave) over one table entry, so samples that close to a discontinuity are
+  *   instead required to lie between the levels either side of it. These samples are counted.
+  * - Other TonePrints (such as NoiseTone) are compared against the TonePrint evaluated at every sample.
+  *
+  * The test fails if any sample differs by more than MAX_ERROR output levels.
+  */
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include "WavetableOscillator.h"
+#include "Synthesizer.h"
+
+using namespace codal;
+using std::max;
+
+// The largest difference permitted between the oscillator and the reference, in output levels.
+#define MAX_ERROR           2
+
+// The output range and sample rate used by SoundEmojiSynthesizer.
+#define SAMPLE_RANGE        1023.0f
+#define SAMPLE_RATE         44100.0f
+
+// The number of samples rendered for each combination of TonePrint, frequency and volume.
+#define TEST_SAMPLES        22050
+
+// The largest change in TonePrint value between adjacent positions that is not considered a discontinuity.
+#define DISCONTINUITY       64
+
+/**
+ * A TonePrint with no wavetable, used to test the rendering of custom TonePrints.
+ */
+static uint16_t customTone(void *arg, int position)
+{
+    return position < 256 ? position * 4 : 1023 - (position - 256) * 4 / 3;
+}
+
+struct Waveform
+{
+    const char          *name;
+    TonePrintFunction   tonePrint;
+    bool                interpolated;
+};
+
+static const Waveform waveforms[] = {
+    { "sine",       Synthesizer::SineTone,          true },
+    { "sawtooth",   Synthesizer::SawtoothTone,      true },
+    { "triangle",   Synthesizer::TriangleTone,      true },
+    { "square",     Synthesizer::SquareWaveTone,    true },
+    { "noise",      Synthesizer::NoiseTone,         false },
+    { "custom",     customTone,                     false },
+};
+
+static const float frequencies[] = { 20.0f, 131.0f, 440.0f, 1000.0f, 3520.0f, 12000.0f };
+static const float volumes[] = { 1.0f, 0.5f, 0.1f };
+
+/**
+ * Evaluate a TonePrint at a fractional position, by linear interpolation between its adjacent positions.
+ */
+static double interpolate(TonePrintFunction tonePrint, double x)
+{
+    int i = (int) x;
+    double a = tonePrint(NULL, i);
+    double b = tonePrint(NULL, (i + 1) % EMOJI_SYNTHESIZER_TONE_WIDTH);
+
+    return a + (b - a) * (x - i);
+}
+
+/**
+ * Determine if a TonePrint has a discontinuity within the given distance of a position.
+ *
+ * @param lo Set to the lowest value of the TonePrint within the given distance.
+ * @param hi Set to the highest value of the TonePrint within the given distance.
+ */
+static bool nearDiscontinuity(TonePrintFunction tonePrint, double x, int distance, int &lo, int &hi)
+{
+    bool found = false;
+
+    lo = hi = tonePrint(NULL, (int) x);
+
+    for (int i = (int) x - distance; i <= (int) x + distance; i++)
+    {
+        int a = tonePrint(NULL, (i + EMOJI_SYNTHESIZER_TONE_WIDTH) % EMOJI_SYNTHESIZER_TONE_WIDTH);
+        int b = tonePrint(NULL, (i + 1 + EMOJI_SYNTHESIZER_TONE_WIDTH) % EMOJI_SYNTHESIZER_TONE_WIDTH);
+
+        if (abs(a - b) > DISCONTINUITY)
+            found = true;
+
+        lo = a < lo ? a : lo;
+        hi = a > hi ? a : hi;
+    }
+
+    return found;
+}
+
+int main()
+{
+    static uint16_t out[TEST_SAMPLES];
+    int failures = 0;
+
+    printf("%-10s %10s %10s %14s\n", "tone", "max error", "tolerance", "discontinuity");
+
+    for (unsigned int w = 0; w < sizeof(waveforms) / sizeof(waveforms[0]); w++)
+    {
+        const Waveform &wf = waveforms[w];
+        TonePrint tone = { wf.tonePrint, NULL };
+        int maxError = 0;
+        int smoothed = 0;
+
+        for (unsigned int f = 0; f < sizeof(frequencies) / sizeof(frequencies[0]); f++)
+        {
+            for (unsigned int v = 0; v < sizeof(volumes) / sizeof(volumes[0]); v++)
+            {
+                // Scale exactly as SoundEmojiSynthesizer does.
+                float gain = (SAMPLE_RANGE * volumes[v]) / 1024.0f;
+                float offset = 512.0f - (512.0f * gain);
+
+                WavetableOscillator oscillator;
+                oscillator.load(tone);
+                oscillator.setFrequency(frequencies[f], SAMPLE_RATE);
+                oscillator.setLevel(gain, offset, 0);
+
+                // Render in blocks of varying size, as effect steps and buffer boundaries would.
+                for (int i = 0, n = 1; i < TEST_SAMPLES; i += n, n = n * 3 % 509 + 1)
+                    oscillator.renderBlock(&out[i], n + i > TEST_SAMPLES ? TEST_SAMPLES - i : n);
+
+                // Drive the reference from a phase accumulator with the same step as the oscillator.
+                float cycles = frequencies[f] / SAMPLE_RATE;
+                uint32_t step = (uint32_t) (int64_t) (cycles * 4294967296.0f);
+                uint32_t phase = 0;
+
+                for (int i = 0; i < TEST_SAMPLES; i++, phase += step)
+                {
+                    double x = phase / 4294967296.0 * EMOJI_SYNTHESIZER_TONE_WIDTH;
+                    double s;
+                    int lo, hi;
+
+                    if (wf.interpolated)
+                    {
+                        if (nearDiscontinuity(wf.tonePrint, x, EMOJI_SYNTHESIZER_TONE_WIDTH / EMOJI_SYNTHESIZER_WAVETABLE_SIZE, lo, hi))
+                        {
+                            int e = max(0, max((int) (lo * gain + offset) - (int) out[i], (int) out[i] - (int) (hi * gain + offset)));
+
+                            if (e > maxError)
+                                maxError = e;
+
+                            smoothed++;
+                            continue;
+                        }
+
+                        s = interpolate(wf.tonePrint, x);
+                    }
+                    else
+                    {
+                        s = wf.tonePrint(NULL, (int) x);
+                    }
+
+                    int expected = (int) (s * gain + offset);
+                    int e = abs((int) out[i] - expected);
+
+                    if (e > maxError)
+                        maxError = e;
+                }
+            }
+        }
+
+        bool pass = maxError <= MAX_ERROR;
+        printf("%-10s %10d %10d %14d %s\n", wf.name, maxError, MAX_ERROR, smoothed, pass ? "" : "FAIL");
+
+        if (!pass)
+            failures++;
+    }
+
+    printf("%d of %d TonePrints failed\n", failures, (int)(sizeof(waveforms) / sizeof(waveforms[0])));
+
+    return failures ? 1 : 0;
+}